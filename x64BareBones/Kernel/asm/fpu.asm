@@ -0,0 +1,156 @@
+GLOBAL fpu_set_ts
+GLOBAL fpu_clear_ts
+GLOBAL fpu_fninit
+GLOBAL fpu_xsave
+GLOBAL fpu_xrstor
+GLOBAL fpu_fxsave
+GLOBAL fpu_fxrstor
+GLOBAL cpu_read_cr4
+GLOBAL cpu_write_cr4
+GLOBAL cpu_xsetbv
+GLOBAL cpu_save_flags_cli
+GLOBAL cpu_restore_flags
+GLOBAL simd_fill32
+GLOBAL simd_copy
+
+SECTION .text
+
+; CR0.TS: con TS=1 la próxima instrucción x87/SSE/AVX genera #NM
+fpu_set_ts:
+	mov rax, cr0
+	or rax, 8
+	mov cr0, rax
+	ret
+
+fpu_clear_ts:
+	clts
+	ret
+
+; estado inicial: x87 por defecto y MXCSR con todas las excepciones enmascaradas
+fpu_fninit:
+	fninit
+	push qword 0x1F80
+	ldmxcsr [rsp]
+	add rsp, 8
+	ret
+
+; void fpu_xsave(void *area, uint64_t mask) - area alineada a 64
+fpu_xsave:
+	mov eax, esi
+	mov rdx, rsi
+	shr rdx, 32
+	xsave [rdi]
+	ret
+
+; void fpu_xrstor(const void *area, uint64_t mask)
+fpu_xrstor:
+	mov eax, esi
+	mov rdx, rsi
+	shr rdx, 32
+	xrstor [rdi]
+	ret
+
+; void fpu_fxsave(void *area) - area alineada a 16 (sin XSAVE)
+fpu_fxsave:
+	fxsave [rdi]
+	ret
+
+fpu_fxrstor:
+	fxrstor [rdi]
+	ret
+
+cpu_read_cr4:
+	mov rax, cr4
+	ret
+
+cpu_write_cr4:
+	mov cr4, rdi
+	ret
+
+; void cpu_xsetbv(uint32_t index, uint64_t value)
+cpu_xsetbv:
+	mov ecx, edi
+	mov eax, esi
+	mov rdx, rsi
+	shr rdx, 32
+	xsetbv
+	ret
+
+; uint64_t cpu_save_flags_cli(void) - devuelve RFLAGS y deshabilita interrupciones
+cpu_save_flags_cli:
+	pushfq
+	pop rax
+	cli
+	ret
+
+; void cpu_restore_flags(uint64_t flags) - restaura IF
+cpu_restore_flags:
+	push rdi
+	popfq
+	ret
+
+; ----------------------------------------------------------------------------
+; Rutinas SIMD del kernel: solo entre kernel_fpu_begin/kernel_fpu_end
+; ----------------------------------------------------------------------------
+
+; void simd_fill32(void *dst, uint32_t value, uint64_t count) - count en dwords
+simd_fill32:
+	movd xmm0, esi
+	pshufd xmm0, xmm0, 0
+.head:						; hasta alinear dst a 16
+	test rdi, 15
+	jz .body
+	test rdx, rdx
+	jz .done
+	mov [rdi], esi
+	add rdi, 4
+	dec rdx
+	jmp .head
+.body:
+	cmp rdx, 16
+	jb .tail
+	movdqa [rdi], xmm0
+	movdqa [rdi + 16], xmm0
+	movdqa [rdi + 32], xmm0
+	movdqa [rdi + 48], xmm0
+	add rdi, 64
+	sub rdx, 16
+	jmp .body
+.tail:
+	test rdx, rdx
+	jz .done
+	mov [rdi], esi
+	add rdi, 4
+	dec rdx
+	jmp .tail
+.done:
+	ret
+
+; void simd_copy(void *dst, const void *src, uint64_t len) - sin solapamiento
+simd_copy:
+.body:
+	cmp rdx, 64
+	jb .tail
+	movdqu xmm0, [rsi]
+	movdqu xmm1, [rsi + 16]
+	movdqu xmm2, [rsi + 32]
+	movdqu xmm3, [rsi + 48]
+	movdqu [rdi], xmm0
+	movdqu [rdi + 16], xmm1
+	movdqu [rdi + 32], xmm2
+	movdqu [rdi + 48], xmm3
+	add rsi, 64
+	add rdi, 64
+	sub rdx, 64
+	jmp .body
+.tail:
+	test rdx, rdx
+	jz .done
+	mov al, [rsi]
+	mov [rdi], al
+	inc rsi
+	inc rdi
+	dec rdx
+	jmp .tail
+.done:
+	ret
@@ -6,26 +6,47 @@ GLOBAL picSlaveMask
 GLOBAL haltcpu
 GLOBAL _hlt
 
+GLOBAL irqStubTable
 GLOBAL _irq00Handler
 GLOBAL _irq01Handler
-GLOBAL _irq02Handler
-GLOBAL _irq03Handler
-GLOBAL _irq04Handler
-GLOBAL _irq05Handler
 
 GLOBAL _int80Handler
+GLOBAL _spuriousHandler
+GLOBAL _profileTimerHandler
+GLOBAL _schedYieldHandler
+GLOBAL _yield
 
 GLOBAL _exception0Handler
 GLOBAL _exception6Handler
+GLOBAL _exception7Handler
+GLOBAL _exception14Handler
 
 EXTERN irqDispatcher
 EXTERN exceptionDispatcher
 EXTERN syscallDispatcher
 EXTERN getStackBase
+EXTERN run_deferred_work
+EXTERN apicEoiRegister
+EXTERN irq_stats_record
+EXTERN profiler_sample
+EXTERN fpu_handle_nm
+EXTERN lapicEoiAddress
+EXTERN paging_handle_fault
+EXTERN sched_preempt
+EXTERN sched_switch
+EXTERN sched_exception
+EXTERN sched_finish
 
 SECTION .text
 %define DELTA 120
 
+; Un stub por vector desde 0x20: 0x20-0x2F son las IRQ ISA (PIC o IOAPIC),
+; 0x30-0x3F quedan para fuentes que solo llegan por el APIC.
+%define IRQ_BASE_VECTOR 20h
+%define IRQ_APIC_VECTOR 30h
+%define IRQ_STUBS       32
+%define SCHED_YIELD_VECTOR 81h
+
 %macro pushState 0
 	push rax
 	push rbx
@@ -96,6 +117,20 @@ SECTION .text
     pop rbx
 %endmacro
 
+; rax = TSC (rdx queda pisado)
+%macro readTSC 0
+	rdtsc
+	shl rdx, 32
+	or rax, rdx
+%endmacro
+
+; irq_stats_record(vector, TSC de entrada que está en el tope de la pila)
+%macro recordStats 1
+	mov rdi, %1
+	pop rsi
+	call irq_stats_record
+%endmacro
+
 %macro saveSnapshot 0
     ; 1) RAX…RDX
     mov   rax, [rsp+112]        ; RAX
@@ -165,23 +200,73 @@ SECTION .text
 
 %macro irqHandlerMaster 1
 	pushState
-	saveSnapshot
+	; snapshot perezoso: solo se anota dónde quedó el frame (pushState + iretq);
+	; Ctrl+R lo copia desde ahí. Las excepciones siguen usando saveSnapshot.
+	; Los vectores del APIC pueden llegar en los APs: no pisan el del BSP.
+%if %1 < IRQ_APIC_VECTOR
+	mov [irqFrame], rsp
+%endif
+	readTSC
+	push rax
 
-	mov rdi, %1 ; pasaje de parametro
+	mov rdi, %1 ; vector
 	call irqDispatcher
 
-	; signal pic EOI (End of Interrupt)
+	; signal EOI (End of Interrupt): escritura MMIO al LAPIC si las IRQ
+	; vienen por el IOAPIC, sino out al PIC (bajo QEMU cada out es un VM exit)
+%if %1 >= IRQ_APIC_VECTOR
+	mov rax, [lapicEoiAddress]
+	mov dword [rax], 0
+%else
+	mov rax, [apicEoiRegister]
+	test rax, rax
+	jz %%picEOI
+	mov dword [rax], 0
+	jmp %%eoiDone
+%%picEOI:
 	mov al, 20h
+%if %1 >= IRQ_BASE_VECTOR + 8
+	out 0A0h, al			; IRQ del esclavo: EOI a los dos
+%endif
 	out 20h, al
-
+%%eoiDone:
+%endif
+
+	; bottom halves: fuera del handler, ya con el EOI enviado (los encolan
+	; las IRQ ISA, que atiende el BSP)
+%if %1 < IRQ_APIC_VECTOR
+	call run_deferred_work
+%endif
+
+	recordStats %1
+
+	; si se agotó el quantum (o se despertó alguien) se sigue con el frame
+	; de otra tarea: mismo formato, así que alcanza con cambiar RSP
+	mov rdi, rsp
+	call sched_preempt
+	cmp rax, rsp
+	je %%resume
+	mov rsp, rax
+	call sched_finish
+%%resume:
 	popState
 	iretq
 %endmacro
 
 %macro syscallHandler 0
     pushStateExceptRAX
+	readTSC
+	push rax
+	mov rdx, [rsp + 12*8]	; rdx (arg3) restaurado de pushStateExceptRAX
 
     call syscallDispatcher
+
+	push rax				; valor de retorno
+	mov rsi, [rsp + 8]
+	mov rdi, 80h
+	call irq_stats_record
+	pop rax
+	add rsp, 8
 	
     popStateExceptRAX
     iretq
@@ -191,13 +276,20 @@ SECTION .text
 %macro exceptionHandler 1
     pushState
 	saveSnapshot
+	readTSC
+	mov [exceptionEntryTSC], rax
     mov rdi, %1
     call exceptionDispatcher
+	call sched_exception	; en una tarea que no es main la termina (no vuelve)
     popState
 
     call getStackBase
     mov rsp, rax
 
+	mov rdi, %1
+	mov rsi, [exceptionEntryTSC]
+	call irq_stats_record
+
     pushfq
     pop rax
     or rax, 0x200         ; habilitar IF
@@ -240,33 +332,74 @@ picSlaveMask:
     retn
 
 
-;8254 Timer (Timer Tick)
-_irq00Handler:
-	irqHandlerMaster 0
-
-;Keyboard
-_irq01Handler:
-	irqHandlerMaster 1 ; macro que llama a irqDispatcher(1)
+;IRQs: _irq00Handler (timer), _irq01Handler (teclado), ... _irq31Handler.
+;Todos despachan por irqDispatcher según lo registrado con irq_register.
+%assign irq 0
+%rep IRQ_STUBS
+%if irq < 10
+_irq0%[irq]Handler:
+%else
+_irq%[irq]Handler:
+%endif
+	irqHandlerMaster IRQ_BASE_VECTOR + irq
+%assign irq irq + 1
+%endrep
 
-;Cascade pic never called
-_irq02Handler:
-	irqHandlerMaster 2
+;syscalls
+_int80Handler:
+    syscallHandler
 
-;Serial Port 2 and 4
-_irq03Handler:
-	irqHandlerMaster 3
+;LAPIC spurious interrupt: no lleva EOI
+_spuriousHandler:
+	pushState
+	readTSC
+	push rax
+	recordStats 0FFh
+	popState
+	iretq
 
-;Serial Port 1 and 3
-_irq04Handler:
-	irqHandlerMaster 4
+;Timer del LAPIC mientras corre el profiler (en cualquier CPU); también es
+;el tick del scheduler, así que puede salir en otra tarea
+_profileTimerHandler:
+	pushState
+	mov rdi, rsp			; interrupt_frame_t *
+	readTSC
+	push rax
+	call profiler_sample
+	mov rax, [lapicEoiAddress]
+	mov dword [rax], 0
+	recordStats 0F2h
+	mov rdi, rsp
+	call sched_preempt
+	cmp rax, rsp
+	je .resume
+	mov rsp, rax
+	call sched_finish
+.resume:
+	popState
+	iretq
 
-;USB
-_irq05Handler:
-	irqHandlerMaster 5
+;Cambio de tarea voluntario (yield/sleep/exit/esperas): arma el mismo frame
+;que una IRQ. Se mide el cambio entero: el TSC de entrada queda en rbx, que
+;sched_switch preserva y popState repone con el de la tarea nueva.
+_schedYieldHandler:
+	pushState
+	readTSC
+	mov rbx, rax
+	mov rdi, rsp
+	call sched_switch
+	mov rsp, rax
+	call sched_finish
+	mov rdi, SCHED_YIELD_VECTOR
+	mov rsi, rbx
+	call irq_stats_record
+	popState
+	iretq
 
-;syscalls
-_int80Handler:
-    syscallHandler
+; void _yield(void) - con IF=0: vuelve cuando el scheduler elige de nuevo a la tarea
+_yield:
+	int SCHED_YIELD_VECTOR
+	ret
 
 ;Zero Division Exception
 _exception0Handler:
@@ -276,12 +409,58 @@ _exception0Handler:
 _exception6Handler:
 	exceptionHandler 6
 
+;Page fault: primero las regiones de demanda en cero (paging.c); si no lo
+;resuelve se descarta el código de error, que exceptionHandler no espera
+_exception14Handler:
+	pushState
+	readTSC
+	push rax
+	mov rdi, [rsp + 16*8]	; código de error, arriba del estado y el TSC
+	call paging_handle_fault
+	test eax, eax
+	jz .fatal
+	recordStats 0Eh
+	popState
+	add rsp, 8
+	iretq
+.fatal:
+	add rsp, 8
+	popState
+	add rsp, 8
+	exceptionHandler 14
+
+;Device not available (#NM): restauración perezosa del estado FPU
+_exception7Handler:
+	pushState
+	readTSC
+	push rax
+	call fpu_handle_nm
+	recordStats 07h
+	popState
+	iretq
+
 haltcpu:
 	cli
 	hlt
 	ret
 
+SECTION .rodata
+;Direcciones de los stubs, para que load_idt los instale en un loop
+irqStubTable:
+%assign irq 0
+%rep IRQ_STUBS
+%if irq < 10
+	dq _irq0%[irq]Handler
+%else
+	dq _irq%[irq]Handler
+%endif
+%assign irq irq + 1
+%endrep
+
 SECTION .bss
 	aux resq 1
 	global snapshot
 	snapshot  resq 21
+	global irqFrame
+	irqFrame  resq 1
+	exceptionEntryTSC resq 1
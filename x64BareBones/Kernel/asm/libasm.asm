@@ -4,6 +4,14 @@ GLOBAL outb
 GLOBAL get_registers
 GLOBAL rdtsc
 GLOBAL cpuid_info
+GLOBAL cpuid_count
+GLOBAL mem_copy_words
+GLOBAL mem_copy_words_backward
+GLOBAL mem_copy_rep
+GLOBAL mem_copy_nt
+GLOBAL mem_fill_words
+GLOBAL mem_fill_rep
+GLOBAL mem_fill_nt
 EXTERN snapshot
 
 section .data
@@ -89,3 +97,256 @@ cpuid_info:
     pop r12
     pop rbx
     ret
+
+; void cpuid_count(uint32_t leaf, uint32_t subleaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx)
+; Igual que cpuid_info pero con subleaf en ecx (hojas 4, 0xB, 0x18...)
+cpuid_count:
+    push rbx
+
+    mov r10, rdx    ; puntero a eax
+    mov r11, rcx    ; puntero a ebx
+    mov eax, edi
+    mov ecx, esi
+    cpuid
+
+    mov [r10], eax
+    mov [r11], ebx
+    mov [r8], ecx
+    mov [r9], edx
+
+    pop rbx
+    ret
+
+; ----------------------------------------------------------------------------
+; Loops de memcpy/memset (lib.c elige cuál usar). Los de 8 bytes alinean el
+; destino con bytes sueltos al principio y terminan con la cola de a byte.
+; ----------------------------------------------------------------------------
+
+; void mem_copy_words(void *dst, const void *src, uint64_t length)
+mem_copy_words:
+.head:
+	test rdi, 7
+	jz .body32
+	test rdx, rdx
+	jz .done
+	mov al, [rsi]
+	mov [rdi], al
+	inc rsi
+	inc rdi
+	dec rdx
+	jmp .head
+.body32:
+	cmp rdx, 32
+	jb .body8
+	mov rax, [rsi]
+	mov rcx, [rsi + 8]
+	mov r8, [rsi + 16]
+	mov r9, [rsi + 24]
+	mov [rdi], rax
+	mov [rdi + 8], rcx
+	mov [rdi + 16], r8
+	mov [rdi + 24], r9
+	add rsi, 32
+	add rdi, 32
+	sub rdx, 32
+	jmp .body32
+.body8:
+	cmp rdx, 8
+	jb .tail
+	mov rax, [rsi]
+	mov [rdi], rax
+	add rsi, 8
+	add rdi, 8
+	sub rdx, 8
+	jmp .body8
+.tail:
+	test rdx, rdx
+	jz .done
+	mov al, [rsi]
+	mov [rdi], al
+	inc rsi
+	inc rdi
+	dec rdx
+	jmp .tail
+.done:
+	ret
+
+; void mem_copy_words_backward(void *dst, const void *src, uint64_t length)
+; desde el final, para memmove con dst > src solapados
+mem_copy_words_backward:
+	add rsi, rdx
+	add rdi, rdx
+.tail:
+	test rdi, 7
+	jz .body8
+	test rdx, rdx
+	jz .done
+	dec rsi
+	dec rdi
+	mov al, [rsi]
+	mov [rdi], al
+	dec rdx
+	jmp .tail
+.body8:
+	cmp rdx, 8
+	jb .head
+	sub rsi, 8
+	sub rdi, 8
+	mov rax, [rsi]
+	mov [rdi], rax
+	sub rdx, 8
+	jmp .body8
+.head:
+	test rdx, rdx
+	jz .done
+	dec rsi
+	dec rdi
+	mov al, [rsi]
+	mov [rdi], al
+	dec rdx
+	jmp .head
+.done:
+	ret
+
+; void mem_copy_rep(void *dst, const void *src, uint64_t length)
+mem_copy_rep:
+	mov rcx, rdx
+	rep movsb
+	ret
+
+; void mem_copy_nt(void *dst, const void *src, uint64_t length)
+; movnti no pasa por la cache; el sfence final ordena los stores
+mem_copy_nt:
+.head:
+	test rdi, 7
+	jz .body32
+	test rdx, rdx
+	jz .done
+	mov al, [rsi]
+	mov [rdi], al
+	inc rsi
+	inc rdi
+	dec rdx
+	jmp .head
+.body32:
+	cmp rdx, 32
+	jb .body8
+	mov rax, [rsi]
+	mov rcx, [rsi + 8]
+	mov r8, [rsi + 16]
+	mov r9, [rsi + 24]
+	movnti [rdi], rax
+	movnti [rdi + 8], rcx
+	movnti [rdi + 16], r8
+	movnti [rdi + 24], r9
+	add rsi, 32
+	add rdi, 32
+	sub rdx, 32
+	jmp .body32
+.body8:
+	cmp rdx, 8
+	jb .fence
+	mov rax, [rsi]
+	movnti [rdi], rax
+	add rsi, 8
+	add rdi, 8
+	sub rdx, 8
+	jmp .body8
+.fence:
+	sfence
+.tail:
+	test rdx, rdx
+	jz .done
+	mov al, [rsi]
+	mov [rdi], al
+	inc rsi
+	inc rdi
+	dec rdx
+	jmp .tail
+.done:
+	ret
+
+; void mem_fill_words(void *dst, uint64_t pattern, uint64_t length)
+mem_fill_words:
+.head:
+	test rdi, 7
+	jz .body32
+	test rdx, rdx
+	jz .done
+	mov [rdi], sil
+	inc rdi
+	dec rdx
+	jmp .head
+.body32:
+	cmp rdx, 32
+	jb .body8
+	mov [rdi], rsi
+	mov [rdi + 8], rsi
+	mov [rdi + 16], rsi
+	mov [rdi + 24], rsi
+	add rdi, 32
+	sub rdx, 32
+	jmp .body32
+.body8:
+	cmp rdx, 8
+	jb .tail
+	mov [rdi], rsi
+	add rdi, 8
+	sub rdx, 8
+	jmp .body8
+.tail:
+	test rdx, rdx
+	jz .done
+	mov [rdi], sil
+	inc rdi
+	dec rdx
+	jmp .tail
+.done:
+	ret
+
+; void mem_fill_rep(void *dst, uint64_t pattern, uint64_t length)
+mem_fill_rep:
+	mov rax, rsi
+	mov rcx, rdx
+	rep stosb
+	ret
+
+; void mem_fill_nt(void *dst, uint64_t pattern, uint64_t length)
+mem_fill_nt:
+.head:
+	test rdi, 7
+	jz .body32
+	test rdx, rdx
+	jz .done
+	mov [rdi], sil
+	inc rdi
+	dec rdx
+	jmp .head
+.body32:
+	cmp rdx, 32
+	jb .body8
+	movnti [rdi], rsi
+	movnti [rdi + 8], rsi
+	movnti [rdi + 16], rsi
+	movnti [rdi + 24], rsi
+	add rdi, 32
+	sub rdx, 32
+	jmp .body32
+.body8:
+	cmp rdx, 8
+	jb .fence
+	movnti [rdi], rsi
+	add rdi, 8
+	sub rdx, 8
+	jmp .body8
+.fence:
+	sfence
+.tail:
+	test rdx, rdx
+	jz .done
+	mov [rdi], sil
+	inc rdi
+	dec rdx
+	jmp .tail
+.done:
+	ret
@@ -0,0 +1,49 @@
+GLOBAL cpu_read_cr2
+GLOBAL cpu_read_cr3
+GLOBAL cpu_write_cr3
+GLOBAL cpu_rdmsr
+GLOBAL cpu_wrmsr
+GLOBAL cpu_wbinvd
+GLOBAL cpu_invlpg
+
+SECTION .text
+
+; dirección que causó el último #PF
+cpu_read_cr2:
+	mov rax, cr2
+	ret
+
+cpu_read_cr3:
+	mov rax, cr3
+	ret
+
+; cargar CR3 invalida toda la TLB (las entradas no son globales)
+cpu_write_cr3:
+	mov cr3, rdi
+	ret
+
+; uint64_t cpu_rdmsr(uint32_t msr)
+cpu_rdmsr:
+	mov ecx, edi
+	rdmsr
+	shl rdx, 32
+	or rax, rdx
+	ret
+
+; void cpu_wrmsr(uint32_t msr, uint64_t value)
+cpu_wrmsr:
+	mov ecx, edi
+	mov eax, esi
+	mov rdx, rsi
+	shr rdx, 32
+	wrmsr
+	ret
+
+cpu_wbinvd:
+	wbinvd
+	ret
+
+; void cpu_invlpg(uint64_t addr) - solo la TLB de este CPU
+cpu_invlpg:
+	invlpg [rdi]
+	ret
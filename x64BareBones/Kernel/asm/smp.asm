@@ -0,0 +1,161 @@
+GLOBAL _apStartHandler
+GLOBAL _apWakeHandler
+GLOBAL _smpCallHandler
+GLOBAL cpu_load_gdt
+GLOBAL cpu_switch_stack
+GLOBAL cpu_load_idt
+GLOBAL cpu_set_gs_base
+GLOBAL this_cpu
+GLOBAL cpu_pause
+
+EXTERN ap_main
+EXTERN lapicEoiAddress
+EXTERN irq_stats_record
+EXTERN smp_handle_calls
+EXTERN sched_preempt
+EXTERN sched_finish
+
+SECTION .text
+
+; Primera IPI a un AP dormido en ap_sleep de Pure64. Entra con la pila de 1KB
+; que le dio Pure64; ap_main cambia a la pila propia y no vuelve (el frame
+; de la interrupción se abandona).
+_apStartHandler:
+	cli
+	and rsp, -16
+	call ap_main
+.hang:
+	hlt
+	jmp .hang
+
+; IPI de despertar: saca al CPU del hlt del idle loop, o le avisa que quedó
+; lista una tarea que le gana a la que corre (sched.c). Arma el mismo frame
+; que pushState en interrupts.asm para poder salir en otra tarea.
+; _apStartHandler no se cuenta: nunca llega a su iretq.
+_apWakeHandler:
+	push rax
+	push rbx
+	push rcx
+	push rdx
+	push rbp
+	push rdi
+	push rsi
+	push r8
+	push r9
+	push r10
+	push r11
+	push r12
+	push r13
+	push r14
+	push r15
+	rdtsc
+	shl rdx, 32
+	or rax, rdx
+	mov rsi, rax
+	mov rax, [lapicEoiAddress]
+	mov dword [rax], 0
+	mov rdi, 0xF1
+	call irq_stats_record
+	mov rdi, rsp
+	call sched_preempt
+	cmp rax, rsp
+	je .resume
+	mov rsp, rax
+	call sched_finish
+.resume:
+	pop r15
+	pop r14
+	pop r13
+	pop r12
+	pop r11
+	pop r10
+	pop r9
+	pop r8
+	pop rsi
+	pop rdi
+	pop rbp
+	pop rdx
+	pop rcx
+	pop rbx
+	pop rax
+	iretq
+
+;IPI de smp_call_function: corre las llamadas del mailbox de este CPU
+_smpCallHandler:
+	push rax
+	push rcx
+	push rdx
+	push rsi
+	push rdi
+	push r8
+	push r9
+	push r10
+	push r11
+	rdtsc
+	shl rdx, 32
+	or rax, rdx
+	push rax				; TSC de entrada
+	sub rsp, 8				; alineación para las llamadas
+	call smp_handle_calls
+	mov rax, [lapicEoiAddress]
+	mov dword [rax], 0
+	add rsp, 8
+	pop rsi
+	mov rdi, 0xF3
+	call irq_stats_record
+	pop r11
+	pop r10
+	pop r9
+	pop r8
+	pop rdi
+	pop rsi
+	pop rdx
+	pop rcx
+	pop rax
+	iretq
+
+; void cpu_load_gdt(const void *gdtr)
+; carga la GDT y recarga los selectores (CS con un far return)
+cpu_load_gdt:
+	lgdt [rdi]
+	mov ax, 0x10
+	mov ds, ax
+	mov es, ax
+	mov ss, ax
+	pop rax					; dirección de retorno
+	push qword 0x08
+	push rax
+	retfq
+
+; void cpu_load_idt(const void *idtr)
+cpu_load_idt:
+	lidt [rdi]
+	ret
+
+; void cpu_set_gs_base(uint64_t base) - IA32_GS_BASE
+cpu_set_gs_base:
+	mov ecx, 0xC0000101
+	mov eax, edi
+	mov rdx, rdi
+	shr rdx, 32
+	wrmsr
+	ret
+
+; cpu_t *this_cpu(void) - el bloque per-CPU guarda su propia dirección en gs:0
+this_cpu:
+	mov rax, [gs:0]
+	ret
+
+cpu_pause:
+	pause
+	ret
+
+; void cpu_switch_stack(uint64_t stack_top, void (*fn)(void)) - no vuelve
+cpu_switch_stack:
+	mov rsp, rdi
+	xor rbp, rbp
+	call rsi
+.hang:
+	cli
+	hlt
+	jmp .hang
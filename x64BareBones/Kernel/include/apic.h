@@ -0,0 +1,77 @@
+#ifndef APIC_H
+#define APIC_H
+
+#include <stdint.h>
+
+// Enrutamiento de interrupciones: 8259 (PIC) o IOAPIC + LAPIC.
+// Las direcciones las deja Pure64 en sus variables de sistema.
+
+#define IRQ_MODE_PIC   0
+#define IRQ_MODE_APIC  1
+#define IRQ_MODE_QUERY (-1)
+
+#define APIC_SPURIOUS_VECTOR 0xFF
+
+// Registros del LAPIC (offsets MMIO)
+#define LAPIC_ID        0x020
+#define LAPIC_TPR       0x080
+#define LAPIC_EOI       0x0B0
+#define LAPIC_SVR       0x0F0
+#define LAPIC_ICR_LOW   0x300
+#define LAPIC_ICR_HIGH  0x310
+#define LAPIC_LVT_TIMER 0x320
+#define LAPIC_TIMER_INIT  0x380
+#define LAPIC_TIMER_COUNT 0x390
+#define LAPIC_TIMER_DIV   0x3E0
+
+/**
+ * @brief Lee las direcciones del LAPIC/IOAPIC y los overrides de la MADT
+ * Debe llamarse una vez despues de load_idt
+ */
+void apic_init(void);
+
+/**
+ * @brief Indica si hay LAPIC e IOAPIC utilizables
+ */
+int apic_available(void);
+
+/**
+ * @brief Cambia el controlador que entrega IRQ0/IRQ1
+ * @param mode IRQ_MODE_PIC, IRQ_MODE_APIC o IRQ_MODE_QUERY
+ * @return Modo activo despues del cambio, -1 si el modo no esta disponible
+ */
+int irq_set_mode(int mode);
+
+/**
+ * @brief Desenmascara una línea ISA (0-15) en el controlador activo
+ * Lo llama irq_register; el cambio de modo respeta las líneas habilitadas
+ */
+void irq_enable_line(uint8_t irq);
+
+uint32_t lapic_read(uint32_t reg);
+void lapic_write(uint32_t reg, uint32_t value);
+uint8_t lapic_id(void);
+
+/**
+ * @brief Envia una IPI fija (vector) a un LAPIC y espera que se entregue
+ */
+void lapic_send_ipi(uint8_t apic_id, uint8_t vector);
+
+/**
+ * @brief Arranca el timer del LAPIC del CPU actual en modo periódico
+ * La primera llamada calibra el timer contra el TSC (requiere calibrate_tsc)
+ * @param vector Vector que dispara en cada tick
+ * @param hz Frecuencia deseada
+ */
+void lapic_timer_start(uint8_t vector, uint32_t hz);
+
+/**
+ * @brief Detiene el timer del LAPIC del CPU actual
+ */
+void lapic_timer_stop(void);
+
+// Registro de EOI del LAPIC propio (misma dirección en todas las CPUs);
+// a diferencia de apicEoiRegister, siempre está cargado si hay LAPIC.
+extern volatile uint32_t *lapicEoiAddress;
+
+#endif
@@ -23,6 +23,11 @@ uint64_t rdtsc(void);
  */
 void cpuid_info(uint32_t leaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx);
 
+/**
+ * @brief CPUID con subleaf (ECX) para las hojas que lo usan
+ */
+void cpuid_count(uint32_t leaf, uint32_t subleaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx);
+
 /**
  * @brief Calibra el TSC usando el PIT (Programmable Interval Timer)
  * Debe llamarse una vez al inicio del sistema para calcular la frecuencia del TSC
@@ -35,6 +40,13 @@ void calibrate_tsc(void);
  */
 uint64_t get_tsc_frequency(void);
 
+/**
+ * @brief TSC del CPU actual corregido al reloj del BSP
+ * Resta el offset medido por tsc_sync_init, así las lecturas hechas en
+ * distintos cores son comparables (antes de medirlo el offset es 0)
+ */
+uint64_t tsc_now(void);
+
 /**
  * @brief Convierte ciclos de TSC a milisegundos
  * @param cycles Número de ciclos TSC
@@ -61,7 +73,7 @@ uint64_t ms_to_cycles(uint64_t ms);
  * @return Valor del TSC al inicio
  */
 static inline uint64_t bench_start(void) {
-    return rdtsc();
+    return tsc_now();
 }
 
 /**
@@ -70,7 +82,7 @@ static inline uint64_t bench_start(void) {
  * @return Número de ciclos transcurridos
  */
 static inline uint64_t bench_stop(uint64_t start) {
-    uint64_t end = rdtsc();
+    uint64_t end = tsc_now();
     return end - start;
 }
 
@@ -0,0 +1,21 @@
+#ifndef DEFERRED_H
+#define DEFERRED_H
+
+#include <stdint.h>
+
+// Trabajo diferido (bottom half): los handlers de IRQ solo capturan estado
+// y encolan; el trabajo corre al salir de la interrupción, después del EOI
+// y con interrupciones habilitadas.
+
+typedef void (*deferred_fn)(uint64_t arg);
+
+#define DEFERRED_QUEUE_SIZE 16
+
+// Encola desde contexto de IRQ (IF=0). Devuelve 0 si la cola está llena.
+int defer_work(deferred_fn fn, uint64_t arg);
+
+// Llamado por irqHandlerMaster después del EOI. No reentrante: si una IRQ
+// anidada llega mientras corre un trabajo, su cola se vacía en este mismo loop.
+void run_deferred_work(void);
+
+#endif
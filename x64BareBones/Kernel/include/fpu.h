@@ -0,0 +1,74 @@
+#ifndef FPU_H
+#define FPU_H
+
+#include <stdint.h>
+
+// Manejo explícito del estado x87/SSE/AVX. El estado de userland se guarda
+// de forma perezosa: en un cambio de contexto (o cuando el kernel usa SIMD)
+// se prende CR0.TS y recién la primera instrucción FP siguiente genera #NM,
+// donde se guarda el estado del dueño anterior y se restaura el del actual.
+
+#define FPU_AREA_SIZE 1024      // x87 + SSE + AVX (XSAVE) o FXSAVE
+
+#define FPU_FEATURE_XSAVE 0x1
+#define FPU_FEATURE_AVX   0x2
+
+typedef struct {
+    uint8_t area[FPU_AREA_SIZE] __attribute__((aligned(64)));
+    uint8_t initialized;        // 0 = arranca con el estado inicial
+} fpu_context_t;
+
+/**
+ * @brief Configura FPU/SSE del CPU actual: CR4.OSXSAVE y XCR0 (x87|SSE|AVX)
+ * si están disponibles. Una vez por CPU, con el bloque per-CPU ya cargado.
+ */
+void fpu_init(void);
+
+/**
+ * @brief Cambio de contexto: next pasa a ser el estado del CPU actual
+ * No copia nada; la restauración ocurre en el próximo #NM
+ */
+void fpu_switch(fpu_context_t *next);
+
+/**
+ * @brief Contexto que corre en el CPU actual (el scheduler lo adopta para main)
+ */
+fpu_context_t *fpu_current(void);
+
+/**
+ * @brief Si ctx está cargado en este CPU lo guarda y lo suelta, para que
+ * pueda seguir en otro CPU (vuelve por #NM en el que sea)
+ */
+void fpu_release(fpu_context_t *ctx);
+
+/**
+ * @brief Handler de #NM (vector 7), llamado desde interrupts.asm
+ */
+void fpu_handle_nm(void);
+
+/**
+ * @brief Indica si el CPU actual puede entrar en kernel_fpu_begin
+ */
+int kernel_fpu_usable(void);
+
+/**
+ * @brief Habilita el uso de SIMD en el kernel (deshabilita interrupciones)
+ * Guarda el estado de userland si estaba cargado; no es anidable
+ */
+void kernel_fpu_begin(void);
+
+/**
+ * @brief Fin de la sección SIMD; el estado de userland vuelve en el próximo #NM
+ */
+void kernel_fpu_end(void);
+
+/**
+ * @brief FPU_FEATURE_* habilitadas en el CPU actual
+ */
+int fpu_features(void);
+
+// Rutinas SIMD (asm/fpu.asm); solo entre kernel_fpu_begin y kernel_fpu_end
+void simd_fill32(void *dst, uint32_t value, uint64_t count);
+void simd_copy(void *dst, const void *src, uint64_t len);
+
+#endif
@@ -12,15 +12,20 @@
 
 void _irq00Handler(void);
 void _irq01Handler(void);
-void _irq02Handler(void);
-void _irq03Handler(void);
-void _irq04Handler(void);
-void _irq05Handler(void);
 
 void _int80Handler();
+void _spuriousHandler(void);
+void _profileTimerHandler(void);
+void _schedYieldHandler(void);
+
+void _apStartHandler(void);
+void _apWakeHandler(void);
+void _smpCallHandler(void);
 
 void _exception0Handler(void);
 void _exception6Handler(void);
+void _exception7Handler(void);
+void _exception14Handler(void);
 
 void _cli(void);
 
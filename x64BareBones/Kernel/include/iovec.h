@@ -0,0 +1,11 @@
+#ifndef IOVEC_H
+#define IOVEC_H
+#include <stdint.h>
+
+// Segmento (puntero, longitud) para escrituras vectorizadas
+typedef struct {
+    const char *base;
+    uint64_t len;
+} iovec_t;
+
+#endif
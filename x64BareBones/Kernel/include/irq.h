@@ -0,0 +1,41 @@
+#ifndef IRQ_H
+#define IRQ_H
+
+#include <stdint.h>
+
+// Registro genérico de handlers de IRQ. Cada vector tiene una cadena de
+// callbacks (líneas compartidas); irqDispatcher indexa directo por vector.
+// Los nodos salen de un pool estático: no hay allocator todavía.
+
+#define IRQ_BASE_VECTOR 0x20    // IRQ ISA 0 (PIC o IOAPIC)
+#define IRQ_ISA_LINES   16      // 0x20-0x2F
+#define IRQ_APIC_VECTOR 0x30    // 0x30-0x3F: fuentes que solo llegan por el APIC
+#define IRQ_STUBS       32      // stubs generados en interrupts.asm
+#define IRQ_NODE_POOL   64
+
+#define IRQ_VECTOR(irq) (IRQ_BASE_VECTOR + (irq))
+
+typedef void (*irq_handler_t)(void *ctx);
+
+// Direcciones de _irq00Handler.._irq31Handler (interrupts.asm)
+extern const uint64_t irqStubTable[IRQ_STUBS];
+
+/**
+ * @brief Agrega fn(ctx) al final de la cadena del vector
+ * Si es una línea ISA, además la desenmascara en el controlador activo
+ * @return 1 si se registró, 0 si el vector no tiene stub o el pool se agotó
+ */
+int irq_register(uint8_t vector, irq_handler_t fn, void *ctx);
+
+/**
+ * @brief Quita el handler (fn, ctx) de la cadena del vector
+ * @return 1 si estaba registrado
+ */
+int irq_unregister(uint8_t vector, irq_handler_t fn, void *ctx);
+
+/**
+ * @brief Llamado por los stubs con el vector que disparó
+ */
+void irqDispatcher(uint64_t vector);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef IRQSTATS_H
+#define IRQSTATS_H
+
+#include <stdint.h>
+
+// Contadores por vector de la IDT: cantidad, TSC de la última entrada e
+// histograma log2 de la duración entrada -> iretq (incluye el EOI y los
+// bottom halves). Los stubs de interrupts.asm/smp.asm leen el TSC al entrar
+// y llaman a irq_stats_record justo antes del iretq.
+
+#define IRQSTAT_BUCKETS 32      // bucket k: [2^k, 2^(k+1)) ciclos; el último acumula el resto
+
+typedef struct {
+    uint32_t vector;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t last_tsc;
+    uint64_t total_cycles;
+    uint64_t max_cycles;
+    uint32_t hist[IRQSTAT_BUCKETS];
+} irq_stat_t;
+
+/**
+ * @brief Registra una entrada al vector (llamado desde ASM, también en APs)
+ * @param entry_tsc TSC leído al entrar al stub
+ */
+void irq_stats_record(uint64_t vector, uint64_t entry_tsc);
+
+/**
+ * @brief Copia los vectores que se dispararon al menos una vez
+ * @return Cantidad de entradas escritas
+ */
+int irq_stats_get(irq_stat_t *out, int max);
+
+#endif
@@ -4,7 +4,71 @@
 #include <stdint.h>
 
 
-void keyboard_handler();     // se llama por interrupcion
+void keyboard_handler(void *ctx);     // se llama por interrupcion
 char keyboard_getchar();     // pop del buffer
 
+// Ring de caracteres compartida con userland (una página propia).
+// head/tail son contadores libres: ocupados = tail - head, índice = x & (SIZE-1).
+#define KBD_RING_SIZE 256            // potencia de 2
+
+typedef struct {
+    uint32_t tail;                   // lo escribe solo el IRQ (release)
+    uint32_t pad0[15];               // head y tail en líneas de cache distintas
+    uint32_t head;                   // lo avanzan los consumidores (CAS)
+    uint32_t pad1[15];
+    uint64_t overflows;              // veces que la ring se llenó
+    uint64_t dropped;                // teclas descartadas por ring llena
+    uint64_t pad2[6];
+    char data[KBD_RING_SIZE];
+} kbd_ring_t;
+
+kbd_ring_t * keyboard_get_ring();    // dirección de la página para userland
+
+#define KBD_WAIT_FOREVER (-1)
+
+// Duerme la CPU (hlt), o bloquea la tarea si hay scheduler, hasta que haya
+// una tecla o venza timeout_ms.
+// timeout_ms == 0 no bloquea, KBD_WAIT_FOREVER espera indefinidamente.
+// Devuelve 1 si hay teclas disponibles, 0 si vencio el timeout.
+// Deja las interrupciones deshabilitadas al volver.
+int keyboard_wait(int64_t timeout_ms);
+uint64_t keyboard_last_key_tsc();    // TSC del último push (para medir latencia)
+
+// Crea la tarea que dibuja Ctrl+R (registros) y Ctrl+L (limpiar) fuera del
+// IRQ1, fija en el BSP. Requiere sched_init(). Devuelve su id o -1.
+int keyboard_start_view_task();
+
+// Keycodes: 0x01-0x58 son los make codes del set 1; los extendidos (0xE0 xx)
+// se mapean al rango libre 0x60-0x7F para que todo entre en 128 bits
+#define KEY_KP_ENTER 0x60
+#define KEY_RCTRL    0x61
+#define KEY_KP_SLASH 0x62
+#define KEY_RALT     0x63
+#define KEY_HOME     0x64
+#define KEY_UP       0x65
+#define KEY_PGUP     0x66
+#define KEY_LEFT     0x67
+#define KEY_RIGHT    0x68
+#define KEY_END      0x69
+#define KEY_DOWN     0x6A
+#define KEY_PGDN     0x6B
+#define KEY_INSERT   0x6C
+#define KEY_DELETE   0x6D
+#define KEY_LGUI     0x6E
+#define KEY_RGUI     0x6F
+#define KEY_MENU     0x70
+
+#define EVENT_BUFFER_SIZE 128
+
+typedef struct {
+    uint8_t keycode;
+    uint8_t pressed;     // 1 = make, 0 = break
+    uint16_t reserved;
+    uint32_t reserved2;
+    uint64_t tsc;        // TSC en el IRQ
+} key_event_t;
+
+int keyboard_get_events(key_event_t *buffer, int max);  // pop de hasta max eventos
+void keyboard_get_state(uint64_t *state);               // bitmap de 128 bits (2 x uint64_t)
+
 #endif
@@ -3,9 +3,71 @@
 
 #include <stdint.h>
 
+// memcpy/memset eligen la rutina en cada llamada según el tamaño y lo que
+// reporta CPUID: stores non-temporal para bloques que no entran en cache,
+// rep movsb/stosb con ERMS (o FSRM para copias cortas), SSE/AVX si la FPU
+// está libre y si no un loop de 8 bytes con el destino alineado.
+
+#define MEM_FEATURE_ERMS 0x1            // CPUID 7 EBX.ERMS: rep movsb/stosb rápidos
+#define MEM_FEATURE_FSRM 0x2            // CPUID 7 EDX.FSRM: rep movsb rápido en copias cortas
+
+#define MEM_NT_MIN_BYTES (4ULL << 20)   // desde acá el destino no entra en cache
+
+// Rutinas medidas por mem_benchmark
+#define MEM_IMPL_AUTO    0              // memcpy / memset
+#define MEM_IMPL_BYTES   1              // loop de a un byte en C (lo que había antes)
+#define MEM_IMPL_WORDS   2
+#define MEM_IMPL_REP     3
+#define MEM_IMPL_SIMD    4
+#define MEM_IMPL_NT      5
+#define MEM_IMPLS        6
+
+#define MEM_BENCH_SIZES   12            // 16 B a 64 MiB, de a x4
+#define MEM_BENCH_TRAFFIC (16ULL << 20) // bytes por medición (repeticiones = esto / tamaño)
+
+typedef struct {
+    uint64_t size;
+    uint64_t reps;
+    uint64_t copy[MEM_IMPLS];           // ciclos de reps copias (0 = no disponible)
+    uint64_t fill[MEM_IMPLS];           // ciclos de reps memsets
+} mem_bench_row_t;
+
+typedef struct {
+    uint32_t features;                  // MEM_FEATURE_*
+    uint32_t count;
+    uint64_t nt_threshold;
+    mem_bench_row_t rows[MEM_BENCH_SIZES];
+} mem_bench_t;
+
 void * memset(void * destination, int32_t character, uint64_t length);
 void * memcpy(void * destination, const void * source, uint64_t length);
 
+/**
+ * @brief Copia con solapamiento: hacia adelante si destination < source, si no desde el final
+ */
+void * memmove(void * destination, const void * source, uint64_t length);
+
+/**
+ * @brief MEM_FEATURE_* del CPU (se lee CPUID en la primera llamada)
+ */
+int mem_features(void);
+
+/**
+ * @brief Mide cada rutina de copia y relleno con tamaños de 16 B a 64 MiB
+ * Copia de la primera mitad de buf a la segunda, así que el tamaño máximo
+ * queda en bytes / 2
+ */
+void mem_benchmark(mem_bench_t *out, void *buf, uint64_t bytes);
+
 char *cpuVendor(char *result);
 
-#endif
\ No newline at end of file
+// Loops de copia y relleno (asm/libasm.asm); fill recibe el byte repetido en los 8
+void mem_copy_words(void *dst, const void *src, uint64_t length);
+void mem_copy_words_backward(void *dst, const void *src, uint64_t length);
+void mem_copy_rep(void *dst, const void *src, uint64_t length);
+void mem_copy_nt(void *dst, const void *src, uint64_t length);
+void mem_fill_words(void *dst, uint64_t pattern, uint64_t length);
+void mem_fill_rep(void *dst, uint64_t pattern, uint64_t length);
+void mem_fill_nt(void *dst, uint64_t pattern, uint64_t length);
+
+#endif
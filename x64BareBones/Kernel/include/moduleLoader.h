@@ -1,6 +1,7 @@
 #ifndef MODULELOADER_H
 #define MODULELOADER_H
 
-void loadModules(void * payloadStart, void ** moduleTargetAddress);
+// Devuelve el fin del último módulo copiado
+void * loadModules(void * payloadStart, void ** moduleTargetAddress);
 
 #endif
\ No newline at end of file
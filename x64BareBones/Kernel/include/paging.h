@@ -0,0 +1,152 @@
+#ifndef PAGING_H
+#define PAGING_H
+
+#include <stdint.h>
+
+// Tablas de páginas propias del kernel (reemplazan las de Pure64, que mapea
+// todo con páginas de 2 MiB write-through). El mapeo sigue siendo 1:1 sobre
+// los primeros 4 GiB, pero con la página más grande que admite cada zona:
+// 1 GiB si el CPU tiene PDPE1GB y el GiB es uniforme (todo RAM o nada de RAM),
+// 2 MiB donde hacen falta atributos distintos (framebuffer WC, MMIO UC,
+// páginas guarda) y 4 KiB para los primeros 2 MiB, donde los MTRR fijos
+// mezclan tipos de memoria. Las tablas salen del buddy (page_alloc).
+//
+// Regiones de demanda en cero: arrancan sin mapear y el #PF pone en cero cada
+// unidad (4 KiB o 2 MiB) la primera vez que se toca, a través de una ventana
+// propia de cada CPU arriba de los 4 GiB, y recién ahí la mapea. Así lo que
+// nunca se usa (buffers del profiler, heap de userland, .bss de userland) no
+// se paga ni al arrancar ni al crecer.
+
+#define PAGING_LIMIT       0x100000000ULL
+#define PAGE_SIZE_2M       (1ULL << 21)
+#define PAGE_SIZE_1G       (1ULL << 30)
+
+#define PAGING_MAX_GUARDS  4
+#define PAGING_MAX_RUNS    24
+#define PAGING_MAX_LAZY    4
+#define PAGING_LAZY_UNITS  4096         // unidades por región (bitmap estático)
+#define PAGING_LAZY_NAME   16
+
+// Tamaños de página, índice de pages[] y de las tablas de TLB
+#define PAGE_KIND_4K       0
+#define PAGE_KIND_2M       1
+#define PAGE_KIND_1G       2
+#define PAGE_KINDS         3
+
+// Tipo de memoria de un tramo (PAT: WB=0, WC=4, UC=3)
+#define PAGE_CACHE_WB      0
+#define PAGE_CACHE_WC      1
+#define PAGE_CACHE_UC      2
+#define PAGE_CACHE_GUARD   3            // no presente: tocarlo es un #PF
+
+// Modos de mapeo, para comparar el efecto del tamaño de página
+#define PAGING_MODE_QUERY   -1
+#define PAGING_MODE_DEFAULT  0          // 1 GiB donde se pueda
+#define PAGING_MODE_2M       1          // sin páginas de 1 GiB (como Pure64, pero WB)
+#define PAGING_MODE_4K_HEAP  2          // 2 MiB y el heap de userland con 4 KiB
+
+#define PAGING_FEATURE_1G   0x1         // CPUID 0x80000001 EDX.PDPE1GB
+#define PAGING_FEATURE_PAT  0x2         // CPUID 1 EDX.PAT (framebuffer WC)
+
+// Tramo contiguo con el mismo tamaño de página y tipo de memoria
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint32_t kind;                      // PAGE_KIND_*
+    uint32_t cache;                     // PAGE_CACHE_*
+} page_run_t;
+
+// Región de demanda en cero
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint64_t unit;                      // 4 KiB o 2 MiB
+    uint64_t touched;                   // unidades ya puestas en cero
+    uint64_t faults;                    // #PF resueltos en la región
+    char name[PAGING_LAZY_NAME];
+} lazy_region_info_t;
+
+typedef struct {
+    uint32_t features;
+    int32_t mode;
+    uint32_t table_pages;               // páginas de 4 KiB usadas en tablas
+    uint32_t tlb_estimated;             // 1 = CPUID no informa la TLB, valores típicos
+    uint64_t pages[PAGE_KINDS];         // entradas hoja por tamaño
+    uint32_t l1_dtlb[PAGE_KINDS];       // entradas de la dTLB de primer nivel
+    uint32_t l2_tlb[PAGE_KINDS];        // entradas de la TLB de segundo nivel (STLB)
+    uint32_t run_count;
+    uint32_t reserved;
+    page_run_t runs[PAGING_MAX_RUNS];
+    uint32_t lazy_count;
+    uint32_t reserved2;
+    lazy_region_info_t lazy[PAGING_MAX_LAZY];
+} paging_info_t;
+
+// Para .bss grandes que no se usan antes de paging_init (ver kernel.ld)
+#define LAZY_BSS __attribute__((section(".bss.lazy")))
+
+/**
+ * @brief Arma las tablas y las carga en todos los CPUs (PAT y CR3)
+ * Requiere pmm_init() y smp_init(); corre en el BSP
+ * @return Páginas de 4 KiB usadas en tablas, 0 si no hubo memoria (sigue Pure64)
+ */
+uint64_t paging_init(void);
+
+/**
+ * @brief Deja sin mapear los 2 MiB que empiezan en addr (alineado a 2 MiB)
+ * Antes de paging_init solo se anota; después se rearman las tablas
+ */
+void paging_add_guard(uint64_t addr);
+
+/**
+ * @brief Rango que PAGING_MODE_4K_HEAP mapea con páginas de 4 KiB
+ */
+void paging_set_small_range(uint64_t start, uint64_t end);
+
+/**
+ * @brief Cambia el modo de mapeo y rearma las tablas en todos los CPUs
+ * @param mode PAGING_MODE_*, o PAGING_MODE_QUERY para consultar
+ * @return Modo activo, -1 si no se pudo armar
+ */
+int paging_set_mode(int mode);
+
+/**
+ * @brief Registra [start, end) como región de demanda en cero
+ * Antes de paging_init solo se anota; después se rearman las tablas.
+ * Con unit de 2 MiB start y end tienen que estar alineados a 2 MiB.
+ * @return 1 si quedó registrada, 0 si no hay lugar (no toca la memoria)
+ */
+int paging_add_lazy(uint64_t start, uint64_t end, uint64_t unit, const char *name);
+
+/**
+ * @brief Deja [start, end) leyendo cero: las páginas enteras pasan a demanda
+ * (unidades de 4 KiB) y los bordes, o todo si no se pudo registrar, se limpian
+ * @return 1 si quedó de demanda, 0 si se limpió con memset
+ */
+int paging_demand_zero(uint64_t start, uint64_t end, const char *name);
+
+/**
+ * @brief Vuelve a dejar sin mapear las unidades enteras de [start, end) que
+ * ya se tocaron; el próximo acceso las trae en cero otra vez
+ */
+void paging_discard(uint64_t start, uint64_t end);
+
+/**
+ * @brief Handler de #PF (vector 14), llamado desde interrupts.asm
+ * @param error Código de error que apila el CPU
+ * @return 1 si se resolvió (reintentar la instrucción), 0 si es un fallo real
+ */
+int paging_handle_fault(uint64_t error);
+
+void paging_get_info(paging_info_t *info);
+
+// Registros de control y MSRs (asm/paging.asm)
+uint64_t cpu_read_cr2(void);
+uint64_t cpu_read_cr3(void);
+void cpu_write_cr3(uint64_t cr3);
+uint64_t cpu_rdmsr(uint32_t msr);
+void cpu_wrmsr(uint32_t msr, uint64_t value);
+void cpu_wbinvd(void);
+void cpu_invlpg(uint64_t addr);
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef PMM_H
+#define PMM_H
+
+#include <stdint.h>
+
+// Allocator de marcos físicos (buddy) armado con el mapa E820 que Pure64 deja
+// en 0x4000. Bloques de 2^order páginas de 4 KiB, hasta 2 MiB; las listas
+// libres son doblemente enlazadas y viven dentro de las mismas páginas libres
+// (la memoria está mapeada 1:1), así alloc y free son O(PAGE_MAX_ORDER).
+// Solo se administra lo que Pure64 mapea (los primeros 4 GiB).
+
+#define PAGE_SIZE        4096
+#define PAGE_SHIFT       12
+#define PAGE_MAX_ORDER   9             // 2^9 páginas = 2 MiB
+#define PAGE_ORDER_2M    PAGE_MAX_ORDER
+#define PAGE_ORDERS      (PAGE_MAX_ORDER + 1)
+
+#define PMM_MAX_RESERVED 16
+#define PMM_NAME_LEN     16
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    char name[PMM_NAME_LEN];
+} mem_region_t;
+
+typedef struct {
+    uint64_t usable_bytes;              // RAM que el E820 marca como usable
+    uint64_t total_pages;               // páginas administradas (libres + en uso)
+    uint64_t free_pages;
+    uint64_t reserved_pages;            // usables pero reservadas (kernel, módulos...)
+    uint64_t free_blocks[PAGE_ORDERS];  // bloques libres por orden
+    uint32_t largest_order;             // mayor orden con un bloque libre (-1 si no hay)
+    uint32_t frag_2m_permille;          // páginas libres que no forman un bloque de 2 MiB
+    uint32_t e820_entries;
+    uint32_t reserved_count;
+    mem_region_t reserved[PMM_MAX_RESERVED];
+} page_stats_t;
+
+/**
+ * @brief Marca [start, end) como no disponible (antes de pmm_init)
+ * @param name Nombre para meminfo (se copia)
+ */
+void pmm_reserve(uint64_t start, uint64_t end, const char *name);
+
+/**
+ * @brief Reserva bytes contiguos en la primera zona usable libre (antes de pmm_init)
+ * @param align Potencia de 2
+ * @return Dirección reservada, 0 si no hay lugar
+ */
+uint64_t pmm_reserve_anywhere(uint64_t bytes, uint64_t align, const char *name);
+
+/**
+ * @brief Bytes de [start, end) que el E820 marca como usables
+ * Sirve para saber si un rango es RAM entera, nada de RAM o mezcla (paging.c)
+ */
+uint64_t pmm_usable_bytes(uint64_t start, uint64_t end);
+
+/**
+ * @brief Lee el E820 y carga en el buddy todo lo usable menos lo reservado
+ * El mapa de páginas se ubica en la primera zona libre que alcance
+ * @return Páginas libres
+ */
+uint64_t pmm_init(void);
+
+/**
+ * @brief Reserva un bloque de 2^order páginas contiguas, alineado a su tamaño
+ * @return Dirección física (= virtual), 0 si no hay memoria
+ */
+void *page_alloc(unsigned order);
+
+/**
+ * @brief Devuelve un bloque obtenido con page_alloc (mismo order)
+ */
+void page_free(void *page, unsigned order);
+
+void pmm_get_stats(page_stats_t *stats);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <registers.h>
+
+// Profiler por muestreo: mientras está activo, el timer del LAPIC de cada CPU
+// dispara PROFILE_VECTOR y se guarda RIP, CS y los retornos encontrados
+// siguiendo la cadena de RBP en un buffer por CPU (circular: quedan las
+// últimas muestras). El reporte resuelve contra la tabla de symbols.h.
+
+#define PROFILE_VECTOR   0xF2
+#define PROFILE_HZ       500
+#define PROFILE_DEPTH    4
+#define PROFILE_POOL     16384     // muestras totales, repartidas entre CPUs
+#define PROFILE_NAME_LEN 40
+
+typedef struct {
+    char name[PROFILE_NAME_LEN];
+    uint64_t addr;
+    uint32_t self;              // muestras con RIP dentro de la función
+    uint32_t total;             // muestras con la función en la pila
+} profile_entry_t;
+
+/**
+ * @brief Vacía los buffers y arranca el timer de muestreo en todos los CPUs
+ * @return Cantidad de CPUs muestreados (0 si no hay LAPIC)
+ */
+int profiler_start(void);
+
+/**
+ * @brief Indica si el profiler tiene el timer del LAPIC
+ */
+int profiler_active(void);
+
+/**
+ * @brief Detiene el muestreo
+ * @return Cantidad de muestras guardadas
+ */
+uint64_t profiler_stop(void);
+
+/**
+ * @brief Registra una muestra del CPU actual (llamado desde _profileTimerHandler)
+ */
+void profiler_sample(const interrupt_frame_t *frame);
+
+/**
+ * @brief Funciones con más muestras propias, de mayor a menor
+ * @return Cantidad de entradas escritas
+ */
+int profiler_report(profile_entry_t *out, int max);
+
+#endif
@@ -5,6 +5,15 @@
 
 #define REG_COUNT 21
 
+/* Frame que deja irqHandlerMaster: pushState + lo que empuja la CPU */
+typedef struct {
+    uint64_t r15, r14, r13, r12, r11, r10, r9, r8;
+    uint64_t rsi, rdi, rbp, rdx, rcx, rbx, rax;
+    uint64_t rip, cs, rflags, rsp, ss;
+} interrupt_frame_t;
+
+extern interrupt_frame_t *irqFrame;        /* frame de la IRQ en curso (ASM) */
+
 extern uint64_t snapshot[REG_COUNT];
 
 
@@ -12,6 +21,7 @@ extern uint64_t snapshot[REG_COUNT];
 extern volatile uint64_t snapshot_saved[REG_COUNT];
 
 void save_snapshot(const uint64_t *raw);   /* re-acomoda a snapshot_saved */
+void save_snapshot_from_frame(const interrupt_frame_t *frame); /* idem, leyendo el frame */
 uint64_t * get_registers(void);            /* devuelve raw (definido en ASM) */
 extern uint64_t get_saved_registers(uint64_t *dst);
 
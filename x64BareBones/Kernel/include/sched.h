@@ -0,0 +1,287 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include <registers.h>
+#include <fpu.h>
+#include <pmm.h>
+#include <spinlock.h>
+
+// Tareas de kernel con planificación round robin. Cada tarea tiene su pila y
+// su contexto se guarda en ella con el mismo formato que deja pushState en
+// interrupts.asm (interrupt_frame_t): cambiar de tarea es cambiar RSP antes
+// del popState/iretq. El IRQ0 descuenta el quantum de la tarea que corre y al
+// agotarse pide el cambio, que hace el stub de la IRQ a la salida; yield,
+// sleep, exit y las esperas lo hacen con int SCHED_YIELD_VECTOR, que arma el
+// mismo frame.
+//
+// Cada CPU tiene su cola de listas y elige la próxima tarea tomando solo su
+// lock. Los ticks llegan por el IRQ0 en el BSP y por el timer del LAPIC
+// (SCHED_TICK_VECTOR, o PROFILE_VECTOR mientras muestrea el profiler) en los
+// APs. Un CPU sin nada que correr roba de la cola más cargada, y cada
+// SCHED_BALANCE_TICKS los ocupados se traen trabajo si otra cola tiene al
+// menos dos tareas más. Las tareas nuevas van al CPU
+// permitido menos cargado; la afinidad (bit i = CPU i) limita dónde pueden
+// correr.
+//
+// La tarea "main" es el flujo del arranque (kernel -> shell) sobre la pila del
+// kernel, fija en el BSP. Cada CPU tiene su "idleN", que corre solo si no hay
+// nada listo; en los APs es su idle loop, que además ejecuta lo que se asigna
+// con smp_submit (ese tiempo cuenta como ocioso).
+//
+// Prioridades: 0 es la clase normal (tiempo compartido) y 1..SCHED_RT_PRIO_MAX
+// la de tiempo real, fija: siempre corre la lista de mayor prioridad y una RT
+// que despierta desaloja enseguida a las de menos. Una tarea RT con período
+// marca sus cuadros con sched_frame: duerme hasta el próximo (con el timer
+// del LAPIC a SCHED_FRAME_HZ mientras haya alguna) y si terminó después del
+// deadline se cuenta como perdido. Los kmutex_t prestan la prioridad de quien
+// espera al dueño (herencia de prioridad).
+
+#define SCHED_MAX_TASKS       32
+#define SCHED_NAME_LEN        16
+#define SCHED_DEFAULT_QUANTUM 2             // ticks del PIT (~55 ms cada uno)
+#define SCHED_MAX_QUANTUM     100
+#define SCHED_YIELD_VECTOR    0x81
+#define SCHED_TICK_VECTOR     0x30          // IRQ_APIC_VECTOR: timer del LAPIC en los APs
+#define SCHED_BALANCE_TICKS   4
+
+#define SCHED_PRIO_NORMAL     0             // tiempo compartido
+#define SCHED_RT_PRIO_MAX     15            // 1..15: tiempo real, mayor gana
+#define SCHED_PRIO_LEVELS     (SCHED_RT_PRIO_MAX + 1)
+#define SCHED_FRAME_HZ        1000          // timer mientras haya tareas con período
+
+#define SCHED_FRAME_RESTART   0             // sched_frame: el cuadro empieza ahora
+#define SCHED_FRAME_WAIT      1             // terminó el cuadro: esperar el próximo
+
+#define TASK_STACK_ORDER 2                  // 16 KiB
+#define TASK_STACK_SIZE  (PAGE_SIZE << TASK_STACK_ORDER)
+
+#define TASK_FREE     0
+#define TASK_READY    1
+#define TASK_RUNNING  2
+#define TASK_SLEEPING 3
+#define TASK_BLOCKED  4                     // en una wait_queue_t
+#define TASK_DEAD     5                     // la pila se libera al terminar el cambio
+
+typedef void (*task_entry_t)(uint64_t arg);
+
+typedef struct task task_t;
+
+// Tareas esperando un evento (p.ej. una tecla); se despiertan todas juntas
+typedef struct {
+    task_t *head;
+    spinlock_t lock;
+} wait_queue_t;
+
+// Mutex que duerme a quien lo encuentra tomado; mientras alguien espera, el
+// dueño corre al menos con la prioridad de esa tarea
+typedef struct kmutex {
+    task_t *owner;
+    struct kmutex *next_held;               // los otros que tiene tomados el dueño
+    uint32_t depth;                         // tomas anidadas del mismo dueño
+    wait_queue_t waiters;
+} kmutex_t;
+
+// Lo que devuelve la syscall de listado de tareas
+typedef struct {
+    uint32_t id;
+    uint8_t state;
+    uint8_t cpu;                            // CPU en el que corre o en cuya cola está
+    uint8_t prio;                           // 0 = normal, 1..SCHED_RT_PRIO_MAX = RT
+    uint8_t eff_prio;                       // con la heredada por kmutex
+    uint32_t affinity;
+    uint32_t period_ms;                     // 0 = sin cuadros
+    uint64_t switches;                      // veces que se le dio el CPU
+    uint64_t preemptions;                   // veces que se la sacó sin que cediera
+    uint64_t migrations;                    // veces que cambió de cola
+    uint64_t cycles;                        // tiempo de CPU (TSC)
+    uint64_t frames;                        // cuadros terminados con sched_frame
+    uint64_t missed;                        // de esos, los que pasaron el deadline
+    char name[SCHED_NAME_LEN];
+} task_info_t;
+
+// Lo que devuelve la syscall de estadísticas por CPU
+typedef struct {
+    uint32_t cpu;
+    uint32_t current;                       // id de la tarea que corre
+    uint32_t ready;                         // tareas en su cola
+    uint32_t reserved;
+    uint64_t busy_cycles;                   // corriendo algo que no es su idle
+    uint64_t idle_cycles;
+    uint64_t switches;
+    uint64_t steals;                        // tareas que trajo de otras colas
+} sched_cpu_stats_t;
+
+/**
+ * @brief Adopta el flujo actual como tarea "main", crea la cola de cada CPU
+ * y engancha los ticks. Requiere pmm_init(), fpu_init() y smp_init()
+ */
+void sched_init(void);
+
+/**
+ * @brief Indica si ya se puede bloquear (sched_init hecho)
+ */
+int sched_active(void);
+
+/**
+ * @brief Crea una tarea que ejecuta entry(arg) en su propia pila; al volver
+ * de entry termina como con sched_exit. Puede correr en cualquier CPU.
+ * @return Id de la tarea, -1 si no hay lugar o memoria
+ */
+int sched_create(task_entry_t entry, uint64_t arg, const char *name);
+
+/**
+ * @brief Como sched_create, para las tareas que pide userland: si main tiene
+ * una excepción se terminan antes de volver a _start
+ */
+int sched_create_user(task_entry_t entry, uint64_t arg, const char *name);
+
+/**
+ * @brief Termina la tarea actual
+ */
+void sched_exit(void) __attribute__((noreturn));
+
+/**
+ * @brief Cede el CPU: la tarea vuelve al final de la cola de listas
+ */
+void sched_yield(void);
+
+/**
+ * @brief Duerme la tarea actual ticks interrupciones del timer
+ */
+void sched_sleep(uint64_t ticks);
+
+/**
+ * @brief Bloquea la tarea actual en q hasta sched_wake_all o timeout_ticks
+ * (0 = sin límite). Quien llama vuelve a chequear su condición.
+ */
+void sched_wait(wait_queue_t *q, uint64_t timeout_ticks);
+
+/**
+ * @brief Pasa a listas todas las tareas de q y pide el cambio a la salida de
+ * la interrupción (se pueden llamar desde un handler de IRQ)
+ */
+void sched_wake_all(wait_queue_t *q);
+
+/**
+ * @brief Termina otra tarea (main y las idle no). Si está corriendo en otro
+ * CPU, termina en su próximo cambio de contexto; si tiene un kmutex tomado
+ * (incluso si es la actual), al soltarlo.
+ * @return 1 si existía
+ */
+int sched_kill(int id);
+
+/**
+ * @brief Cambia el quantum (en ticks); ticks <= 0 solo consulta
+ * @return Quantum vigente
+ */
+int sched_set_quantum(int ticks);
+
+/**
+ * @brief Copia hasta max tareas (las libres no)
+ * @return Cantidad de tareas escritas
+ */
+int sched_get_tasks(task_info_t *out, int max);
+
+int sched_current_id(void);
+
+/**
+ * @brief Indica si el CPU actual está en su idle (o el scheduler no arrancó)
+ */
+int sched_in_idle(void);
+
+/**
+ * @brief Cambia los CPUs en que puede correr una tarea (main y las idle no);
+ * si la actual queda afuera se mueve enseguida
+ * @param mask Bit i = CPU i; 0 solo consulta
+ * @return Máscara anterior, -1 si no existe o la máscara no tiene CPUs online
+ */
+int sched_set_affinity(int id, uint32_t mask);
+
+/**
+ * @brief Copia las estadísticas de hasta max CPUs
+ * @return Cantidad de CPUs escritas
+ */
+int sched_get_cpu_stats(sched_cpu_stats_t *out, int max);
+
+/**
+ * @brief Deja la tarea actual fija en su CPU hasta sched_migrate_enable
+ * (parallel_for: sus deques y smp_wait son del CPU que lo lanzó)
+ */
+void sched_migrate_disable(void);
+void sched_migrate_enable(void);
+
+/**
+ * @brief Cambia la clase de una tarea (las idle no)
+ * @param prio SCHED_PRIO_NORMAL o 1..SCHED_RT_PRIO_MAX
+ * @param period_ms Duración del cuadro para sched_frame (0 = sin cuadros;
+ * solo para RT). Pone en cero sus contadores de cuadros. Necesita el modo
+ * APIC: en modo PIC el único timer es el del PIT (55 ms) y no se aceptan.
+ * @return Prioridad anterior, -1 si no existe, prio no es válida o se pide
+ * período en modo PIC
+ */
+int sched_set_rt(int id, int prio, uint32_t period_ms);
+
+/**
+ * @brief Cuadros de la tarea actual (necesita período)
+ * @param mode SCHED_FRAME_RESTART arranca a contar desde ahora (al empezar o
+ * después de una pausa); SCHED_FRAME_WAIT cierra el cuadro y duerme hasta el
+ * próximo, o sigue enseguida si ya se pasó del deadline
+ * @return 1 si el cuadro se pasó del deadline, 0 si no, -1 sin período
+ */
+int sched_frame(int mode);
+
+/**
+ * @brief Toma m; si lo tiene otra tarea duerme hasta que lo suelte y le
+ * presta la prioridad mientras tanto. Si ya es de la tarea actual (p.ej. una
+ * excepción a mitad de un dibujo) solo cuenta la toma anidada: se suelta con
+ * la misma cantidad de kmutex_unlock. No se puede usar desde una IRQ.
+ */
+void kmutex_lock(kmutex_t *m);
+
+/**
+ * @brief Suelta m (solo su dueño), despierta a quienes esperaban y devuelve
+ * la prioridad prestada; si ahora hay una lista que le gana, cede el CPU
+ */
+void kmutex_unlock(kmutex_t *m);
+
+/**
+ * @brief Para los idle loops, con IF=0: si hay tareas listas para este CPU
+ * (propias o robadas) las corre y vuelve cuando no queda ninguna
+ * @return 0 si no había nada (el idle puede hacer hlt)
+ */
+int sched_run_pending(void);
+
+/**
+ * @brief (Re)arranca el tick del CPU actual: el timer del LAPIC en un AP,
+ * nada en el BSP (IRQ0); en todos a SCHED_FRAME_HZ si hay tareas con
+ * período. El profiler lo usa al devolver el timer.
+ */
+void sched_timer_start(void);
+
+/**
+ * @brief Para quien se quede con el timer del LAPIC (el profiler): en cada
+ * interrupción, a hz, hace lo que haría el tick del scheduler. Quien llama
+ * después pasa por sched_preempt a la salida.
+ */
+void sched_lapic_tick(uint32_t hz);
+
+// Llamados desde interrupts.asm con el frame de pushState de la tarea actual;
+// devuelven el frame de la tarea que sigue (puede ser el mismo). Si cambió,
+// el stub llama a sched_finish ya sobre la pila nueva: recién ahí la anterior
+// se puede correr en otro CPU (o liberar, si murió).
+interrupt_frame_t *sched_preempt(interrupt_frame_t *frame);
+interrupt_frame_t *sched_switch(interrupt_frame_t *frame);
+void sched_finish(void);
+
+/**
+ * @brief Después de mostrar una excepción: la tarea suelta sus kmutex y, si
+ * no fue en main, se termina (no vuelve); main espera que terminen las
+ * tareas de userland y vuelve al shell en la clase normal
+ */
+void sched_exception(void);
+
+// Cambio voluntario: int SCHED_YIELD_VECTOR (interrupts.asm)
+void _yield(void);
+
+#endif
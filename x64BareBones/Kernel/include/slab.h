@@ -0,0 +1,86 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stdint.h>
+
+// Cachés de objetos de tamaño fijo sobre page_alloc. Cada slab es un bloque
+// del buddy alineado a su tamaño, con un encabezado al principio y la lista
+// libre embebida en los objetos libres; kmem_cache_free encuentra el slab
+// enmascarando la dirección. Con KMEM_MAGAZINES cada CPU tiene un magazine
+// (pila de objetos) que atiende alloc/free sin lock; el lock del caché solo
+// se toma para recargar o vaciar medio magazine.
+
+#define KMEM_MAX_CACHES   32
+#define KMEM_NAME_LEN     16
+#define KMEM_MAGAZINE     16            // objetos por magazine
+#define KMEM_MIN_OBJS     8             // objetos mínimos por slab (elige el orden)
+
+#define KMEM_CACHE_ALIGN  0x1           // objetos alineados a línea de caché (64)
+#define KMEM_MAGAZINES    0x2           // magazines por CPU
+
+#define KMALLOC_MIN       16
+#define KMALLOC_MAX       2048
+
+typedef struct kmem_cache kmem_cache_t;
+
+typedef struct {
+    char name[KMEM_NAME_LEN];
+    uint32_t obj_size;                  // tamaño real (con relleno de alineación)
+    uint32_t objs_per_slab;
+    uint32_t slab_order;                // slab = 2^slab_order páginas
+    uint32_t slabs;
+    uint64_t active;                    // objetos entregados y no devueltos
+    uint64_t cached;                    // objetos en magazines
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t magazine_hits;             // alloc/free resueltos sin lock
+} kmem_stats_t;
+
+// Ciclos por par alloc/free medidos por kmem_benchmark
+typedef struct {
+    uint64_t magazine_pair;             // caché con magazines, mismo objeto una y otra vez
+    uint64_t slab_pair;                 // caché sin magazines (lock + lista del slab)
+    uint64_t batch_pair;                // con magazines, de a KMEM_BENCH_BATCH objetos
+} kmem_bench_t;
+
+#define KMEM_BENCH_BATCH 64
+
+/**
+ * @brief Crea los cachés de kmalloc (16 a 2048 bytes); requiere pmm_init()
+ */
+void kmem_init(void);
+
+/**
+ * @brief Crea un caché de objetos de size bytes
+ * @param flags KMEM_CACHE_ALIGN, KMEM_MAGAZINES
+ * @return El caché, 0 si no hay lugar o el objeto no entra en un slab
+ */
+kmem_cache_t *kmem_cache_create(const char *name, uint32_t size, uint32_t flags);
+
+void *kmem_cache_alloc(kmem_cache_t *cache);
+void kmem_cache_free(kmem_cache_t *cache, void *obj);
+
+/**
+ * @brief Objeto del caché de potencia de 2 que corresponde (hasta KMALLOC_MAX)
+ * @return 0 si size es 0, mayor a KMALLOC_MAX o no hay memoria
+ */
+void *kmalloc(uint64_t size);
+
+/**
+ * @brief Libera un objeto obtenido con kmalloc (los slabs de kmalloc tienen
+ * todos el mismo tamaño, así el caché sale del encabezado del slab)
+ */
+void kfree(void *obj);
+
+/**
+ * @brief Copia los contadores de hasta max cachés
+ * @return Cantidad de cachés escritos
+ */
+int kmem_get_stats(kmem_stats_t *out, int max);
+
+/**
+ * @brief Mide el costo de pares alloc/free (iterations de cada tipo)
+ */
+void kmem_benchmark(kmem_bench_t *out, int iterations);
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef SMP_H
+#define SMP_H
+
+#include <stdint.h>
+
+// Los APs que Pure64 deja dormidos (hlt con IF=1 sobre la IDT compartida en 0)
+// se traen al kernel con una IPI a SMP_START_VECTOR: cada uno carga su propia
+// GDT, la IDT del kernel, su bloque per-CPU en GS y pasa a un idle loop en su
+// propia pila, donde ejecuta el trabajo que le asigna el BSP.
+
+#define MAX_CPUS 16
+#define AP_STACK_SIZE (16 * 1024)
+
+#define SMP_START_VECTOR 0xF0   // primera IPI: entrar al kernel
+#define SMP_WAKE_VECTOR  0xF1   // sacar al AP del hlt del idle loop
+#define SMP_CALL_VECTOR  0xF3   // hay llamadas en el mailbox (smp_call_function)
+
+#define SMP_ALL_CPUS 0xFFFFFFFFu
+
+typedef void (*smp_work_fn)(uint64_t arg);
+
+// Bloque per-CPU; GS base apunta acá. self tiene que quedar en el offset 0.
+typedef struct cpu {
+    struct cpu *self;
+    uint32_t index;             // 0 = BSP
+    uint8_t apic_id;
+    volatile uint8_t online;
+    uint16_t reserved;
+    uint64_t stack_top;
+    uint64_t gdt[3];            // null, code 0x08, data 0x10 (como Pure64)
+    volatile smp_work_fn work_fn;
+    volatile uint64_t work_arg;
+    volatile uint64_t work_done; // trabajos completados por este CPU
+    int64_t tsc_offset;         // TSC de este CPU - TSC del BSP (tscsync.c)
+} cpu_t;
+
+// Lo que devuelve la syscall de listado de CPUs
+typedef struct {
+    uint8_t index;
+    uint8_t apic_id;
+    uint8_t online;
+    uint8_t is_bsp;
+    uint32_t reserved;
+    uint64_t work_done;
+} cpu_info_t;
+
+/**
+ * @brief Registra al BSP y despierta a los APs activos de Pure64
+ * Requiere apic_init() y calibrate_tsc() (timeout de arranque)
+ */
+void smp_init(void);
+
+/**
+ * @brief Bloque per-CPU del CPU que ejecuta (lee gs:0)
+ */
+cpu_t *this_cpu(void);
+
+int smp_cpu_count(void);
+cpu_t *smp_cpu(int index);
+
+/**
+ * @brief Asigna fn(arg) al CPU index (un AP online con el slot libre)
+ * @return 1 si se asignó, 0 si el CPU no existe, es el BSP o está ocupado
+ */
+int smp_submit(int index, smp_work_fn fn, uint64_t arg);
+
+/**
+ * @brief Espera (spin) a que el CPU index termine su trabajo
+ */
+void smp_wait(int index);
+
+/**
+ * @brief Para una excepción en el idle loop de un AP (p.ej. en un trabajo de
+ * smp_submit): descarta el trabajo y vuelve a empezar el idle loop sobre la
+ * pila del AP. No vuelve.
+ */
+void smp_abort_work(void) __attribute__((noreturn));
+
+/**
+ * @brief Ejecuta fn(arg) en cada CPU de cpu_mask (bit i = CPU i), por IPI
+ * Cada CPU tiene un mailbox con un slot por emisor (SPSC, sin locks). Si el
+ * CPU actual está en la máscara, corre fn directamente. Mientras espera,
+ * atiende su propio mailbox, así dos CPUs que se llaman no se bloquean.
+ * @param wait 1 = volver cuando todos terminaron
+ * @return Cantidad de CPUs a los que se les pidió la llamada
+ */
+int smp_call_function(uint32_t cpu_mask, smp_work_fn fn, uint64_t arg, int wait);
+
+/**
+ * @brief Atiende las llamadas pendientes del CPU actual (handler de SMP_CALL_VECTOR)
+ */
+void smp_handle_calls(void);
+
+// Latencia ida y vuelta de smp_call_function hacia un CPU (en ciclos)
+typedef struct {
+    uint32_t cpu;
+    uint32_t apic_id;
+    uint64_t min_cycles;
+    uint64_t avg_cycles;
+    uint64_t max_cycles;
+} ipi_latency_t;
+
+/**
+ * @brief Mide iterations llamadas vacías con espera hacia cada otro CPU
+ * @return Cantidad de CPUs medidos
+ */
+int smp_call_benchmark(ipi_latency_t *out, int max, int iterations);
+
+/**
+ * @brief Llena info con hasta max CPUs
+ * @return Cantidad de CPUs escritas
+ */
+int smp_get_cpus(cpu_info_t *info, int max);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+#include <stdint.h>
+
+// Spinlock con interrupciones deshabilitadas mientras se tiene tomado (sirve
+// entre CPUs y contra handlers del mismo CPU). Inline porque lo usan los
+// caminos rápidos de pmm.c y slab.c.
+
+typedef struct {
+    volatile char locked;
+} spinlock_t;
+
+static inline uint64_t irq_save(void) {
+    uint64_t flags;
+    __asm__ volatile("pushfq; pop %0; cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+static inline void irq_restore(uint64_t flags) {
+    __asm__ volatile("push %0; popfq" : : "r"(flags) : "memory", "cc");
+}
+
+static inline uint64_t spin_lock_irqsave(spinlock_t *lock) {
+    uint64_t flags = irq_save();
+    while (__atomic_test_and_set(&lock->locked, __ATOMIC_ACQUIRE)) {
+        while (lock->locked)
+            __asm__ volatile("pause");
+    }
+    return flags;
+}
+
+static inline void spin_unlock_irqrestore(spinlock_t *lock, uint64_t flags) {
+    __atomic_clear(&lock->locked, __ATOMIC_RELEASE);
+    irq_restore(flags);
+}
+
+#endif
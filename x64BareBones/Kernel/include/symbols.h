@@ -0,0 +1,33 @@
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <stdint.h>
+
+// Tabla de símbolos del kernel y de sampleCodeModule, armada en Image/Makefile
+// a partir de los link maps y empaquetada como un módulo más. Formato: una
+// línea por símbolo, "%016x nombre\n", ordenada por dirección, terminada en '\0'.
+
+#define MAX_SYMBOLS 4096
+
+typedef struct {
+    uint64_t addr;
+    const char *name;
+} symbol_t;
+
+/**
+ * @brief Indexa la tabla (reemplaza los '\n' por '\0' en el lugar)
+ * Se detiene en la primera línea mal formada: sin módulo, queda vacía
+ * @return Cantidad de símbolos
+ */
+int symbols_init(char *table);
+
+/**
+ * @brief Índice del símbolo que contiene addr (el último con dirección <= addr)
+ * @return Índice, o -1 si addr está antes del primer símbolo
+ */
+int symbol_index(uint64_t addr);
+
+const symbol_t *symbol_get(int index);
+int symbol_count(void);
+
+#endif
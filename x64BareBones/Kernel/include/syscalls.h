@@ -4,12 +4,24 @@
 #include <stdint.h>
 #include <time.h>
 #include <rtc.h>
+#include <iovec.h>
 
 void syscall_write(const char *str, int len);
+uint64_t syscall_writev(const iovec_t *iov, int iovcnt);
+void syscall_draw_rect(uint32_t color, uint64_t x, uint64_t y, uint64_t width, uint64_t height);
+void syscall_put_char(char c, uint32_t x, uint32_t y, uint32_t color);
 uint64_t sys_read(int fd, char * buffer, int count);
+uint64_t sys_read_timeout(int fd, char * buffer, int count, int64_t timeout_ms);
 void syscall_clear_screen();
 void get_time(rtc_time_t * arg1);
 void play_sound(uint32_t frequency, uint32_t duration_ms);
 void change_font_size(int new_size);
 
+// Toma/suelta el driver de video (kmutex); todo lo que dibuja con tareas
+// corriendo pasa por acá. video_lock dibuja con IF=1, video_lock_irqoff con
+// IF=0 (excepciones); video_unlock deja IF como estaba antes del lock.
+uint64_t video_lock(void);
+uint64_t video_lock_irqoff(void);
+void video_unlock(uint64_t flags);
+
 #endif
@@ -0,0 +1,37 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <stdint.h>
+#include <smp.h>
+
+// Pool de tareas con work stealing: una deque Chase-Lev por CPU. El dueño
+// apila y desapila por abajo; los CPUs ociosos roban por arriba.
+
+#define TASK_DEQUE_SIZE 64      // potencia de 2
+
+// Cuerpo de un parallel_for: procesa los índices [start, end)
+typedef void (*range_fn)(uint64_t start, uint64_t end, void *arg);
+
+typedef struct {
+    uint64_t executed;          // tareas (rangos) ejecutadas
+    uint64_t iterations;        // índices procesados
+    uint64_t steals;            // robos exitosos
+    uint64_t failed_steals;     // intentos sobre deques vacías o perdidos por CAS
+} taskpool_stats_t;
+
+/**
+ * @brief Ejecuta fn sobre [start, end) repartido entre todos los CPUs online
+ * Los rangos se parten a la mitad hasta grain índices. fn corre también en
+ * los APs, así que no puede hacer syscalls ni tocar el video.
+ * @param grain Tamaño mínimo de un rango (0 = elegir según cantidad de CPUs)
+ * @return Cantidad de CPUs que participaron
+ */
+int parallel_for(uint64_t start, uint64_t end, uint64_t grain, range_fn fn, void *arg);
+
+/**
+ * @brief Copia los contadores por CPU (índice = CPU)
+ * @return Cantidad de entradas escritas
+ */
+int taskpool_get_stats(taskpool_stats_t *stats, int max);
+
+#endif
@@ -3,9 +3,18 @@
 
 #include <stdint.h>
 
-void timer_handler();
+// El PIT queda con el divisor por defecto (65536): ~18.2 Hz
+#define TIMER_TICK_US 54925
+
+void timer_handler(void *ctx);
 int ticks_elapsed();
 int seconds_elapsed();
 uint64_t get_ticks();
+void sleep(uint64_t pauseTicks);
+
+/**
+ * @brief Ticks del timer que cubren ms (redondeado para arriba)
+ */
+uint64_t ms_to_ticks(uint64_t ms);
 
 #endif
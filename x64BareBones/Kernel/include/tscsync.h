@@ -0,0 +1,39 @@
+#ifndef TSCSYNC_H
+#define TSCSYNC_H
+
+#include <stdint.h>
+
+// Sincronización del TSC entre cores: el BSP hace un ping-pong con cada AP
+// (escribe ping, el AP lee su TSC y contesta) y estima el offset del AP como
+// t_ap - (t_envio + t_respuesta) / 2 en la ronda con menor ida y vuelta; el
+// error queda acotado por rtt / 2. El offset se guarda en cpu_t y lo resta
+// tsc_now(). Después se corre un test de "warps": ambos CPUs publican su
+// última lectura en una variable compartida y cuentan las veces que leen un
+// valor menor al publicado por el otro (sin y con la corrección).
+
+#define TSC_SYNC_ROUNDS     1000
+#define TSC_WARP_ITERATIONS 50000
+
+typedef struct {
+    uint32_t cpu;
+    uint32_t apic_id;
+    int64_t offset;             // ciclos: TSC del CPU - TSC del BSP
+    uint64_t rtt;               // mejor ida y vuelta del ping-pong (cota: ±rtt/2)
+    uint64_t warps_raw;         // lecturas que retrocedieron con rdtsc crudo
+    uint64_t warps_corrected;   // idem con tsc_now()
+} tsc_sync_t;
+
+/**
+ * @brief Mide el offset de cada AP contra el BSP y lo aplica a tsc_now()
+ * Requiere smp_init(); corre en el BSP
+ * @return Mayor |offset| medido en ciclos
+ */
+uint64_t tsc_sync_init(void);
+
+/**
+ * @brief Copia el resultado de la medición (índice 0 = BSP)
+ * @return Cantidad de CPUs escritas
+ */
+int tsc_sync_get(tsc_sync_t *out, int max);
+
+#endif
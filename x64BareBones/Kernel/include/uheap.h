@@ -0,0 +1,52 @@
+#ifndef UHEAP_H
+#define UHEAP_H
+
+#include <stdint.h>
+
+// Heap de userland: una ventana contigua (mapeo 1:1) reservada al arrancar
+// que sbrk va habilitando desde abajo, más bloques sueltos del buddy estilo
+// mmap para pedidos de hasta 2 MiB que se pueden devolver por separado.
+// La ventana es de demanda en cero (paging.c): lo que está arriba del break
+// siempre lee cero sin que sbrk tenga que limpiarlo.
+
+#define USER_HEAP_MAX   (64ULL << 20)
+#define USER_HEAP_MIN   (4ULL << 20)
+#define USER_HEAP_ALIGN (2ULL << 20)
+#define USER_HEAP_GUARD (2ULL << 20)    // sin mapear sobre la ventana
+#define USER_MMAP_SLOTS 64              // bloques de uheap_mmap vivos a la vez
+
+/**
+ * @brief Reserva la ventana del heap (la más grande posible hasta USER_HEAP_MAX)
+ * Va antes de pmm_init para que el buddy no la reparta; la guarda de arriba
+ * se registra en paging.c
+ * @return Tamaño de la ventana, 0 si no hubo lugar
+ */
+uint64_t uheap_init(void);
+
+/**
+ * @brief Mueve el break increment bytes (puede ser negativo); lo nuevo lee cero
+ * @return Break anterior, (uint64_t)-1 si se sale de la ventana
+ */
+uint64_t uheap_sbrk(int64_t increment);
+
+/**
+ * @brief Bloque de páginas en cero fuera de la ventana (hasta 2 MiB)
+ * @return Dirección del bloque, 0 si no hay memoria, es muy grande o ya hay
+ * USER_MMAP_SLOTS bloques entregados
+ */
+void *uheap_mmap(uint64_t bytes);
+
+/**
+ * @brief Devuelve un bloque de uheap_mmap; cualquier otra dirección se
+ * ignora. bytes no se usa: el tamaño es el que se registró al entregarlo.
+ */
+void uheap_munmap(void *addr, uint64_t bytes);
+
+/**
+ * @brief Toma/suelta el lock del malloc de userland (un kmutex): si matan a
+ * la tarea que lo tiene, termina recién al soltarlo y el heap queda entero
+ */
+void uheap_lock(void);
+void uheap_unlock(void);
+
+#endif
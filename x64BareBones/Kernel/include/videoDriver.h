@@ -2,11 +2,13 @@
 #define VIDEO_DRIVER_H
 
 #include <stdint.h>
+#include <iovec.h>
 
 void putPixel(uint32_t hexColor, uint64_t x, uint64_t y);
 
 void putChar(char c, uint32_t x, uint32_t y, uint32_t color);
 void writeString(const char *str, int len);
+uint64_t writeStringv(const iovec_t *iov, int iovcnt);
 void drawRect(uint32_t hexColor, uint64_t x, uint64_t y, uint64_t width, uint64_t height);
 void print_hex64(uint64_t value);
 
@@ -14,6 +16,8 @@ void clearScreen();
 
 uint16_t getScreenWidth();
 uint16_t getScreenHeight();
+uint64_t getFramebufferBase();
+uint64_t getFramebufferSize();
 static void drawCursorAt(uint32_t x, uint32_t y);
 
 void setScale(int new_size);
@@ -0,0 +1,229 @@
+#include <apic.h>
+#include <interrupts.h>
+#include <bench_timer.h>
+#include <spinlock.h>
+
+// Variables de sistema de Pure64 (ver Bootloader/Pure64/src/sysvar.asm)
+#define PURE64_ACPI_TABLE   ((uint64_t *) 0x5A00)   // RSDT o XSDT
+#define PURE64_LAPIC_ADDR   ((uint64_t *) 0x5A28)
+#define PURE64_IOAPIC_ADDR  ((uint32_t *) 0x5A30)   // dirección, GSI base
+#define PURE64_IOAPIC_COUNT ((uint8_t *) 0x5BA8)
+
+#define IOAPIC_REGSEL 0x00
+#define IOAPIC_WIN    0x10
+#define IOAPIC_REDTBL 0x10
+
+#define REDIR_MASKED      (1 << 16)
+#define REDIR_LEVEL       (1 << 15)
+#define REDIR_ACTIVE_LOW  (1 << 13)
+
+#define ISA_IRQS 16
+
+#define LVT_MASKED        (1 << 16)
+#define LVT_TIMER_PERIODIC (1 << 17)
+#define TIMER_DIV_16      0x3
+#define TIMER_CALIBRATE_MS 10
+
+// Registro de EOI del LAPIC; lo usa irqHandlerMaster. 0 => EOI al PIC.
+volatile uint32_t *apicEoiRegister = 0;
+volatile uint32_t *lapicEoiAddress = 0;
+
+static volatile uint32_t *lapic = 0;
+static volatile uint32_t *ioapic = 0;
+static uint32_t ioapic_gsi_base = 0;
+static int irq_mode = IRQ_MODE_PIC;
+static uint16_t enabledLines = 0;          // líneas ISA con handlers registrados
+static uint64_t lapic_timer_per_ms = 0;    // ticks del timer (div 16) por ms
+
+// IRQ ISA -> GSI y flags de la redirección, según los overrides de la MADT
+static uint32_t isa_gsi[ISA_IRQS];
+static uint32_t isa_flags[ISA_IRQS];
+
+uint32_t lapic_read(uint32_t reg) {
+    return lapic[reg / 4];
+}
+
+void lapic_write(uint32_t reg, uint32_t value) {
+    lapic[reg / 4] = value;
+}
+
+uint8_t lapic_id(void) {
+    return lapic_read(LAPIC_ID) >> 24;
+}
+
+void lapic_send_ipi(uint8_t apic_id, uint8_t vector) {
+    lapic_write(LAPIC_ICR_HIGH, (uint32_t)apic_id << 24);
+    lapic_write(LAPIC_ICR_LOW, vector | (1 << 14));     // fixed, assert
+    while (lapic_read(LAPIC_ICR_LOW) & (1 << 12))        // delivery status
+        ;
+}
+
+// Todos los LAPIC comparten el reloj de bus: alcanza con medir una vez
+static void lapic_timer_calibrate(void) {
+    uint64_t cycles = get_tsc_frequency() / 1000 * TIMER_CALIBRATE_MS;
+
+    lapic_write(LAPIC_TIMER_DIV, TIMER_DIV_16);
+    lapic_write(LAPIC_LVT_TIMER, LVT_MASKED);
+    lapic_write(LAPIC_TIMER_INIT, 0xFFFFFFFF);
+    uint64_t start = rdtsc();
+    while (rdtsc() - start < cycles)
+        ;
+    uint32_t elapsed = 0xFFFFFFFF - lapic_read(LAPIC_TIMER_COUNT);
+    lapic_write(LAPIC_TIMER_INIT, 0);
+
+    lapic_timer_per_ms = elapsed / TIMER_CALIBRATE_MS;
+}
+
+void lapic_timer_start(uint8_t vector, uint32_t hz) {
+    if (lapic == 0 || hz == 0)
+        return;
+    if (lapic_timer_per_ms == 0)
+        lapic_timer_calibrate();
+
+    uint64_t count = lapic_timer_per_ms * 1000 / hz;
+    lapic_write(LAPIC_TIMER_DIV, TIMER_DIV_16);
+    lapic_write(LAPIC_LVT_TIMER, vector | LVT_TIMER_PERIODIC);
+    lapic_write(LAPIC_TIMER_INIT, count ? (uint32_t)count : 1);
+}
+
+void lapic_timer_stop(void) {
+    if (lapic == 0)
+        return;
+    lapic_write(LAPIC_LVT_TIMER, LVT_MASKED);
+    lapic_write(LAPIC_TIMER_INIT, 0);
+}
+
+static void ioapic_write(uint32_t reg, uint32_t value) {
+    ioapic[IOAPIC_REGSEL / 4] = reg;
+    ioapic[IOAPIC_WIN / 4] = value;
+}
+
+static void ioapic_set_entry(uint32_t gsi, uint32_t low, uint8_t dest) {
+    uint32_t pin = gsi - ioapic_gsi_base;
+    ioapic_write(IOAPIC_REDTBL + 2 * pin + 1, (uint32_t)dest << 24);
+    ioapic_write(IOAPIC_REDTBL + 2 * pin, low);
+}
+
+// Recorre la MADT buscando Interrupt Source Overrides (tipo 2).
+// Pure64 no los guarda; en QEMU el PIT (IRQ0) llega por el GSI 2.
+static void parse_source_overrides(void) {
+    for (int i = 0; i < ISA_IRQS; i++) {
+        isa_gsi[i] = i;
+        isa_flags[i] = 0;
+    }
+
+    uint8_t *sdt = (uint8_t *)*PURE64_ACPI_TABLE;
+    if (sdt == 0)
+        return;
+
+    int xsdt = sdt[0] == 'X';
+    uint32_t length = *(uint32_t *)(sdt + 4);
+    uint32_t entry_size = xsdt ? 8 : 4;
+
+    for (uint32_t off = 36; off + entry_size <= length; off += entry_size) {
+        uint8_t *table = xsdt ? (uint8_t *)*(uint64_t *)(sdt + off)
+                              : (uint8_t *)(uint64_t)*(uint32_t *)(sdt + off);
+        if (table[0] != 'A' || table[1] != 'P' || table[2] != 'I' || table[3] != 'C')
+            continue;
+
+        uint32_t madt_length = *(uint32_t *)(table + 4);
+        for (uint32_t p = 44; p + 2 <= madt_length; p += table[p + 1]) {
+            if (table[p + 1] == 0)
+                break;
+            if (table[p] == 2) {
+                uint8_t source = table[p + 3];
+                uint32_t gsi = *(uint32_t *)(table + p + 4);
+                uint16_t flags = *(uint16_t *)(table + p + 8);
+                if (source < ISA_IRQS) {
+                    isa_gsi[source] = gsi;
+                    isa_flags[source] = 0;
+                    if ((flags & 0x3) == 0x3)
+                        isa_flags[source] |= REDIR_ACTIVE_LOW;
+                    if (((flags >> 2) & 0x3) == 0x3)
+                        isa_flags[source] |= REDIR_LEVEL;
+                }
+            }
+        }
+        return;
+    }
+}
+
+void apic_init(void) {
+    if (*PURE64_LAPIC_ADDR == 0)
+        return;
+
+    lapic = (volatile uint32_t *)*PURE64_LAPIC_ADDR;
+    lapicEoiAddress = &lapic[LAPIC_EOI / 4];
+    if (*PURE64_IOAPIC_COUNT == 0)
+        return;
+    ioapic = (volatile uint32_t *)(uint64_t)PURE64_IOAPIC_ADDR[0];
+    ioapic_gsi_base = PURE64_IOAPIC_ADDR[1];
+    parse_source_overrides();
+}
+
+int apic_available(void) {
+    return lapic != 0 && ioapic != 0;
+}
+
+static void route_isa_irq(uint8_t irq, int enable) {
+    uint32_t low = (0x20 + irq) | isa_flags[irq];
+    if (!enable)
+        low |= REDIR_MASKED;
+    ioapic_set_entry(isa_gsi[irq], low, lapic_id());
+}
+
+static void apply_pic_masks(void) {
+    uint16_t lines = enabledLines;
+    if (lines & 0xFF00)
+        lines |= 1 << 2;                   // cascada al esclavo
+    picMasterMask(~lines & 0xFF);
+    picSlaveMask((~lines >> 8) & 0xFF);
+}
+
+void irq_enable_line(uint8_t irq) {
+    if (irq >= ISA_IRQS)
+        return;
+    enabledLines |= 1 << irq;
+    if (irq_mode == IRQ_MODE_APIC)
+        route_isa_irq(irq, 1);
+    else
+        apply_pic_masks();
+}
+
+int irq_set_mode(int mode) {
+    if (mode == IRQ_MODE_QUERY)
+        return irq_mode;
+    if (mode == IRQ_MODE_APIC && !apic_available())
+        return -1;
+    if (mode != IRQ_MODE_APIC && mode != IRQ_MODE_PIC)
+        return -1;
+
+    // puede llegar por la syscall 23: no se habilitan interrupciones adentro
+    uint64_t flags = irq_save();
+    if (mode == IRQ_MODE_APIC) {
+        picMasterMask(0xFF);
+        picSlaveMask(0xFF);
+
+        // LAPIC habilitado por software, sin filtrar prioridades
+        lapic_write(LAPIC_SVR, lapic_read(LAPIC_SVR) | 0x100 | APIC_SPURIOUS_VECTOR);
+        lapic_write(LAPIC_TPR, 0);
+
+        for (uint8_t irq = 0; irq < ISA_IRQS; irq++) {
+            if (enabledLines & (1 << irq))
+                route_isa_irq(irq, 1);
+        }
+        apicEoiRegister = &lapic[LAPIC_EOI / 4];
+    } else {
+        if (apic_available()) {
+            for (uint8_t irq = 0; irq < ISA_IRQS; irq++) {
+                if (enabledLines & (1 << irq))
+                    route_isa_irq(irq, 0);
+            }
+        }
+        apicEoiRegister = 0;
+        apply_pic_masks();
+    }
+    irq_mode = mode;
+    irq_restore(flags);
+    return irq_mode;
+}
@@ -1,6 +1,7 @@
 #include <bench_timer.h>
 #include <stdint.h>
 #include <time.h>
+#include <smp.h>
 
 // ============================================================================
 // Variables globales para calibración
@@ -104,6 +105,14 @@ uint64_t get_tsc_frequency(void) {
     return tsc_frequency_hz;
 }
 
+uint64_t tsc_now(void) {
+    // Antes de smp_init GS no apunta a un bloque per-CPU
+    if (smp_cpu_count() == 0) {
+        return rdtsc();
+    }
+    return rdtsc() - (uint64_t)this_cpu()->tsc_offset;
+}
+
 // ============================================================================
 // Funciones de conversión
 // ============================================================================
@@ -0,0 +1,40 @@
+#include <deferred.h>
+#include <interrupts.h>
+
+typedef struct {
+    deferred_fn fn;
+    uint64_t arg;
+} work_item_t;
+
+static work_item_t queue[DEFERRED_QUEUE_SIZE];
+static int head = 0;
+static int tail = 0;
+static int running = 0;
+
+int defer_work(deferred_fn fn, uint64_t arg) {
+    int next = (tail + 1) % DEFERRED_QUEUE_SIZE;
+    if (next == head)
+        return 0;
+    queue[tail].fn = fn;
+    queue[tail].arg = arg;
+    tail = next;
+    return 1;
+}
+
+void run_deferred_work(void) {
+    if (running)
+        return;
+    running = 1;
+
+    // la cola se manipula con IF=0; cada trabajo corre con IF=1
+    while (head != tail) {
+        work_item_t item = queue[head];
+        head = (head + 1) % DEFERRED_QUEUE_SIZE;
+
+        _sti();
+        item.fn(item.arg);
+        _cli();
+    }
+
+    running = 0;
+}
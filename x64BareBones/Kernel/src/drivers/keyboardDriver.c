@@ -5,16 +5,49 @@
 #include "registers.h"
 #include <videoDriver.h>
 #include <interrupts.h>
+#include <bench_timer.h>
+#include <sched.h>
+#include <syscalls.h>
+#include <time.h>
 
 extern uint8_t inb(uint16_t port);  // asm i/o
 extern void outb(uint16_t port, uint8_t value);
 
 #define KEYS_AMOUNT 58
-#define BUFFER_SIZE 256
+#define RING_MASK (KBD_RING_SIZE - 1)
 
-static char keyBuffer[BUFFER_SIZE];
-static int head = 0;
-static int tail = 0;
+// Ring de caracteres en su propia página: userland la lee sin syscalls.
+// Un solo productor (IRQ1) publica tail con release; los consumidores
+// leen tail con acquire y reclaman head con CAS (el kernel también consume,
+// p.ej. el "press any key" del volcado de registros).
+static kbd_ring_t keyRing __attribute__((aligned(4096)));
+static int overflowing = 0;         // la última tecla ya fue descartada
+static uint64_t last_key_tsc = 0;   // TSC del último push (latencia de wake-up)
+static wait_queue_t keyWaiters;     // tareas en keyboard_wait
+
+// Ctrl+R / Ctrl+L: el IRQ1 marca el pedido y despierta a la tarea "kbdview",
+// que dibuja con el mutex de video como cualquier syscall
+#define VIEW_REGS  0x1
+#define VIEW_CLEAR 0x2
+static uint32_t viewPending;
+static wait_queue_t viewWaiters;
+
+// cola paralela de eventos make/break con timestamp, y estado de cada tecla
+static key_event_t eventBuffer[EVENT_BUFFER_SIZE];
+static int eventHead = 0;
+static int eventTail = 0;
+static uint64_t keyState[2];         // bitmap de 128 teclas presionadas
+static int extendedPrefix = 0;       // se recibió 0xE0
+
+// códigos extendidos (0xE0 xx) -> keycode en el rango libre 0x60-0x7F
+static const uint8_t extendedKeycode[128] = {
+    [0x1C] = KEY_KP_ENTER, [0x1D] = KEY_RCTRL,  [0x35] = KEY_KP_SLASH,
+    [0x38] = KEY_RALT,     [0x47] = KEY_HOME,   [0x48] = KEY_UP,
+    [0x49] = KEY_PGUP,     [0x4B] = KEY_LEFT,   [0x4D] = KEY_RIGHT,
+    [0x4F] = KEY_END,      [0x50] = KEY_DOWN,   [0x51] = KEY_PGDN,
+    [0x52] = KEY_INSERT,   [0x53] = KEY_DELETE, [0x5B] = KEY_LGUI,
+    [0x5C] = KEY_RGUI,     [0x5D] = KEY_MENU
+};
 
 static const char *regName[REG_COUNT] = {
     "RAX","RBX","RCX","RDX","RSI","RDI","RBP",
@@ -22,6 +55,7 @@ static const char *regName[REG_COUNT] = {
     "RSP","RIP","CS","RFLAGS","URSP","USS"
 };
 
+// corre en la tarea kbdview, con el mutex de video tomado
 static void show_registers(void) {
     uint64_t regs[REG_COUNT];
     get_saved_registers(regs);
@@ -33,20 +67,41 @@ static void show_registers(void) {
         writeString("\n", 1);
     }
 
-    /*
-     * We are still inside the keyboard interrupt handler when this
-     * function is called.  Send the End Of Interrupt (EOI) to the PIC
-     * manually so new keyboard interrupts are delivered while we wait
-     * for the user to press a key to continue.
-     */
-    outb(0x20, 0x20);
-
-    _sti();
     writeString("Press any key to continue...\n", 29);
-    while (keyboard_getchar() == 0);
+    keyboard_wait(KBD_WAIT_FOREVER);
+    keyboard_getchar();
     clearScreen();
 }
 
+static void view_task(uint64_t arg) {
+    for (;;) {
+        // se evalúa con IF=0 en el CPU del IRQ1: el pedido no se pierde
+        _cli();
+        while (__atomic_load_n(&viewPending, __ATOMIC_RELAXED) == 0)
+            sched_wait(&viewWaiters, 0);
+        uint32_t pending = __atomic_exchange_n(&viewPending, 0, __ATOMIC_ACQ_REL);
+
+        uint64_t flags = video_lock();
+        if (pending & VIEW_REGS)
+            show_registers();
+        else
+            clearScreen();
+        video_unlock(flags);
+    }
+}
+
+static void request_view(uint32_t what) {
+    __atomic_or_fetch(&viewPending, what, __ATOMIC_RELEASE);
+    sched_wake_all(&viewWaiters);
+}
+
+int keyboard_start_view_task() {
+    int id = sched_create(view_task, 0, "kbdview");
+    if (id >= 0)
+        sched_set_affinity(id, 1);
+    return id;
+}
+
 static const char scanCodeTable[KEYS_AMOUNT][2] = {
     {0, 0}, {27, 27}, {'1', '!'}, {'2', '@'}, {'3', '#'}, {'4', '$'}, {'5', '%'}, {'6', '^'},
     {'7', '&'}, {'8', '*'}, {'9', '('}, {'0', ')'}, {'-', '_'}, {'=', '+'}, {'\b', '\b'},
@@ -60,38 +115,147 @@ static const char scanCodeTable[KEYS_AMOUNT][2] = {
 
 
 static int isBufferEmpty() {
-    return head == tail;
+    return __atomic_load_n(&keyRing.head, __ATOMIC_RELAXED) ==
+           __atomic_load_n(&keyRing.tail, __ATOMIC_ACQUIRE);
 }
 
-static int isBufferFull() {
-    return ((tail + 1) % BUFFER_SIZE) == head;
+static void pushKey(char c) {
+    uint32_t tail = keyRing.tail;   // solo el productor lo escribe
+    uint32_t head = __atomic_load_n(&keyRing.head, __ATOMIC_ACQUIRE);
+
+    if (tail - head >= KBD_RING_SIZE) {
+        // llena: se descarta la tecla y se cuenta (antes era silencioso)
+        keyRing.dropped++;
+        if (!overflowing) {
+            keyRing.overflows++;
+            overflowing = 1;
+        }
+        return;
+    }
+    overflowing = 0;
+
+    keyRing.data[tail & RING_MASK] = c;
+    __atomic_store_n(&keyRing.tail, tail + 1, __ATOMIC_RELEASE);
+    last_key_tsc = rdtsc();
+    sched_wake_all(&keyWaiters);
 }
 
-static void pushKey(char c) {
-    if (!isBufferFull()) {
-        keyBuffer[tail] = c;
-        tail = (tail + 1) % BUFFER_SIZE;
+int keyboard_wait(int64_t timeout_ms) {
+    uint64_t deadline = 0;
+    if (timeout_ms > 0)
+        deadline = rdtsc() + ms_to_cycles(timeout_ms);
+
+    // se evalua con IF=0; sti;hlt no pierde el wake-up porque el IRQ
+    // que llegue entre ambas instrucciones se atiende recien en el hlt.
+    // Con el scheduler la tarea se bloquea y el CPU queda para las demás;
+    // el IRQ1 la despierta (sched_wait vuelve con IF=0).
+    _cli();
+    while (isBufferEmpty()) {
+        uint64_t now = rdtsc();
+        if (timeout_ms == 0 || (timeout_ms > 0 && now >= deadline))
+            return 0;
+        if (sched_active()) {
+            sched_wait(&keyWaiters, timeout_ms > 0 ? ms_to_ticks(cycles_to_ms(deadline - now) + 1) : 0);
+            continue;
+        }
+        _hlt();
+        _cli();
     }
+    return 1;
+}
+
+uint64_t keyboard_last_key_tsc() {
+    return last_key_tsc;
 }
 
 char keyboard_getchar() {
-    if (isBufferEmpty())
-        return 0;
+    uint32_t head = __atomic_load_n(&keyRing.head, __ATOMIC_RELAXED);
+    for (;;) {
+        uint32_t tail = __atomic_load_n(&keyRing.tail, __ATOMIC_ACQUIRE);
+        if (head == tail)
+            return 0;
+
+        char c = keyRing.data[head & RING_MASK];
+        if (__atomic_compare_exchange_n(&keyRing.head, &head, head + 1, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            return c;
+    }
+}
+
+kbd_ring_t * keyboard_get_ring() {
+    return &keyRing;
+}
+
+
+static int isKeyDown(uint8_t keycode) {
+    return (keyState[keycode >> 6] >> (keycode & 63)) & 1;
+}
+
+static void pushEvent(uint8_t keycode, uint8_t pressed, uint64_t tsc) {
+    // las repeticiones automáticas (typematic) no cambian el estado: se descartan
+    if (pressed && isKeyDown(keycode))
+        return;
+
+    if (pressed)
+        keyState[keycode >> 6] |= (1ULL << (keycode & 63));
+    else
+        keyState[keycode >> 6] &= ~(1ULL << (keycode & 63));
 
-    char c = keyBuffer[head];
-    head = (head + 1) % BUFFER_SIZE;
-    return c;
+    int next = (eventTail + 1) % EVENT_BUFFER_SIZE;
+    if (next == eventHead)
+        eventHead = (eventHead + 1) % EVENT_BUFFER_SIZE;   // llena: pisa el más viejo
+    eventBuffer[eventTail].keycode = keycode;
+    eventBuffer[eventTail].pressed = pressed;
+    eventBuffer[eventTail].tsc = tsc;
+    eventTail = next;
 }
 
+int keyboard_get_events(key_event_t *buffer, int max) {
+    int n = 0;
+    while (n < max && eventHead != eventTail) {
+        buffer[n++] = eventBuffer[eventHead];
+        eventHead = (eventHead + 1) % EVENT_BUFFER_SIZE;
+    }
+    return n;
+}
+
+void keyboard_get_state(uint64_t *state) {
+    state[0] = keyState[0];
+    state[1] = keyState[1];
+}
 
 static int shift = 0;   // flags del teclado
 static int capsLock = 0;
 static int ctrlPressed = 0;
 
-void keyboard_handler() {
+void keyboard_handler(void *ctx) {
     uint8_t scancode = inb(0x60);
+    uint64_t tsc = rdtsc();
     char ascii = 0;
 
+    if (scancode == 0xE0) {
+        extendedPrefix = 1;
+        return;
+    }
+
+    uint8_t pressed = !(scancode & 0x80);
+    if (extendedPrefix) {
+        extendedPrefix = 0;
+        uint8_t keycode = extendedKeycode[scancode & 0x7F];
+        if (keycode == KEY_RCTRL)
+            ctrlPressed = pressed;
+        // los shift falsos de PrintScreen (0xE0 0x2A) no tienen keycode
+        if (keycode != 0)
+            pushEvent(keycode, pressed, tsc);
+        // Enter y '/' del keypad siguen generando ASCII
+        if (pressed && keycode == KEY_KP_ENTER)
+            pushKey('\n');
+        else if (pressed && keycode == KEY_KP_SLASH)
+            pushKey('/');
+        return;
+    }
+    pushEvent(scancode & 0x7F, pressed, tsc);
+
     if (scancode == 0x1D){
         ctrlPressed = 1;
     }else if (scancode == 0x9D){
@@ -123,14 +287,14 @@ void keyboard_handler() {
     }
 
     if (ascii != 0) {
+        // en el IRQ solo se captura el estado; el dibujo lo hace kbdview
         if (ctrlPressed && (ascii =='r' || ascii =='R')) {
-            uint64_t *snapshot = get_registers();
-            save_snapshot(snapshot);
-            show_registers();
+            save_snapshot_from_frame(irqFrame);
+            request_view(VIEW_REGS);
             return;
         }
         if (ctrlPressed && (ascii == 'l' || ascii == 'L')) {
-            clearScreen();
+            request_view(VIEW_CLEAR);
             return;
         }
         pushKey(ascii);
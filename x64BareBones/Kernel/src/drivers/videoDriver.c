@@ -1,5 +1,6 @@
 #include <videoDriver.h>
 #include <font.h>
+#include <fpu.h>
 
 #define CHAR_COLOR 0xFFFFFF
 #define CHAR_START_X 10
@@ -75,6 +76,14 @@ uint16_t getScreenHeight() {
     return VBE_mode_info->height;
 }
 
+uint64_t getFramebufferBase() {
+    return VBE_mode_info->framebuffer;
+}
+
+uint64_t getFramebufferSize() {
+    return (uint64_t)VBE_mode_info->pitch * VBE_mode_info->height;
+}
+
 void putPixel(uint32_t hexColor, uint64_t x, uint64_t y) {
     uint8_t * framebuffer = (uint8_t *) VBE_mode_info->framebuffer;
     uint64_t offset = (x * ((VBE_mode_info->bpp)/8)) + (y * VBE_mode_info->pitch);
@@ -115,10 +124,9 @@ void putChar(char c, uint32_t x, uint32_t y, uint32_t color) {
     }
 }
 
-void writeString(const char *str, int len) {
-    if (!str || len <= 0) return;
-
-    for (int i = 0; i < len; i++) {
+// dibuja los caracteres sin tocar el cursor
+static void renderString(const char *str, uint64_t len) {
+    for (uint64_t i = 0; i < len; i++) {
         char c = str[i];
         if (!c) break;
 
@@ -140,7 +148,9 @@ void writeString(const char *str, int len) {
             cursor_x += getFontWidthScaled();
         }
     }
+}
 
+static void redrawCursor(void) {
     // borrar solo la línea del cursor anterior
     drawRect(BACKGROUND_COLOR,
              prev_cx,
@@ -157,6 +167,28 @@ void writeString(const char *str, int len) {
     prev_cx = cursor_x;
     prev_cy = cursor_y;
 }
+
+void writeString(const char *str, int len) {
+    if (!str || len <= 0) return;
+
+    renderString(str, len);
+    redrawCursor();
+}
+
+// escribe varios segmentos en una sola pasada y redibuja el cursor una vez
+uint64_t writeStringv(const iovec_t *iov, int iovcnt) {
+    if (!iov || iovcnt <= 0) return 0;
+
+    uint64_t total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        if (!iov[i].base || iov[i].len == 0) continue;
+        renderString(iov[i].base, iov[i].len);
+        total += iov[i].len;
+    }
+
+    redrawCursor();
+    return total;
+}
 void print_hex64(uint64_t value) {
     char hex[18];        // "0x" + 16 dígitos + '\0'
     hex[0] = '0';
@@ -174,6 +206,15 @@ void drawRect(uint32_t hexColor, uint64_t x, uint64_t y, uint64_t width, uint64_
     uint64_t bytesPerPixel = VBE_mode_info->bpp / 8;
     uint64_t pitch = VBE_mode_info->pitch;
 
+    // 32 bpp: cada fila es un relleno de dwords, con SSE si se puede
+    if (bytesPerPixel == 4 && width * height >= 64 && kernel_fpu_usable()) {
+        kernel_fpu_begin();
+        for (uint64_t i = 0; i < height; i++)
+            simd_fill32(framebuffer + x * 4 + (y + i) * pitch, hexColor, width);
+        kernel_fpu_end();
+        return;
+    }
+
     for (uint64_t i = 0; i < height; i++) {
         for (uint64_t j = 0; j < width; j++) {
             uint64_t offset = (x + j) * bytesPerPixel + (y + i) * pitch;
@@ -189,8 +230,14 @@ void clearScreen() {
     uint64_t screenSize = getScreenWidth() * getScreenHeight();
     uint64_t totalBytes = screenSize * 4;  // 4 bytes por pixel
 
-    for (uint64_t i = 0; i < totalBytes; i++) {
-        framebuffer[i] = 0; // negro absoluto, BGRA = 0x00 0x00 0x00 0x00
+    if (kernel_fpu_usable()) {
+        kernel_fpu_begin();
+        simd_fill32(framebuffer, 0, screenSize);
+        kernel_fpu_end();
+    } else {
+        for (uint64_t i = 0; i < totalBytes; i++) {
+            framebuffer[i] = 0; // negro absoluto, BGRA = 0x00 0x00 0x00 0x00
+        }
     }
     cursor_x = CHAR_START_X;
     cursor_y = CHAR_START_Y;
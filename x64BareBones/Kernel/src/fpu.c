@@ -0,0 +1,160 @@
+#include <stdint.h>
+#include <fpu.h>
+#include <smp.h>
+#include <bench_timer.h>
+
+#define CPUID1_ECX_XSAVE (1 << 26)
+#define CPUID1_ECX_AVX   (1 << 28)
+#define CR4_OSXSAVE      (1 << 18)
+
+#define XCR0_X87 0x1
+#define XCR0_SSE 0x2
+#define XCR0_AVX 0x4
+
+extern void fpu_set_ts(void);
+extern void fpu_clear_ts(void);
+extern void fpu_fninit(void);
+extern void fpu_xsave(void *area, uint64_t mask);
+extern void fpu_xrstor(const void *area, uint64_t mask);
+extern void fpu_fxsave(void *area);
+extern void fpu_fxrstor(const void *area);
+extern uint64_t cpu_read_cr4(void);
+extern void cpu_write_cr4(uint64_t value);
+extern void cpu_xsetbv(uint32_t index, uint64_t value);
+extern uint64_t cpu_save_flags_cli(void);
+extern void cpu_restore_flags(uint64_t flags);
+
+typedef struct {
+    fpu_context_t *owner;       // contexto cuyo estado está en los registros
+    fpu_context_t *current;     // contexto que está corriendo
+    uint64_t xcr0;              // 0 => FXSAVE
+    uint64_t saved_flags;
+    int features;
+    int in_kernel;
+    int ready;
+} fpu_cpu_t;
+
+static fpu_cpu_t fpuCpu[MAX_CPUS];
+static fpu_context_t defaultContext[MAX_CPUS];    // el de userland, uno por CPU
+static fpu_context_t initState;                   // estado recién inicializado
+
+// memcpy/memset se usan antes de clearBSS (loadModules), con el .bss todavía
+// ocupado por los módulos empaquetados: esta marca tiene que vivir en .data
+static volatile int bspReady __attribute__((section(".data"))) = 0;
+
+static void save_state(fpu_cpu_t *c, fpu_context_t *ctx) {
+    if (c->xcr0)
+        fpu_xsave(ctx->area, c->xcr0);
+    else
+        fpu_fxsave(ctx->area);
+    ctx->initialized = 1;
+}
+
+static void restore_state(fpu_cpu_t *c, fpu_context_t *ctx) {
+    const fpu_context_t *src = ctx->initialized ? ctx : &initState;
+    if (c->xcr0)
+        fpu_xrstor(src->area, c->xcr0);
+    else
+        fpu_fxrstor(src->area);
+}
+
+void fpu_init(void) {
+    fpu_cpu_t *c = &fpuCpu[this_cpu()->index];
+    uint32_t eax, ebx, ecx, edx;
+
+    // Pure64 ya dejó CR0.MP, CR4.OSFXSR y CR4.OSXMMEXCPT (init_cpu)
+    cpuid_info(1, &eax, &ebx, &ecx, &edx);
+    c->xcr0 = 0;
+    c->features = 0;
+    if (ecx & CPUID1_ECX_XSAVE) {
+        cpu_write_cr4(cpu_read_cr4() | CR4_OSXSAVE);
+        uint64_t xcr0 = XCR0_X87 | XCR0_SSE;
+        c->features |= FPU_FEATURE_XSAVE;
+
+        if (ecx & CPUID1_ECX_AVX) {
+            // solo si el área x87+SSE+AVX entra en FPU_AREA_SIZE
+            cpu_xsetbv(0, xcr0 | XCR0_AVX);
+            cpuid_info(0xD, &eax, &ebx, &ecx, &edx);
+            if (ebx <= FPU_AREA_SIZE) {
+                xcr0 |= XCR0_AVX;
+                c->features |= FPU_FEATURE_AVX;
+            }
+        }
+        cpu_xsetbv(0, xcr0);
+        c->xcr0 = xcr0;
+    }
+
+    fpu_clear_ts();
+    fpu_fninit();
+    save_state(c, &initState);      // mismo contenido en todos los CPUs
+
+    // los registros ya son del contexto de userland de este CPU
+    c->current = c->owner = &defaultContext[this_cpu()->index];
+    c->in_kernel = 0;
+    c->ready = 1;
+    if (this_cpu()->index == 0)
+        bspReady = 1;
+}
+
+void fpu_switch(fpu_context_t *next) {
+    fpu_cpu_t *c = &fpuCpu[this_cpu()->index];
+    c->current = next;
+    if (c->owner != next)
+        fpu_set_ts();
+}
+
+fpu_context_t *fpu_current(void) {
+    return fpuCpu[this_cpu()->index].current;
+}
+
+void fpu_release(fpu_context_t *ctx) {
+    fpu_cpu_t *c = &fpuCpu[this_cpu()->index];
+    if (ctx == 0 || c->owner != ctx)
+        return;
+    fpu_clear_ts();
+    save_state(c, ctx);
+    c->owner = 0;
+}
+
+void fpu_handle_nm(void) {
+    fpu_cpu_t *c = &fpuCpu[this_cpu()->index];
+    fpu_clear_ts();
+    if (c->owner == c->current)
+        return;
+    if (c->owner)
+        save_state(c, c->owner);
+    restore_state(c, c->current);
+    c->owner = c->current;
+}
+
+int kernel_fpu_usable(void) {
+    // antes de fpu_init en el BSP no hay bloque per-CPU confiable
+    if (!bspReady)
+        return 0;
+    fpu_cpu_t *c = &fpuCpu[this_cpu()->index];
+    return c->ready && !c->in_kernel;
+}
+
+void kernel_fpu_begin(void) {
+    uint64_t flags = cpu_save_flags_cli();
+    fpu_cpu_t *c = &fpuCpu[this_cpu()->index];
+
+    c->saved_flags = flags;
+    c->in_kernel = 1;
+    fpu_clear_ts();
+    if (c->owner) {
+        save_state(c, c->owner);
+        c->owner = 0;
+    }
+}
+
+void kernel_fpu_end(void) {
+    fpu_cpu_t *c = &fpuCpu[this_cpu()->index];
+    c->in_kernel = 0;
+    fpu_set_ts();                   // owner == 0: el contexto vuelve por #NM
+    cpu_restore_flags(c->saved_flags);
+}
+
+int fpu_features(void) {
+    return fpuCpu[this_cpu()->index].features;
+}
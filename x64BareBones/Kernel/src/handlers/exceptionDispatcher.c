@@ -5,12 +5,19 @@
 #include <time.h>
 #include <interrupts.h>
 #include <videoDriver.h>
+#include <keyboardDriver.h>
+#include <paging.h>
+#include <smp.h>
+#include <sched.h>
 
 #define ZERO_EXCEPTION_ID 0
 #define INVALID_OPCODE_ID 6
+#define PAGE_FAULT_ID 14
 
 static void zero_division();
 static void invalid_opcode();
+static void page_fault();
+static void hex64_to_str(uint64_t value, char *out);
 
 extern uint64_t snapshot[];
 
@@ -21,11 +28,18 @@ static const char *regName[21] = {
 };
 
 void exceptionDispatcher(int exception) {
+	// en el idle de un AP (un trabajo de smp_submit) no hay shell al que
+	// volver: la pila base es la de main en el BSP. Se descarta el trabajo.
+	if (this_cpu()->index != 0 && sched_in_idle())
+		smp_abort_work();
+
 	if (exception == ZERO_EXCEPTION_ID)
 		zero_division();
 	else if (exception == INVALID_OPCODE_ID) {
 		invalid_opcode();
 	}
+	else if (exception == PAGE_FAULT_ID)
+		page_fault();
 	//si no por ahora no hace nada
 }
 
@@ -37,13 +51,35 @@ static void invalid_opcode() {
 	printException("Invalid opcode", 15);
 }
 
+static void page_fault() {
+	// CR2 tiene la dirección que paging_handle_fault no resolvió (guardas,
+	// o algo fuera de las regiones de demanda en cero)
+	char msg[32] = "Page fault at 0x";
+	hex64_to_str(cpu_read_cr2(), msg + 16);
+	printException(msg, 32);
+}
+
+static void hex64_to_str(uint64_t value, char *out) {
+    for (int i = 0; i < 16; i++) {
+        int nibble = (value >> ((15 - i) * 4)) & 0xF;
+        out[i] = (nibble < 10) ? ('0' + nibble) : ('A' + (nibble - 10));
+    }
+}
+
 void printException(const char *msg, int len) {
+    // corre sobre la tarea que falló (si estaba dibujando ya tiene el mutex)
+    // y puede venir de adentro de un IRQ: dibuja con IF=0
+    uint64_t flags = video_lock_irqoff();
     clearScreen();
-    writeString("========================================\n\n", 43);
-    
-    writeString("ExceptionType: ", 6);
-    writeString(msg, len);
-    writeString("\n\n", 2);
+
+    iovec_t header[] = {
+        { "========================================\n\n", 42 },
+        { "ExceptionType: ", 15 },
+        { msg, len },
+        { "\n\n", 2 },
+        { "--- Register Dump ---\n", 22 },
+    };
+    writeStringv(header, 5);
 
     static const char *name[21] = {
       "RAX   ","RBX   ","RCX   ","RDX   ","RSI   ","RDI   ","RBP   ",
@@ -51,27 +87,33 @@ void printException(const char *msg, int len) {
       "RSP   ","RIP   ","CS    ","RFLAGS","URSP  ","USS   "
     };
 
-    writeString("--- Register Dump ---\n", 22);
-    
-    // Imprimir en columnas de 2 para mejor legibilidad
+    // Imprimir en columnas de 2 para mejor legibilidad, una escritura por línea
+    char hex[2][16];
+    iovec_t line[8];
+    int n = 0;
     for (int i = 0; i < 21; i++) {
-        writeString(name[i], 6);
-        writeString(": 0x", 4);
-        print_hex64(snapshot[i]);
-        
-        if (i % 2 == 1) {
-            writeString("\n", 1);
+        int col = i % 2;
+        hex64_to_str(snapshot[i], hex[col]);
+        line[n++] = (iovec_t){ name[i], 6 };
+        line[n++] = (iovec_t){ ": 0x", 4 };
+        line[n++] = (iovec_t){ hex[col], 16 };
+
+        if (col == 1 || i == 20) {
+            line[n++] = (iovec_t){ "\n", 1 };
+            writeStringv(line, n);
+            n = 0;
         } else {
-            writeString("    ", 4);
+            line[n++] = (iovec_t){ "    ", 4 };
         }
     }
-    
-    if (21 % 2 != 0) writeString("\n", 1);
-    
+
     writeString("\n========================================\n", 42);
-	_sti();
 	writeString("Press any key to return to shell...\n", 36);
+	video_unlock(flags);
 	
-    while (keyboard_getchar() == 0); // Espera a que el usuario presione una tecla
+    keyboard_wait(KBD_WAIT_FOREVER); // Duerme hasta que el usuario presione una tecla
+    keyboard_getchar();
+	flags = video_lock_irqoff();
     clearScreen();
+	video_unlock(flags);
 }
\ No newline at end of file
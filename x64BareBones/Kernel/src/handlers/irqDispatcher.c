@@ -1,27 +1,72 @@
-#include <time.h>
 #include <stdint.h>
+#include <irq.h>
+#include <apic.h>
 
-static void int_20();
-
-void irqDispatcher(uint64_t irq) {
-	//putPixel(0x00FF0000, 200, 200); //este si
-	switch (irq) {
-		case 0:
-			int_20();
-			break;
-		case 1:
-			//putPixel(0x00FF0000, 20, 20); //este no
-			keyboard_handler();
-			break;
-		
-	}
-	return;
+extern uint64_t cpu_save_flags_cli(void);
+extern void cpu_restore_flags(uint64_t flags);
+
+typedef struct irq_node {
+    irq_handler_t fn;
+    void *ctx;
+    struct irq_node *next;
+} irq_node_t;
+
+static irq_node_t *chains[256];
+static irq_node_t pool[IRQ_NODE_POOL];
+static irq_node_t *freeNodes = 0;
+static int poolUsed = 0;
+
+static irq_node_t *alloc_node(void) {
+    if (freeNodes) {
+        irq_node_t *n = freeNodes;
+        freeNodes = n->next;
+        return n;
+    }
+    return poolUsed < IRQ_NODE_POOL ? &pool[poolUsed++] : 0;
+}
+
+int irq_register(uint8_t vector, irq_handler_t fn, void *ctx) {
+    if (vector < IRQ_BASE_VECTOR || vector >= IRQ_BASE_VECTOR + IRQ_STUBS || fn == 0)
+        return 0;
+
+    uint64_t flags = cpu_save_flags_cli();
+    irq_node_t *node = alloc_node();
+    if (node == 0) {
+        cpu_restore_flags(flags);
+        return 0;
+    }
+    node->fn = fn;
+    node->ctx = ctx;
+    node->next = 0;
+
+    irq_node_t **tail = &chains[vector];
+    while (*tail)
+        tail = &(*tail)->next;
+    *tail = node;
+    cpu_restore_flags(flags);
+
+    if (vector < IRQ_BASE_VECTOR + IRQ_ISA_LINES)
+        irq_enable_line(vector - IRQ_BASE_VECTOR);
+    return 1;
 }
 
-void int_20() {
-	timer_handler();
+int irq_unregister(uint8_t vector, irq_handler_t fn, void *ctx) {
+    uint64_t flags = cpu_save_flags_cli();
+    for (irq_node_t **p = &chains[vector]; *p; p = &(*p)->next) {
+        irq_node_t *node = *p;
+        if (node->fn == fn && node->ctx == ctx) {
+            *p = node->next;
+            node->next = freeNodes;
+            freeNodes = node;
+            cpu_restore_flags(flags);
+            return 1;
+        }
+    }
+    cpu_restore_flags(flags);
+    return 0;
 }
 
-void int_21() {
-    keyboard_handler();
+void irqDispatcher(uint64_t vector) {
+    for (irq_node_t *n = chains[vector & 0xFF]; n; n = n->next)
+        n->fn(n->ctx);
 }
@@ -4,6 +4,18 @@
 #include <time.h>
 #include <registers.h>
 #include <bench_timer.h>
+#include <apic.h>
+#include <smp.h>
+#include <taskpool.h>
+#include <irqstats.h>
+#include <profiler.h>
+#include <tscsync.h>
+#include <pmm.h>
+#include <slab.h>
+#include <uheap.h>
+#include <paging.h>
+#include <lib.h>
+#include <sched.h>
 
 //llamado desde interrupts.asm, que es llamado desde wrapper de syscall en userland
 uint64_t syscallDispatcher(uint64_t syscall_number, uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4, uint64_t arg5) {
@@ -20,7 +32,7 @@ uint64_t syscallDispatcher(uint64_t syscall_number, uint64_t arg1, uint64_t arg2
             sleep(arg1);
             return 0;
         case 4:
-            drawRect((uint32_t)arg1, arg2, arg3, arg4, arg5);
+            syscall_draw_rect((uint32_t)arg1, arg2, arg3, arg4, arg5);
             return 0;
         case 5:
             return get_ticks();
@@ -37,8 +49,8 @@ uint64_t syscallDispatcher(uint64_t syscall_number, uint64_t arg1, uint64_t arg2
             change_font_size((int)arg1);
             return 0;
         case 10:
-            // Leer TSC
-            return rdtsc();
+            // Leer TSC (corregido por el offset del core)
+            return tsc_now();
         case 11:
             // Obtener frecuencia TSC en Hz
             return get_tsc_frequency();
@@ -56,7 +68,127 @@ uint64_t syscallDispatcher(uint64_t syscall_number, uint64_t arg1, uint64_t arg2
             return has_invariant_tsc();
         case 16:
             // putChar - dibujar un carácter en posición específica
-            putChar((char)arg1, (uint32_t)arg2, (uint32_t)arg3, (uint32_t)arg4);
+            syscall_put_char((char)arg1, (uint32_t)arg2, (uint32_t)arg3, (uint32_t)arg4);
+            return 0;
+        case 17:
+            // writev - varios segmentos (ptr, len) en una sola entrada al kernel
+            return syscall_writev((const iovec_t *)arg1, (int)arg2);
+        case 18:
+            // read bloqueante: timeout en ms (0 = no bloquea, -1 = sin limite)
+            return sys_read_timeout((int)arg1, (char *)arg2, (int)arg3, (int64_t)arg4);
+        case 19:
+            // TSC en el que el IRQ de teclado encoló la última tecla
+            return keyboard_last_key_tsc();
+        case 20:
+            // eventos make/break con timestamp TSC
+            return keyboard_get_events((key_event_t *)arg1, (int)arg2);
+        case 21:
+            // bitmap de 128 bits con las teclas presionadas
+            keyboard_get_state((uint64_t *)arg1);
+            return 0;
+        case 22:
+            // página de la ring de teclado (se lee desde userland sin syscalls)
+            return (uint64_t)keyboard_get_ring();
+        case 23:
+            // controlador de IRQs: 0 = PIC, 1 = APIC, -1 = consultar
+            return irq_set_mode((int)arg1);
+        case 24:
+            // CPUs que el kernel trajo de Pure64 (índice 0 = BSP)
+            return smp_get_cpus((cpu_info_t *)arg1, (int)arg2);
+        case 25:
+            // fn(start, end, arg) repartido entre todos los CPUs (work stealing)
+            return parallel_for(arg1, arg2, arg3, (range_fn)arg4, (void *)arg5);
+        case 26:
+            // contadores del pool por CPU
+            return taskpool_get_stats((taskpool_stats_t *)arg1, (int)arg2);
+        case 27:
+            // contadores e histogramas por vector de la IDT
+            return irq_stats_get((irq_stat_t *)arg1, (int)arg2);
+        case 28:
+            // profiler: 1 = arrancar (devuelve CPUs muestreados), 0 = parar (devuelve muestras)
+            return arg1 ? (uint64_t)profiler_start() : profiler_stop();
+        case 29:
+            // funciones con más muestras
+            return profiler_report((profile_entry_t *)arg1, (int)arg2);
+        case 30:
+            // latencia ida y vuelta de smp_call_function hacia cada AP
+            return smp_call_benchmark((ipi_latency_t *)arg1, (int)arg2, (int)arg3);
+        case 31:
+            // offsets y warps del TSC medidos al arrancar
+            return tsc_sync_get((tsc_sync_t *)arg1, (int)arg2);
+        case 32:
+            // estado del allocator de páginas físicas
+            pmm_get_stats((page_stats_t *)arg1);
+            return 0;
+        case 33:
+            // contadores de los cachés de objetos (slab)
+            return kmem_get_stats((kmem_stats_t *)arg1, (int)arg2);
+        case 34:
+            // ciclos por par alloc/free
+            kmem_benchmark((kmem_bench_t *)arg1, (int)arg2);
+            return 0;
+        case 35:
+            // sbrk: mueve el break del heap de userland, devuelve el anterior
+            return uheap_sbrk((int64_t)arg1);
+        case 36:
+            // mmap: bloque de páginas en cero (hasta 2 MiB)
+            return (uint64_t)uheap_mmap(arg1);
+        case 37:
+            // munmap
+            uheap_munmap((void *)arg1, arg2);
+            return 0;
+        case 38:
+            // mapa de las tablas de páginas y entradas de TLB
+            paging_get_info((paging_info_t *)arg1);
+            return 0;
+        case 39:
+            // cambia el tamaño de página del mapeo (benchmarks), devuelve el modo activo
+            return (uint64_t)(int64_t)paging_set_mode((int)arg1);
+        case 40:
+            // ancho de banda de memcpy/memset por rutina y tamaño, sobre un buffer de userland
+            mem_benchmark((mem_bench_t *)arg1, (void *)arg2, arg3);
+            return 0;
+        case 41:
+            // deja [arg1, arg2) leyendo cero, de demanda si se puede (.bss de userland)
+            return (uint64_t)paging_demand_zero(arg1, arg2, "user bss");
+        case 42:
+            // tarea nueva que corre fn(arg) en su propia pila; devuelve el id o -1
+            return (uint64_t)(int64_t)sched_create_user((task_entry_t)arg1, arg2, (const char *)arg3);
+        case 43:
+            sched_exit();
+        case 44:
+            sched_yield();
+            return 0;
+        case 45:
+            // dormir la tarea actual arg1 ms (redondeado a ticks del timer)
+            sched_sleep(ms_to_ticks(arg1));
+            return 0;
+        case 46:
+            return sched_kill((int)arg1);
+        case 47:
+            // listado de tareas con su estado y tiempo de CPU
+            return sched_get_tasks((task_info_t *)arg1, (int)arg2);
+        case 48:
+            // quantum en ticks del timer (<= 0 consulta)
+            return sched_set_quantum((int)arg1);
+        case 49:
+            return sched_current_id();
+        case 50:
+            // máscara de CPUs de una tarea (0 consulta); devuelve la anterior
+            return sched_set_affinity((int)arg1, (uint32_t)arg2);
+        case 51:
+            return sched_get_cpu_stats((sched_cpu_stats_t *)arg1, (int)arg2);
+        case 52:
+            // clase de una tarea: 0 normal, 1..15 tiempo real con período en ms
+            return sched_set_rt((int)arg1, (int)arg2, (uint32_t)arg3);
+        case 53:
+            return sched_frame((int)arg1);
+        case 54:
+            // lock del malloc de userland
+            uheap_lock();
+            return 0;
+        case 55:
+            uheap_unlock();
             return 0;
         default:
             return -1;
@@ -2,6 +2,13 @@
 #include <idtLoader.h>
 #include <defs.h>
 #include <interrupts.h>
+#include <apic.h>
+#include <smp.h>
+#include <profiler.h>
+#include <irq.h>
+#include <time.h>
+#include <keyboardDriver.h>
+#include <sched.h>
 
 #pragma pack(push)		/* Push de la alineacion actual */
 #pragma pack (1) 		/* Alinear las siguiente estructuras a 1 byte */
@@ -23,16 +30,28 @@ static void setup_IDT_entry (int index, uint64_t offset);
 
 void load_idt() {
 
-  setup_IDT_entry (0x20, (uint64_t)&_irq00Handler);
-  setup_IDT_entry(0x21, (uint64_t)&_irq01Handler); // Teclado
+  // un stub por vector 0x20-0x3F; cada driver se registra con irq_register
+  for (int i = 0; i < IRQ_STUBS; i++)
+    setup_IDT_entry(IRQ_BASE_VECTOR + i, irqStubTable[i]);
 
   setup_IDT_entry (0x00, (uint64_t)&_exception0Handler);
   setup_IDT_entry(0x06, (uint64_t)&_exception6Handler);
+  setup_IDT_entry(0x07, (uint64_t)&_exception7Handler); // #NM: FPU perezosa
+  setup_IDT_entry(0x0E, (uint64_t)&_exception14Handler); // #PF: páginas guarda
 
   setup_IDT_entry(0x80, (uint64_t)&_int80Handler);
+  setup_IDT_entry(SCHED_YIELD_VECTOR, (uint64_t)&_schedYieldHandler);
+  setup_IDT_entry(APIC_SPURIOUS_VECTOR, (uint64_t)&_spuriousHandler);
+  setup_IDT_entry(SMP_START_VECTOR, (uint64_t)&_apStartHandler);
+  setup_IDT_entry(SMP_WAKE_VECTOR, (uint64_t)&_apWakeHandler);
+  setup_IDT_entry(SMP_CALL_VECTOR, (uint64_t)&_smpCallHandler);
+  setup_IDT_entry(PROFILE_VECTOR, (uint64_t)&_profileTimerHandler);
 
-  picMasterMask(0xFC); //Habilita IRQ0 y IRQ1 (timer y teclado)
+  picMasterMask(0xFF); // todo enmascarado: irq_register habilita cada línea
 	picSlaveMask(0xFF);
+
+  irq_register(IRQ_VECTOR(0), timer_handler, 0);
+  irq_register(IRQ_VECTOR(1), keyboard_handler, 0);
         
 	_sti();
 }
@@ -0,0 +1,41 @@
+#include <stdint.h>
+#include <irqstats.h>
+#include <bench_timer.h>
+
+static irq_stat_t stats[256];
+
+static int log2_bucket(uint64_t cycles) {
+    int k = 0;
+    while (cycles >>= 1)
+        k++;
+    return k < IRQSTAT_BUCKETS ? k : IRQSTAT_BUCKETS - 1;
+}
+
+void irq_stats_record(uint64_t vector, uint64_t entry_tsc) {
+    uint64_t cycles = rdtsc() - entry_tsc;
+    irq_stat_t *s = &stats[vector & 0xFF];
+
+    // el vector de despertar llega a varios APs a la vez: todo atómico
+    __atomic_add_fetch(&s->count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s->total_cycles, cycles, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s->hist[log2_bucket(cycles)], 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&s->last_tsc, entry_tsc, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&s->max_cycles, __ATOMIC_RELAXED);
+    while (cycles > max &&
+           !__atomic_compare_exchange_n(&s->max_cycles, &max, cycles, 0,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+int irq_stats_get(irq_stat_t *out, int max) {
+    int n = 0;
+    for (int v = 0; v < 256 && n < max; v++) {
+        if (stats[v].count == 0)
+            continue;
+        out[n] = stats[v];
+        out[n].vector = v;
+        n++;
+    }
+    return n;
+}
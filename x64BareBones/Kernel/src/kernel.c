@@ -6,11 +6,23 @@
 #include <bench_timer.h>
 #include "interrupts.h"
 #include "videoDriver.h"
+#include <apic.h>
+#include <smp.h>
+#include <tscsync.h>
+#include <symbols.h>
+#include <fpu.h>
+#include <pmm.h>
+#include <slab.h>
+#include <uheap.h>
+#include <paging.h>
+#include <sched.h>
+#include <keyboardDriver.h>
 
 extern uint8_t text;
 extern uint8_t rodata;
 extern uint8_t data;
 extern uint8_t bss;
+extern uint8_t lazyBss;
 extern uint8_t endOfKernelBinary;
 extern uint8_t endOfKernel;
 extern void _irq01Handler();
@@ -19,6 +31,7 @@ static const uint64_t PageSize = 0x1000;
 
 static void * const sampleCodeModuleAddress = (void*)0x400000;
 static void * const sampleDataModuleAddress = (void*)0x500000;
+static void * const symbolTableModuleAddress = (void*)0x600000;
 
 typedef int (*EntryPoint)();
 
@@ -52,10 +65,11 @@ void * initializeKernelBinary()
 	ncNewline();
 	void * moduleAddresses[] = {
 		sampleCodeModuleAddress,
-		sampleDataModuleAddress
+		sampleDataModuleAddress,
+		symbolTableModuleAddress
 	};
 
-	loadModules(&endOfKernelBinary, moduleAddresses);
+	void * modulesEnd = loadModules(&endOfKernelBinary, moduleAddresses);
 	ncPrint("[Done]");
 	ncNewline();
 	ncNewline();
@@ -63,7 +77,11 @@ void * initializeKernelBinary()
 	ncPrint("[Initializing kernel's binary]");
 	ncNewline();
 
-	clearBSS(&bss, &endOfKernel - &bss);
+	// .bss.lazy (buffers grandes que nada usa antes de paging_init) queda de
+	// demanda en cero: se limpia recién la página que se toca
+	clearBSS(&bss, &lazyBss - &bss);
+	if (!paging_add_lazy((uint64_t)&lazyBss, (uint64_t)&endOfKernel, PageSize, "kernel bss"))
+		clearBSS(&lazyBss, &endOfKernel - &lazyBss);
 
 	ncPrint("  text: 0x");
 	ncPrintHex((uint64_t)&text);
@@ -76,18 +94,106 @@ void * initializeKernelBinary()
 	ncNewline();
 	ncPrint("  bss: 0x");
 	ncPrintHex((uint64_t)&bss);
+	ncPrint("  lazy: 0x");
+	ncPrintHex((uint64_t)&lazyBss);
 	ncNewline();
 
+	// Tabla de símbolos para el profiler (módulo generado de los link maps);
+	// va después de clearBSS porque el índice vive en .bss
+	ncPrint("  symbols: ");
+	ncPrintDec(symbols_init((char *)symbolTableModuleAddress));
+	ncNewline();
+
+	// Memoria física: todo lo usable del E820 menos lo que ya está ocupado.
+	// El .bss de userland se asume dentro de su ventana (antes del módulo de datos).
+	pmm_reserve(0, 0x100000, "boot/BIOS");
+	pmm_reserve((uint64_t)&text, (uint64_t)getStackBase() + sizeof(uint64_t), "kernel");
+	pmm_reserve((uint64_t)sampleCodeModuleAddress, (uint64_t)modulesEnd, "modules");
+	pmm_reserve(getFramebufferBase(), getFramebufferBase() + getFramebufferSize(), "framebuffer");
+	ncPrint("  user heap: ");
+	ncPrintDec(uheap_init() >> 20);
+	ncPrint(" MiB");
+	ncNewline();
+	ncPrint("  free pages: ");
+	ncPrintDec(pmm_init());
+	ncNewline();
+	kmem_init();
+
 	ncPrint("[Done]");
 	ncNewline();
 	ncNewline();
 	return getStackBase();
 }
 
+// Mapa de las tablas de páginas y cuánto cubre la TLB con cada tamaño
+static void printPagingReport(void) {
+	static paging_info_t info;
+	static const char *kindName[PAGE_KINDS] = { "4K", "2M", "1G" };
+	static const char *cacheName[] = { "WB", "WC", "UC", "guard" };
+	// alcance = entradas * tamaño de página, en la unidad de cada tamaño
+	static const uint32_t kindScale[PAGE_KINDS] = { 4, 2, 1 };
+	static const char *kindUnit[PAGE_KINDS] = { " KiB", " MiB", " GiB" };
+
+	paging_get_info(&info);
+	ncPrint("  1G pages: ");
+	ncPrint(info.features & PAGING_FEATURE_1G ? "yes" : "no");
+	ncPrint("  PAT: ");
+	ncPrint(info.features & PAGING_FEATURE_PAT ? "yes" : "no");
+	ncPrint("  table pages: ");
+	ncPrintDec(info.table_pages);
+	ncNewline();
+	for (uint32_t i = 0; i < info.run_count; i++) {
+		ncPrint("  0x");
+		ncPrintHex(info.runs[i].start);
+		ncPrint("-0x");
+		ncPrintHex(info.runs[i].end);
+		ncPrint(" ");
+		ncPrint(kindName[info.runs[i].kind]);
+		ncPrint(" ");
+		ncPrint(cacheName[info.runs[i].cache]);
+		ncNewline();
+	}
+	ncPrint(info.tlb_estimated ? "  TLB reach L1/L2 (estimated):" : "  TLB reach L1/L2:");
+	for (int k = 0; k < PAGE_KINDS; k++) {
+		ncPrint(" ");
+		ncPrint(kindName[k]);
+		ncPrint(" ");
+		ncPrintDec(info.l1_dtlb[k] * kindScale[k]);
+		ncPrint("/");
+		ncPrintDec(info.l2_tlb[k] * kindScale[k]);
+		ncPrint(kindUnit[k]);
+	}
+	ncNewline();
+	for (uint32_t i = 0; i < info.lazy_count; i++) {
+		const lazy_region_info_t *r = &info.lazy[i];
+		ncPrint("  demand-zero ");
+		ncPrint(r->name);
+		ncPrint(" 0x");
+		ncPrintHex(r->start);
+		ncPrint("-0x");
+		ncPrintHex(r->end);
+		ncPrint(r->unit == PageSize ? " 4K " : " 2M ");
+		ncPrintDec(r->touched);
+		ncPrint("/");
+		ncPrintDec((r->end - r->start) / r->unit);
+		ncPrint(" touched");
+		ncNewline();
+	}
+}
+
 int main() {
     load_idt();
     _sti();
 
+	// Enrutar timer y teclado por el IOAPIC si esta disponible (EOI por MMIO)
+	apic_init();
+	if (apic_available() && irq_set_mode(IRQ_MODE_APIC) == IRQ_MODE_APIC) {
+		ncPrint("[IRQs via IOAPIC/LAPIC]");
+	} else {
+		ncPrint("[IRQs via 8259 PIC]");
+	}
+	ncNewline();
+
 	// Calibrar TSC para mediciones de benchmark
 	ncPrint("[Calibrating TSC...]");
 	ncNewline();
@@ -99,6 +205,49 @@ int main() {
 	ncPrint("[TSC Ready]");
 	ncNewline();
 
+	// Traer a los APs de Pure64 al kernel (pila, GDT y bloque per-CPU propios)
+	smp_init();
+	ncPrint("[SMP] CPUs online: ");
+	ncPrintDec(smp_cpu_count());
+	ncNewline();
+
+	// Offset del TSC de cada AP contra el BSP (lo aplica tsc_now)
+	ncPrint("[TSC] max skew: ");
+	ncPrintDec(tsc_sync_init());
+	ncPrint(" cycles");
+	ncNewline();
+
+	// FPU/SSE (y AVX si hay XSAVE) con guardado perezoso del estado
+	fpu_init();
+	ncPrint("[FPU] ");
+	ncPrint(fpu_features() & FPU_FEATURE_XSAVE ? "XSAVE" : "FXSAVE");
+	if (fpu_features() & FPU_FEATURE_AVX)
+		ncPrint(" + AVX");
+	ncNewline();
+
+	// Tablas de páginas propias: 1 GiB donde se pueda, WC para el framebuffer
+	ncPrint("[Paging]");
+	if (paging_init() == 0) {
+		ncPrint(" out of memory, keeping Pure64 tables");
+		ncNewline();
+	} else {
+		ncNewline();
+		printPagingReport();
+	}
+
+	// Tareas: este flujo pasa a ser "main" y el IRQ0 reparte el CPU
+	sched_init();
+	ncPrint("[Scheduler] round robin, quantum ");
+	ncPrintDec(sched_set_quantum(0));
+	ncPrint(" ticks, ");
+	ncPrintDec(smp_cpu_count());
+	ncPrint(" run queues");
+	ncNewline();
+	if (keyboard_start_view_task() < 0) {
+		ncPrint("[Keyboard] no task for Ctrl+R/Ctrl+L");
+		ncNewline();
+	}
+
 	/*
 	char c;
 	int i = 0;
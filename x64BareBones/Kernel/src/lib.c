@@ -1,12 +1,62 @@
 #include <stdint.h>
+#include <lib.h>
+#include <fpu.h>
+#include <bench_timer.h>
+
+// Por debajo de esto no compensa guardar el estado FP de userland
+#define SIMD_MIN_BYTES 256
+// Con ERMS (sin FSRM) el arranque de rep movsb/stosb pesa en bloques chicos
+#define REP_MIN_BYTES  128
+
+#define CPUID7_EBX_ERMS (1u << 9)
+#define CPUID7_EDX_FSRM (1u << 4)
+
+#define BYTE_PATTERN 0x0101010101010101ULL
+
+// Inicializada (queda en .data): memcpy corre en loadModules, antes de clearBSS
+static int memFeatures = -1;
+
+int mem_features(void)
+{
+	if (memFeatures < 0) {
+		uint32_t eax, ebx, ecx, edx;
+		int features = 0;
+
+		cpuid_info(0, &eax, &ebx, &ecx, &edx);
+		if (eax >= 7) {
+			cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
+			if (ebx & CPUID7_EBX_ERMS)
+				features |= MEM_FEATURE_ERMS;
+			if (edx & CPUID7_EDX_FSRM)
+				features |= MEM_FEATURE_FSRM;
+		}
+		memFeatures = features;
+	}
+	return memFeatures;
+}
+
+static void fill_simd(uint8_t *dst, uint8_t chr, uint64_t length)
+{
+	uint64_t dwords = length / 4;
+	kernel_fpu_begin();
+	simd_fill32(dst, chr * 0x01010101u, dwords);
+	kernel_fpu_end();
+	mem_fill_words(dst + dwords * 4, chr * BYTE_PATTERN, length - dwords * 4);
+}
 
 void * memset(void * destination, int32_t c, uint64_t length)
 {
 	uint8_t chr = (uint8_t)c;
-	char * dst = (char*)destination;
+	int features = mem_features();
 
-	while(length--)
-		dst[length] = chr;
+	if (length >= MEM_NT_MIN_BYTES)
+		mem_fill_nt(destination, chr * BYTE_PATTERN, length);
+	else if ((features & MEM_FEATURE_ERMS) && length >= REP_MIN_BYTES)
+		mem_fill_rep(destination, chr, length);
+	else if (length >= SIMD_MIN_BYTES && kernel_fpu_usable())
+		fill_simd(destination, chr, length);
+	else
+		mem_fill_words(destination, chr * BYTE_PATTERN, length);
 
 	return destination;
 }
@@ -14,37 +64,134 @@ void * memset(void * destination, int32_t c, uint64_t length)
 void * memcpy(void * destination, const void * source, uint64_t length)
 {
 	/*
-	* memcpy does not support overlapping buffers, so always do it
-	* forwards. (Don't change this without adjusting memmove.)
-	*
-	* For speedy copying, optimize the common case where both pointers
-	* and the length are word-aligned, and copy word-at-a-time instead
-	* of byte-at-a-time. Otherwise, copy by bytes.
-	*
-	* The alignment logic below should be portable. We rely on
-	* the compiler to be reasonably intelligent about optimizing
-	* the divides and modulos out. Fortunately, it is.
+	* memcpy does not support overlapping buffers. The forward paths
+	* (rep movsb and the word loop) are also what memmove uses when
+	* destination < source, so keep them forward.
 	*/
-	uint64_t i;
+	int features = mem_features();
+
+	if (length >= MEM_NT_MIN_BYTES) {
+		mem_copy_nt(destination, source, length);
+	} else if ((features & MEM_FEATURE_FSRM)
+			   || ((features & MEM_FEATURE_ERMS) && length >= REP_MIN_BYTES)) {
+		mem_copy_rep(destination, source, length);
+	} else if (length >= SIMD_MIN_BYTES && kernel_fpu_usable()) {
+		kernel_fpu_begin();
+		simd_copy(destination, source, length);
+		kernel_fpu_end();
+	} else {
+		mem_copy_words(destination, source, length);
+	}
 
-	if ((uint64_t)destination % sizeof(uint32_t) == 0 &&
-		(uint64_t)source % sizeof(uint32_t) == 0 &&
-		length % sizeof(uint32_t) == 0)
-	{
-		uint32_t *d = (uint32_t *) destination;
-		const uint32_t *s = (const uint32_t *)source;
+	return destination;
+}
 
-		for (i = 0; i < length / sizeof(uint32_t); i++)
-			d[i] = s[i];
+void * memmove(void * destination, const void * source, uint64_t length)
+{
+	uint64_t dst = (uint64_t)destination;
+	uint64_t src = (uint64_t)source;
+
+	if (dst == src || length == 0)
+		return destination;
+	if (dst + length <= src || src + length <= dst)
+		return memcpy(destination, source, length);
+
+	if (dst < src) {
+		// rep movsb copia de a byte hacia adelante aunque se solapen
+		if (mem_features() & MEM_FEATURE_ERMS)
+			mem_copy_rep(destination, source, length);
+		else
+			mem_copy_words(destination, source, length);
+	} else {
+		mem_copy_words_backward(destination, source, length);
 	}
-	else
-	{
-		uint8_t * d = (uint8_t*)destination;
-		const uint8_t * s = (const uint8_t*)source;
+	return destination;
+}
+
+// ----------------------------------------------------------------------------
+// Benchmark: cada rutina por separado, con el destino en la segunda mitad
+// ----------------------------------------------------------------------------
+
+static void copy_bytes(uint8_t *dst, const uint8_t *src, uint64_t length)
+{
+	for (uint64_t i = 0; i < length; i++)
+		dst[i] = src[i];
+}
+
+static void fill_bytes(uint8_t *dst, uint8_t chr, uint64_t length)
+{
+	while (length--)
+		dst[length] = chr;
+}
+
+static int run_copy(int impl, void *dst, const void *src, uint64_t length)
+{
+	switch (impl) {
+	case MEM_IMPL_AUTO:  memcpy(dst, src, length); break;
+	case MEM_IMPL_BYTES: copy_bytes(dst, src, length); break;
+	case MEM_IMPL_WORDS: mem_copy_words(dst, src, length); break;
+	case MEM_IMPL_REP:   mem_copy_rep(dst, src, length); break;
+	case MEM_IMPL_NT:    mem_copy_nt(dst, src, length); break;
+	case MEM_IMPL_SIMD:
+		if (!kernel_fpu_usable())
+			return 0;
+		kernel_fpu_begin();
+		simd_copy(dst, src, length);
+		kernel_fpu_end();
+		break;
+	}
+	return 1;
+}
 
-		for (i = 0; i < length; i++)
-			d[i] = s[i];
+static int run_fill(int impl, void *dst, uint64_t length)
+{
+	switch (impl) {
+	case MEM_IMPL_AUTO:  memset(dst, 0x5A, length); break;
+	case MEM_IMPL_BYTES: fill_bytes(dst, 0x5A, length); break;
+	case MEM_IMPL_WORDS: mem_fill_words(dst, 0x5A * BYTE_PATTERN, length); break;
+	case MEM_IMPL_REP:   mem_fill_rep(dst, 0x5A, length); break;
+	case MEM_IMPL_NT:    mem_fill_nt(dst, 0x5A * BYTE_PATTERN, length); break;
+	case MEM_IMPL_SIMD:
+		if (!kernel_fpu_usable())
+			return 0;
+		fill_simd(dst, 0x5A, length);
+		break;
 	}
+	return 1;
+}
 
-	return destination;
+void mem_benchmark(mem_bench_t *out, void *buf, uint64_t bytes)
+{
+	uint8_t *src = buf;
+	uint8_t *dst = src + bytes / 2;
+
+	out->features = mem_features();
+	out->nt_threshold = MEM_NT_MIN_BYTES;
+	out->count = 0;
+
+	for (uint64_t size = 16; size <= bytes / 2 && out->count < MEM_BENCH_SIZES; size *= 4) {
+		mem_bench_row_t *row = &out->rows[out->count++];
+		uint64_t reps = MEM_BENCH_TRAFFIC / size;
+		if (reps == 0)
+			reps = 1;
+		row->size = size;
+		row->reps = reps;
+
+		for (int impl = 0; impl < MEM_IMPLS; impl++) {
+			row->copy[impl] = row->fill[impl] = 0;
+
+			if (run_copy(impl, dst, src, size)) {
+				uint64_t start = tsc_now();
+				for (uint64_t r = 0; r < reps; r++)
+					run_copy(impl, dst, src, size);
+				row->copy[impl] = tsc_now() - start;
+			}
+			if (run_fill(impl, dst, size)) {
+				uint64_t start = tsc_now();
+				for (uint64_t r = 0; r < reps; r++)
+					run_fill(impl, dst, size);
+				row->fill[impl] = tsc_now() - start;
+			}
+		}
+	}
 }
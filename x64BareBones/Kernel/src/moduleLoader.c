@@ -3,20 +3,22 @@
 #include <moduleLoader.h>
 #include <naiveConsole.h>
 
-static void loadModule(uint8_t ** module, void * targetModuleAddress);
+static void * loadModule(uint8_t ** module, void * targetModuleAddress);
 static uint32_t readUint32(uint8_t ** address);
 
-void loadModules(void * payloadStart, void ** targetModuleAddress)
+void * loadModules(void * payloadStart, void ** targetModuleAddress)
 {
 	int i;
 	uint8_t * currentModule = (uint8_t*)payloadStart;
 	uint32_t moduleCount = readUint32(&currentModule);
+	void * end = 0;
 
 	for (i = 0; i < moduleCount; i++)
-		loadModule(&currentModule, targetModuleAddress[i]);
+		end = loadModule(&currentModule, targetModuleAddress[i]);
+	return end;
 }
 
-static void loadModule(uint8_t ** module, void * targetModuleAddress)
+static void * loadModule(uint8_t ** module, void * targetModuleAddress)
 {
 	uint32_t moduleSize = readUint32(module);
 
@@ -33,6 +35,7 @@ static void loadModule(uint8_t ** module, void * targetModuleAddress)
 
 	ncPrint(" [Done]");
 	ncNewline();
+	return (uint8_t *)targetModuleAddress + moduleSize;
 }
 
 static uint32_t readUint32(uint8_t ** address)
@@ -0,0 +1,564 @@
+#include <stdint.h>
+#include <paging.h>
+#include <pmm.h>
+#include <smp.h>
+#include <lib.h>
+#include <spinlock.h>
+#include <bench_timer.h>
+#include <videoDriver.h>
+
+#define PTE_PRESENT    0x001
+#define PTE_WRITE      0x002
+#define PTE_PWT        0x008
+#define PTE_PCD        0x010
+#define PTE_LARGE      0x080            // PS en PDPTE/PDE
+#define PTE_PAT_4K     0x080            // bit PAT de una PTE de 4 KiB
+#define PTE_PAT_LARGE  0x1000           // bit PAT de una página de 2 MiB / 1 GiB
+#define PTE_ENTRIES    512
+#define PTE_ADDR_MASK  0x000FFFFFFFFFF000ULL
+
+#define PF_PRESENT     0x1              // código de error: la página estaba presente
+
+// PA0-PA3 quedan como al reset (WB, WT, UC-, UC); PA4 pasa a WC
+#define IA32_PAT       0x277
+#define PAT_VALUE      0x0007040100070406ULL
+
+#define CPUID1_EDX_PAT         (1u << 16)
+#define CPUID81_EDX_PDPE1GB    (1u << 26)
+
+// Ventanas para poner en cero una unidad de demanda sin mapearla en su lugar:
+// PDPT[4] -> PD con la PT de las ventanas de 4 KiB en PD[0] (una entrada por
+// CPU) y desde PD[1] una página de 2 MiB por CPU
+#define SCRATCH_BASE   PAGING_LIMIT
+
+// PML4 + PDPT + 4 PD + la PT de los primeros 2 MiB + el heap en 4 KiB (64 MiB)
+// + las ventanas + las PT de las regiones de demanda de 4 KiB
+#define MAX_TABLES     56
+
+typedef struct {
+    uint64_t *pages[MAX_TABLES];        // pages[0] es el PML4
+    int count;
+    uint64_t *scratchPd;
+    uint64_t *scratchPt;
+} table_set_t;
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint64_t unit;
+    uint64_t touched;
+    uint64_t faults;
+    char name[PAGING_LAZY_NAME];
+    uint8_t bitmap[PAGING_LAZY_UNITS / 8];  // 1 = ya en cero y mapeada
+} lazy_region_t;
+
+// Dos juegos: se arma el nuevo, se carga en todos los CPUs y recién ahí se
+// devuelve el viejo al buddy
+static table_set_t sets[2];
+static int active = -1;
+static int mode = PAGING_MODE_DEFAULT;
+static uint32_t features;
+static uint64_t guards[PAGING_MAX_GUARDS];
+static int guardCount;
+static uint64_t smallStart, smallEnd;
+static lazy_region_t lazy[PAGING_MAX_LAZY];
+static int lazyCount;
+// Protege los bitmaps y las entradas de las regiones de demanda
+static spinlock_t lazyLock;
+
+static paging_info_t layout;            // runs y páginas del juego activo
+static uint32_t l1Tlb[PAGE_KINDS];
+static uint32_t l2Tlb[PAGE_KINDS];
+static uint32_t tlbEstimated;
+
+static uint64_t *table_alloc(table_set_t *set) {
+    if (set->count >= MAX_TABLES)
+        return 0;
+    uint64_t *table = page_alloc(0);
+    if (table == 0)
+        return 0;
+    memset(table, 0, PAGE_SIZE);
+    set->pages[set->count++] = table;
+    return table;
+}
+
+static void table_set_free(table_set_t *set) {
+    for (int i = 0; i < set->count; i++)
+        page_free(set->pages[i], 0);
+    set->count = 0;
+}
+
+static int overlaps(uint64_t start, uint64_t end, uint64_t otherStart, uint64_t otherEnd) {
+    return start < otherEnd && otherStart < end;
+}
+
+static int has_guard(uint64_t start, uint64_t end) {
+    for (int i = 0; i < guardCount; i++) {
+        if (overlaps(start, end, guards[i], guards[i] + PAGE_SIZE_2M))
+            return 1;
+    }
+    return 0;
+}
+
+// unit = 0: cualquier región de demanda
+static int has_lazy(uint64_t start, uint64_t end, uint64_t unit) {
+    for (int i = 0; i < lazyCount; i++) {
+        if ((unit == 0 || lazy[i].unit == unit) && overlaps(start, end, lazy[i].start, lazy[i].end))
+            return 1;
+    }
+    return 0;
+}
+
+static lazy_region_t *lazy_find(uint64_t addr) {
+    for (int i = 0; i < lazyCount; i++) {
+        if (addr >= lazy[i].start && addr < lazy[i].end)
+            return &lazy[i];
+    }
+    return 0;
+}
+
+static int lazy_touched(const lazy_region_t *r, uint64_t addr) {
+    uint64_t idx = (addr - r->start) / r->unit;
+    return (r->bitmap[idx / 8] >> (idx % 8)) & 1;
+}
+
+static void lazy_mark(lazy_region_t *r, uint64_t addr, int touched) {
+    uint64_t idx = (addr - r->start) / r->unit;
+    if (touched)
+        r->bitmap[idx / 8] |= (uint8_t)(1 << (idx % 8));
+    else
+        r->bitmap[idx / 8] &= (uint8_t)~(1 << (idx % 8));
+}
+
+// Lo que no es de demanda siempre está presente
+static uint64_t present_bit(uint64_t addr) {
+    lazy_region_t *r = lazy_find(addr);
+    return (r == 0 || lazy_touched(r, addr)) ? PTE_PRESENT : 0;
+}
+
+static int has_framebuffer(uint64_t start, uint64_t end) {
+    uint64_t fb = getFramebufferBase();
+    return fb != 0 && overlaps(start, end, fb, fb + getFramebufferSize());
+}
+
+// Los MTRR siguen mandando: con PAT en WB, lo que el firmware marcó UC queda UC
+static int cache_type(uint64_t start, uint64_t end) {
+    if (has_framebuffer(start, end))
+        return (features & PAGING_FEATURE_PAT) ? PAGE_CACHE_WC : PAGE_CACHE_UC;
+    return pmm_usable_bytes(start, end) ? PAGE_CACHE_WB : PAGE_CACHE_UC;
+}
+
+static uint64_t cache_bits(int cache, int large) {
+    if (cache == PAGE_CACHE_UC)
+        return PTE_PCD | PTE_PWT;
+    if (cache == PAGE_CACHE_WC)
+        return large ? PTE_PAT_LARGE : PTE_PAT_4K;
+    return 0;
+}
+
+static int small_pages(uint64_t start, uint64_t end) {
+    if (start < PAGE_SIZE_2M || has_lazy(start, end, PAGE_SIZE))
+        return 1;
+    return mode == PAGING_MODE_4K_HEAP && overlaps(start, end, smallStart, smallEnd);
+}
+
+// Un GiB va con una sola página si todo tiene el mismo tipo de memoria
+static int gb_uniform(uint64_t base) {
+    uint64_t end = base + PAGE_SIZE_1G;
+    uint64_t ram = pmm_usable_bytes(base, end);
+    if (ram != 0 && ram != PAGE_SIZE_1G)
+        return 0;
+    return !has_guard(base, end) && !has_framebuffer(base, end) && !small_pages(base, end)
+           && !has_lazy(base, end, 0);
+}
+
+static void add_run(paging_info_t *m, uint64_t start, uint64_t size, int kind, int cache) {
+    if (cache != PAGE_CACHE_GUARD)
+        m->pages[kind]++;
+    page_run_t *last = m->run_count ? &m->runs[m->run_count - 1] : 0;
+    if (last && (m->run_count == PAGING_MAX_RUNS
+                 || (last->end == start && last->kind == (uint32_t)kind && last->cache == (uint32_t)cache))) {
+        last->end = start + size;
+        return;
+    }
+    m->runs[m->run_count++] = (page_run_t){ start, start + size, kind, cache };
+}
+
+static int map_small(table_set_t *set, uint64_t *pde, uint64_t base, paging_info_t *m) {
+    uint64_t *pt = table_alloc(set);
+    if (pt == 0)
+        return 0;
+    *pde = (uint64_t)pt | PTE_PRESENT | PTE_WRITE;
+    for (int i = 0; i < PTE_ENTRIES; i++) {
+        uint64_t addr = base + (uint64_t)i * PAGE_SIZE;
+        int cache = cache_type(addr, addr + PAGE_SIZE);
+        pt[i] = addr | present_bit(addr) | PTE_WRITE | cache_bits(cache, 0);
+        add_run(m, addr, PAGE_SIZE, PAGE_KIND_4K, cache);
+    }
+    return 1;
+}
+
+static int map_gb(table_set_t *set, uint64_t *pdpte, uint64_t base, paging_info_t *m) {
+    uint64_t *pd = table_alloc(set);
+    if (pd == 0)
+        return 0;
+    *pdpte = (uint64_t)pd | PTE_PRESENT | PTE_WRITE;
+    for (int i = 0; i < PTE_ENTRIES; i++) {
+        uint64_t addr = base + (uint64_t)i * PAGE_SIZE_2M;
+        uint64_t end = addr + PAGE_SIZE_2M;
+        if (has_guard(addr, end)) {
+            add_run(m, addr, PAGE_SIZE_2M, PAGE_KIND_2M, PAGE_CACHE_GUARD);
+        } else if (small_pages(addr, end)) {
+            if (!map_small(set, &pd[i], addr, m))
+                return 0;
+        } else {
+            int cache = cache_type(addr, end);
+            pd[i] = addr | present_bit(addr) | PTE_WRITE | PTE_LARGE | cache_bits(cache, 1);
+            add_run(m, addr, PAGE_SIZE_2M, PAGE_KIND_2M, cache);
+        }
+    }
+    return 1;
+}
+
+// Arma un mapeo 1:1 completo en set; devuelve el CR3 (0 si no hubo memoria)
+static uint64_t build(table_set_t *set, paging_info_t *m) {
+    uint64_t *pml4 = table_alloc(set);
+    uint64_t *pdpt = table_alloc(set);
+    if (pml4 == 0 || pdpt == 0)
+        return 0;
+    pml4[0] = (uint64_t)pdpt | PTE_PRESENT | PTE_WRITE;
+
+    int use1G = (features & PAGING_FEATURE_1G) && mode == PAGING_MODE_DEFAULT;
+    for (uint64_t gb = 0; gb < PAGING_LIMIT / PAGE_SIZE_1G; gb++) {
+        uint64_t base = gb * PAGE_SIZE_1G;
+        if (use1G && gb_uniform(base)) {
+            int cache = cache_type(base, base + PAGE_SIZE_1G);
+            pdpt[gb] = base | PTE_PRESENT | PTE_WRITE | PTE_LARGE | cache_bits(cache, 1);
+            add_run(m, base, PAGE_SIZE_1G, PAGE_KIND_1G, cache);
+        } else if (!map_gb(set, &pdpt[gb], base, m)) {
+            return 0;
+        }
+    }
+
+    set->scratchPd = table_alloc(set);
+    set->scratchPt = table_alloc(set);
+    if (set->scratchPd == 0 || set->scratchPt == 0)
+        return 0;
+    pdpt[SCRATCH_BASE / PAGE_SIZE_1G] = (uint64_t)set->scratchPd | PTE_PRESENT | PTE_WRITE;
+    set->scratchPd[0] = (uint64_t)set->scratchPt | PTE_PRESENT | PTE_WRITE;
+
+    m->table_pages = set->count;
+    return (uint64_t)pml4;
+}
+
+// En cada CPU: PAT igual en todos (cambiarlo pide vaciar caches) y CR3 nuevo
+static void load_cpu(uint64_t cr3) {
+    if ((features & PAGING_FEATURE_PAT) && cpu_rdmsr(IA32_PAT) != PAT_VALUE) {
+        cpu_wbinvd();
+        cpu_wrmsr(IA32_PAT, PAT_VALUE);
+    }
+    cpu_write_cr3(cr3);
+}
+
+static void flush_tlb(uint64_t arg) {
+    cpu_write_cr3(cpu_read_cr3());
+}
+
+// El juego de tablas que tiene cargado este CPU (durante un rearmado conviven dos)
+static table_set_t *current_set(void) {
+    uint64_t root = cpu_read_cr3() & PTE_ADDR_MASK;
+    for (int i = 0; i < 2; i++) {
+        if (sets[i].count && (uint64_t)sets[i].pages[0] == root)
+            return &sets[i];
+    }
+    return 0;
+}
+
+// Prende o apaga la unidad de addr en set: la PDE si es una página de 2 MiB,
+// las PTE si el PD apunta a una PT (regiones de 4 KiB o el heap en 4K)
+static void map_unit(table_set_t *set, const lazy_region_t *r, uint64_t addr, int present) {
+    uint64_t *pdpt = (uint64_t *)(set->pages[0][0] & PTE_ADDR_MASK);
+    uint64_t *pd = (uint64_t *)(pdpt[addr / PAGE_SIZE_1G] & PTE_ADDR_MASK);
+    uint64_t *entry = &pd[(addr / PAGE_SIZE_2M) % PTE_ENTRIES];
+    uint64_t count = 1;
+
+    if ((*entry & PTE_PRESENT) && !(*entry & PTE_LARGE)) {
+        uint64_t *pt = (uint64_t *)(*entry & PTE_ADDR_MASK);
+        entry = &pt[(addr / PAGE_SIZE) % PTE_ENTRIES];
+        count = r->unit / PAGE_SIZE;
+    }
+    for (uint64_t i = 0; i < count; i++)
+        entry[i] = present ? entry[i] | PTE_PRESENT : entry[i] & ~(uint64_t)PTE_PRESENT;
+}
+
+// Pone en cero la unidad por la ventana de este CPU
+static void zero_unit(table_set_t *set, uint64_t addr, uint64_t unit) {
+    uint32_t cpu = this_cpu()->index;
+    uint64_t *slot;
+    uint64_t window;
+
+    if (unit == PAGE_SIZE) {
+        window = SCRATCH_BASE + cpu * PAGE_SIZE;
+        slot = &set->scratchPt[cpu];
+        *slot = addr | PTE_PRESENT | PTE_WRITE;
+    } else {
+        window = SCRATCH_BASE + (1 + cpu) * PAGE_SIZE_2M;
+        slot = &set->scratchPd[1 + cpu];
+        *slot = addr | PTE_PRESENT | PTE_WRITE | PTE_LARGE;
+    }
+    cpu_invlpg(window);
+    memset((void *)window, 0, unit);
+    *slot = 0;
+    cpu_invlpg(window);
+}
+
+static int rebuild(void) {
+    static paging_info_t next;
+    int slot = active == 0 ? 1 : 0;
+
+    memset(&next, 0, sizeof(next));
+    // Un #PF en otro CPU no puede cambiar los bitmaps mientras se arma
+    uint64_t flags = spin_lock_irqsave(&lazyLock);
+    uint64_t cr3 = build(&sets[slot], &next);
+    spin_unlock_irqrestore(&lazyLock, flags);
+    if (cr3 == 0) {
+        table_set_free(&sets[slot]);
+        return 0;
+    }
+    smp_call_function(SMP_ALL_CPUS, load_cpu, cr3, 1);
+    if (active >= 0)
+        table_set_free(&sets[active]);
+    active = slot;
+    layout = next;
+    return 1;
+}
+
+// Entradas de la dTLB por tamaño de página: hoja 0x18 (Intel), hojas
+// extendidas 0x80000005/6/19 (AMD) o, si no hay ninguna, valores típicos
+static void read_tlb(void) {
+    uint32_t eax, ebx, ecx, edx;
+
+    cpuid_info(0, &eax, &ebx, &ecx, &edx);
+    if (eax >= 0x18) {
+        cpuid_count(0x18, 0, &eax, &ebx, &ecx, &edx);
+        uint32_t subleaves = eax;
+        for (uint32_t sub = 0; sub <= subleaves; sub++) {
+            cpuid_count(0x18, sub, &eax, &ebx, &ecx, &edx);
+            uint32_t type = edx & 0x1F;
+            uint32_t level = (edx >> 5) & 0x7;
+            if (type == 0 || type == 2 || type == 5)    // inválida, instrucciones, stores
+                continue;
+            uint32_t entries = (ebx >> 16) * ecx;
+            uint32_t *dst = level == 1 ? l1Tlb : l2Tlb;
+            if (ebx & 0x1) dst[PAGE_KIND_4K] += entries;
+            if (ebx & 0x2) dst[PAGE_KIND_2M] += entries;
+            if (ebx & 0x8) dst[PAGE_KIND_1G] += entries;
+        }
+    }
+
+    cpuid_info(0x80000000, &eax, &ebx, &ecx, &edx);
+    uint32_t maxExt = eax;
+    if (l1Tlb[PAGE_KIND_4K] == 0 && maxExt >= 0x80000006) {
+        cpuid_info(0x80000005, &eax, &ebx, &ecx, &edx);
+        l1Tlb[PAGE_KIND_4K] = (ebx >> 16) & 0xFF;
+        l1Tlb[PAGE_KIND_2M] = (eax >> 16) & 0xFF;
+        cpuid_info(0x80000006, &eax, &ebx, &ecx, &edx);
+        l2Tlb[PAGE_KIND_4K] = (ebx >> 16) & 0xFFF;
+        l2Tlb[PAGE_KIND_2M] = (eax >> 16) & 0xFFF;
+        if (maxExt >= 0x80000019) {
+            cpuid_info(0x80000019, &eax, &ebx, &ecx, &edx);
+            l1Tlb[PAGE_KIND_1G] = (eax >> 16) & 0xFFF;
+            l2Tlb[PAGE_KIND_1G] = (ebx >> 16) & 0xFFF;
+        }
+    }
+
+    if (l1Tlb[PAGE_KIND_4K] == 0) {
+        static const uint32_t l1[PAGE_KINDS] = { 64, 32, 4 };
+        static const uint32_t l2[PAGE_KINDS] = { 1536, 1536, 16 };
+        for (int k = 0; k < PAGE_KINDS; k++) {
+            l1Tlb[k] = l1[k];
+            l2Tlb[k] = l2[k];
+        }
+        tlbEstimated = 1;
+    }
+}
+
+uint64_t paging_init(void) {
+    uint32_t eax, ebx, ecx, edx;
+
+    cpuid_info(1, &eax, &ebx, &ecx, &edx);
+    if (edx & CPUID1_EDX_PAT)
+        features |= PAGING_FEATURE_PAT;
+    cpuid_info(0x80000000, &eax, &ebx, &ecx, &edx);
+    if (eax >= 0x80000001) {
+        cpuid_info(0x80000001, &eax, &ebx, &ecx, &edx);
+        if (edx & CPUID81_EDX_PDPE1GB)
+            features |= PAGING_FEATURE_1G;
+    }
+    read_tlb();
+
+    if (!rebuild()) {
+        // Sin tablas propias no hay demanda: lo anotado se limpia ya
+        for (int i = 0; i < lazyCount; i++)
+            memset((void *)lazy[i].start, 0, lazy[i].end - lazy[i].start);
+        lazyCount = 0;
+        return 0;
+    }
+    return layout.table_pages;
+}
+
+void paging_add_guard(uint64_t addr) {
+    if (guardCount >= PAGING_MAX_GUARDS)
+        return;
+    guards[guardCount++] = addr & ~(PAGE_SIZE_2M - 1);
+    if (active >= 0)
+        rebuild();
+}
+
+void paging_set_small_range(uint64_t start, uint64_t end) {
+    smallStart = start;
+    smallEnd = end;
+}
+
+int paging_add_lazy(uint64_t start, uint64_t end, uint64_t unit, const char *name) {
+    if (unit != PAGE_SIZE && unit != PAGE_SIZE_2M)
+        return 0;
+    start = (start + unit - 1) & ~(unit - 1);
+    end &= ~(unit - 1);
+    if (end <= start || (end - start) / unit > PAGING_LAZY_UNITS
+        || lazyCount >= PAGING_MAX_LAZY || has_lazy(start, end, 0)
+        || end > PAGING_LIMIT || pmm_usable_bytes(start, end) != end - start)
+        return 0;
+
+    lazy_region_t *r = &lazy[lazyCount];
+    r->start = start;
+    r->end = end;
+    r->unit = unit;
+    r->touched = 0;
+    r->faults = 0;
+    memset(r->bitmap, 0, sizeof(r->bitmap));
+    int i = 0;
+    for (; name[i] && i < PAGING_LAZY_NAME - 1; i++)
+        r->name[i] = name[i];
+    r->name[i] = 0;
+    lazyCount++;
+
+    if (active >= 0 && !rebuild()) {
+        lazyCount--;
+        return 0;
+    }
+    return 1;
+}
+
+int paging_demand_zero(uint64_t start, uint64_t end, const char *name) {
+    uint64_t first = (start + PAGE_SIZE - 1) & ~(uint64_t)(PAGE_SIZE - 1);
+    uint64_t last = end & ~(uint64_t)(PAGE_SIZE - 1);
+
+    if (end <= start)
+        return 0;
+
+    // Misma región otra vez (userland vuelve a arrancar): se descarta lo tocado
+    lazy_region_t *r = lazy_find(first);
+    int lazyNow = r && r->start == first && r->end == last && r->unit == PAGE_SIZE;
+    if (lazyNow)
+        paging_discard(first, last);
+    else if (active >= 0 && last > first)
+        lazyNow = paging_add_lazy(first, last, PAGE_SIZE, name);
+
+    if (!lazyNow) {
+        memset((void *)start, 0, end - start);
+        return 0;
+    }
+    memset((void *)start, 0, first - start);
+    memset((void *)last, 0, end - last);
+    return 1;
+}
+
+void paging_discard(uint64_t start, uint64_t end) {
+    int flush = 0;
+    uint64_t flags = spin_lock_irqsave(&lazyLock);
+
+    for (int i = 0; i < lazyCount; i++) {
+        lazy_region_t *r = &lazy[i];
+        uint64_t from = start > r->start ? start : r->start;
+        uint64_t to = end < r->end ? end : r->end;
+        from = (from + r->unit - 1) & ~(r->unit - 1);
+        to &= ~(r->unit - 1);
+        for (uint64_t addr = from; addr < to; addr += r->unit) {
+            if (!lazy_touched(r, addr))
+                continue;
+            lazy_mark(r, addr, 0);
+            r->touched--;
+            for (int s = 0; s < 2; s++) {
+                if (sets[s].count)
+                    map_unit(&sets[s], r, addr, 0);
+            }
+            flush = 1;
+        }
+    }
+    spin_unlock_irqrestore(&lazyLock, flags);
+
+    if (flush)
+        smp_call_function(SMP_ALL_CPUS, flush_tlb, 0, 1);
+}
+
+int paging_handle_fault(uint64_t error) {
+    uint64_t addr = cpu_read_cr2();
+    if (error & PF_PRESENT)
+        return 0;
+
+    uint64_t flags = spin_lock_irqsave(&lazyLock);
+    table_set_t *set = current_set();
+    lazy_region_t *r = set ? lazy_find(addr) : 0;
+    if (r) {
+        uint64_t unitAddr = addr & ~(r->unit - 1);
+        // Si ya estaba tocada es otro CPU que llegó antes o un juego de
+        // tablas armado antes de tocarla: solo falta mapearla en este
+        if (!lazy_touched(r, unitAddr)) {
+            zero_unit(set, unitAddr, r->unit);
+            lazy_mark(r, unitAddr, 1);
+            r->touched++;
+        }
+        map_unit(set, r, unitAddr, 1);
+        cpu_invlpg(addr);
+        r->faults++;
+    }
+    spin_unlock_irqrestore(&lazyLock, flags);
+    return r != 0;
+}
+
+int paging_set_mode(int newMode) {
+    if (active < 0)
+        return -1;
+    if (newMode < PAGING_MODE_DEFAULT || newMode > PAGING_MODE_4K_HEAP || newMode == mode)
+        return mode;
+
+    int old = mode;
+    mode = newMode;
+    if (!rebuild()) {
+        mode = old;
+        return -1;
+    }
+    return mode;
+}
+
+void paging_get_info(paging_info_t *out) {
+    *out = layout;
+    out->features = features;
+    out->mode = active >= 0 ? mode : -1;
+    out->tlb_estimated = tlbEstimated;
+    for (int k = 0; k < PAGE_KINDS; k++) {
+        out->l1_dtlb[k] = l1Tlb[k];
+        out->l2_tlb[k] = l2Tlb[k];
+    }
+    out->lazy_count = lazyCount;
+    for (int i = 0; i < lazyCount; i++) {
+        lazy_region_info_t *dst = &out->lazy[i];
+        dst->start = lazy[i].start;
+        dst->end = lazy[i].end;
+        dst->unit = lazy[i].unit;
+        dst->touched = lazy[i].touched;
+        dst->faults = lazy[i].faults;
+        memcpy(dst->name, lazy[i].name, PAGING_LAZY_NAME);
+    }
+}
@@ -0,0 +1,277 @@
+#include <stdint.h>
+#include <pmm.h>
+#include <spinlock.h>
+
+// Formato de Pure64 (Bootloader/Pure64/src/init/isa.asm): registros de 32
+// bytes terminados por uno en cero
+#define E820_MAP      ((const e820_entry_t *)0x4000)
+#define E820_MAX      128
+#define E820_USABLE   1
+
+#define PMM_LIMIT     0x100000000ULL    // Pure64 mapea 4 GiB con páginas de 2 MiB
+
+#define FRAME_USED     0
+#define FRAME_FREE     1                // cabeza de un bloque libre de orden frames[].order
+#define FRAME_RESERVED 2
+
+typedef struct {
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+    uint32_t acpi;
+    uint64_t pad;
+} e820_entry_t;
+
+typedef struct {
+    uint8_t state;
+    uint8_t order;
+} frame_t;
+
+// Nodo de lista libre, guardado al principio del bloque libre
+typedef struct free_block {
+    struct free_block *next;
+    struct free_block *prev;
+} free_block_t;
+
+static frame_t *frames;
+static uint64_t frameCount;
+static free_block_t *freeLists[PAGE_ORDERS];
+static page_stats_t stats;
+static spinlock_t pmmLock;
+
+static inline free_block_t *pfn_to_block(uint64_t pfn) {
+    return (free_block_t *)(pfn << PAGE_SHIFT);
+}
+
+static inline uint64_t block_to_pfn(free_block_t *block) {
+    return (uint64_t)block >> PAGE_SHIFT;
+}
+
+static void list_push(uint64_t pfn, unsigned order) {
+    free_block_t *block = pfn_to_block(pfn);
+    block->prev = 0;
+    block->next = freeLists[order];
+    if (block->next)
+        block->next->prev = block;
+    freeLists[order] = block;
+
+    frames[pfn].state = FRAME_FREE;
+    frames[pfn].order = order;
+    stats.free_blocks[order]++;
+    stats.free_pages += 1ULL << order;
+}
+
+static void list_remove(uint64_t pfn, unsigned order) {
+    free_block_t *block = pfn_to_block(pfn);
+    if (block->prev)
+        block->prev->next = block->next;
+    else
+        freeLists[order] = block->next;
+    if (block->next)
+        block->next->prev = block->prev;
+
+    frames[pfn].state = FRAME_USED;
+    stats.free_blocks[order]--;
+    stats.free_pages -= 1ULL << order;
+}
+
+// Junta el bloque con su buddy mientras el buddy esté libre y entero
+static void free_block(uint64_t pfn, unsigned order) {
+    while (order < PAGE_MAX_ORDER) {
+        uint64_t buddy = pfn ^ (1ULL << order);
+        if (buddy + (1ULL << order) > frameCount
+            || frames[buddy].state != FRAME_FREE || frames[buddy].order != order)
+            break;
+        list_remove(buddy, order);
+        pfn &= ~(1ULL << order);
+        order++;
+    }
+    list_push(pfn, order);
+}
+
+void *page_alloc(unsigned order) {
+    if (order > PAGE_MAX_ORDER)
+        return 0;
+
+    uint64_t flags = spin_lock_irqsave(&pmmLock);
+    unsigned o = order;
+    while (o <= PAGE_MAX_ORDER && freeLists[o] == 0)
+        o++;
+    if (o > PAGE_MAX_ORDER) {
+        spin_unlock_irqrestore(&pmmLock, flags);
+        return 0;
+    }
+
+    uint64_t pfn = block_to_pfn(freeLists[o]);
+    list_remove(pfn, o);
+    // la mitad de arriba de cada división vuelve a la lista del orden menor
+    while (o > order) {
+        o--;
+        list_push(pfn + (1ULL << o), o);
+    }
+    frames[pfn].order = order;
+    spin_unlock_irqrestore(&pmmLock, flags);
+    return pfn_to_block(pfn);
+}
+
+void page_free(void *page, unsigned order) {
+    uint64_t pfn = (uint64_t)page >> PAGE_SHIFT;
+    if (page == 0 || order > PAGE_MAX_ORDER || pfn >= frameCount
+        || frames[pfn].state != FRAME_USED)
+        return;
+
+    uint64_t flags = spin_lock_irqsave(&pmmLock);
+    free_block(pfn, order);
+    spin_unlock_irqrestore(&pmmLock, flags);
+}
+
+void pmm_reserve(uint64_t start, uint64_t end, const char *name) {
+    if (stats.reserved_count >= PMM_MAX_RESERVED || end <= start)
+        return;
+
+    mem_region_t *r = &stats.reserved[stats.reserved_count++];
+    r->start = start & ~(uint64_t)(PAGE_SIZE - 1);
+    r->end = (end + PAGE_SIZE - 1) & ~(uint64_t)(PAGE_SIZE - 1);
+    int i = 0;
+    for (; name[i] && i < PMM_NAME_LEN - 1; i++)
+        r->name[i] = name[i];
+    r->name[i] = 0;
+}
+
+// Primer reservado que se pisa con [start, end), el de menor inicio
+static const mem_region_t *first_overlap(uint64_t start, uint64_t end) {
+    const mem_region_t *found = 0;
+    for (uint32_t i = 0; i < stats.reserved_count; i++) {
+        const mem_region_t *r = &stats.reserved[i];
+        if (r->start < end && r->end > start && (found == 0 || r->start < found->start))
+            found = r;
+    }
+    return found;
+}
+
+// Zona usable del E820 recortada a páginas enteras dentro de lo mapeado
+static int usable_range(const e820_entry_t *e, uint64_t *start, uint64_t *end) {
+    if (e->type != E820_USABLE)
+        return 0;
+    uint64_t s = (e->base + PAGE_SIZE - 1) & ~(uint64_t)(PAGE_SIZE - 1);
+    uint64_t t = (e->base + e->length) & ~(uint64_t)(PAGE_SIZE - 1);
+    if (t > PMM_LIMIT)
+        t = PMM_LIMIT;
+    if (s >= t)
+        return 0;
+    *start = s;
+    *end = t;
+    return 1;
+}
+
+uint64_t pmm_usable_bytes(uint64_t start, uint64_t end) {
+    uint64_t covered = 0;
+    for (int i = 0; i < E820_MAX && E820_MAP[i].length != 0; i++) {
+        uint64_t s, t;
+        if (!usable_range(&E820_MAP[i], &s, &t))
+            continue;
+        if (s < start) s = start;
+        if (t > end) t = end;
+        if (s < t)
+            covered += t - s;
+    }
+    return covered;
+}
+
+uint64_t pmm_reserve_anywhere(uint64_t bytes, uint64_t align, const char *name) {
+    if (stats.reserved_count >= PMM_MAX_RESERVED || bytes == 0)
+        return 0;
+    for (int i = 0; i < E820_MAX && E820_MAP[i].length != 0; i++) {
+        uint64_t start, end;
+        if (!usable_range(&E820_MAP[i], &start, &end))
+            continue;
+        uint64_t pos = (start + align - 1) & ~(align - 1);
+        while (pos + bytes <= end) {
+            const mem_region_t *r = first_overlap(pos, pos + bytes);
+            if (r == 0) {
+                pmm_reserve(pos, pos + bytes, name);
+                return pos;
+            }
+            pos = (r->end + align - 1) & ~(align - 1);
+        }
+    }
+    return 0;
+}
+
+// Parte [start, end) en los bloques alineados más grandes posibles
+static void add_free_range(uint64_t start, uint64_t end) {
+    uint64_t pfn = start >> PAGE_SHIFT;
+    uint64_t last = end >> PAGE_SHIFT;
+    while (pfn < last) {
+        unsigned order = PAGE_MAX_ORDER;
+        while ((pfn & ((1ULL << order) - 1)) || pfn + (1ULL << order) > last)
+            order--;
+        frames[pfn].state = FRAME_USED;
+        free_block(pfn, order);
+        pfn += 1ULL << order;
+    }
+}
+
+uint64_t pmm_init(void) {
+    uint64_t top = 0;
+    uint64_t start, end;
+    int i;
+
+    for (i = 0; i < E820_MAX && E820_MAP[i].length != 0; i++) {
+        if (E820_MAP[i].type == E820_USABLE)
+            stats.usable_bytes += E820_MAP[i].length;
+        if (usable_range(&E820_MAP[i], &start, &end) && end > top)
+            top = end;
+    }
+    stats.e820_entries = i;
+
+    frameCount = top >> PAGE_SHIFT;
+    uint64_t mapBytes = (frameCount * sizeof(frame_t) + PAGE_SIZE - 1) & ~(uint64_t)(PAGE_SIZE - 1);
+    uint64_t map = pmm_reserve_anywhere(mapBytes, PAGE_SIZE, "page map");
+    if (map == 0) {
+        frameCount = 0;
+        return 0;
+    }
+    frames = (frame_t *)map;
+    for (uint64_t pfn = 0; pfn < frameCount; pfn++)
+        frames[pfn].state = FRAME_RESERVED;
+
+    for (i = 0; i < E820_MAX && E820_MAP[i].length != 0; i++) {
+        if (!usable_range(&E820_MAP[i], &start, &end))
+            continue;
+        uint64_t pos = start;
+        while (pos < end) {
+            const mem_region_t *r = first_overlap(pos, end);
+            if (r == 0) {
+                add_free_range(pos, end);
+                stats.total_pages += (end - pos) >> PAGE_SHIFT;
+                break;
+            }
+            if (r->start > pos) {
+                add_free_range(pos, r->start);
+                stats.total_pages += (r->start - pos) >> PAGE_SHIFT;
+            }
+            uint64_t skip = r->end < end ? r->end : end;
+            stats.reserved_pages += (skip - (r->start > pos ? r->start : pos)) >> PAGE_SHIFT;
+            pos = skip;
+        }
+    }
+    return stats.free_pages;
+}
+
+void pmm_get_stats(page_stats_t *out) {
+    uint64_t flags = spin_lock_irqsave(&pmmLock);
+    *out = stats;
+    spin_unlock_irqrestore(&pmmLock, flags);
+
+    out->largest_order = (uint32_t)-1;
+    for (int o = PAGE_MAX_ORDER; o >= 0; o--) {
+        if (out->free_blocks[o] != 0) {
+            out->largest_order = o;
+            break;
+        }
+    }
+    uint64_t free2m = out->free_blocks[PAGE_ORDER_2M] << PAGE_ORDER_2M;
+    out->frag_2m_permille = out->free_pages == 0 ? 0
+        : (uint32_t)(1000 - free2m * 1000 / out->free_pages);
+}
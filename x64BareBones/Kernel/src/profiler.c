@@ -0,0 +1,167 @@
+#include <stdint.h>
+#include <profiler.h>
+#include <symbols.h>
+#include <smp.h>
+#include <apic.h>
+#include <paging.h>
+#include <sched.h>
+
+#define FRAME_WINDOW (64 * 1024)    // la cadena de RBP no sale de acá
+
+// Todo lo ejecutable vive debajo de 4 GiB (kernel en 1 MiB, módulo en
+// 4 MiB): las direcciones se guardan en 32 bits para que entren más muestras.
+typedef struct {
+    uint32_t rip;
+    uint16_t cs;
+    uint16_t depth;
+    uint32_t callers[PROFILE_DEPTH];
+} profile_sample_t;
+
+typedef struct {
+    profile_sample_t *buf;
+    uint32_t capacity;
+    volatile uint64_t recorded;     // total; el índice es recorded % capacity
+} profile_ring_t;
+
+// Los buffers grandes son de demanda en cero: sin perfilar no ocupan nada
+static profile_sample_t pool[PROFILE_POOL] LAZY_BSS;
+static profile_ring_t rings[MAX_CPUS];
+static volatile int active = 0;
+
+// contadores por símbolo para el reporte; el último es "[unknown]"
+static uint32_t selfCount[MAX_SYMBOLS + 1] LAZY_BSS;
+static uint32_t totalCount[MAX_SYMBOLS + 1] LAZY_BSS;
+
+void profiler_sample(const interrupt_frame_t *frame) {
+    // el timer es el que le daba los ticks al scheduler: se los sigue dando
+    sched_lapic_tick(PROFILE_HZ);
+    if (!active)
+        return;
+    profile_ring_t *ring = &rings[this_cpu()->index];
+    if (ring->capacity == 0)
+        return;
+
+    profile_sample_t *s = &ring->buf[ring->recorded % ring->capacity];
+    s->rip = (uint32_t)frame->rip;
+    s->cs = (uint16_t)frame->cs;
+
+    // stack walk por frame pointers (el kernel y userland compilan sin -O)
+    uint64_t low = frame->rsp;
+    uint64_t rbp = frame->rbp;
+    int depth = 0;
+    while (depth < PROFILE_DEPTH && rbp >= low && rbp < low + FRAME_WINDOW && (rbp & 7) == 0) {
+        uint64_t *fp = (uint64_t *)rbp;
+        s->callers[depth++] = (uint32_t)fp[1];
+        if (fp[0] <= rbp)
+            break;
+        rbp = fp[0];
+    }
+    s->depth = depth;
+    ring->recorded++;
+}
+
+static void timer_on(uint64_t arg) {
+    lapic_timer_start(PROFILE_VECTOR, PROFILE_HZ);
+}
+
+// En los APs el timer del LAPIC vuelve a ser el tick del scheduler
+static void timer_off(uint64_t arg) {
+    lapic_timer_stop();
+    sched_timer_start();
+}
+
+int profiler_start(void) {
+    if (lapicEoiAddress == 0 || active)
+        return 0;
+
+    int cpus = smp_cpu_count();
+    uint32_t per_cpu = PROFILE_POOL / cpus;
+    for (int i = 0; i < cpus; i++) {
+        rings[i].buf = &pool[i * per_cpu];
+        rings[i].capacity = per_cpu;
+        rings[i].recorded = 0;
+    }
+    active = 1;
+
+    // por IPI: también arranca en los APs que están ocupados
+    return smp_call_function(SMP_ALL_CPUS, timer_on, 0, 1) + 1;
+}
+
+int profiler_active(void) {
+    return active;
+}
+
+uint64_t profiler_stop(void) {
+    if (!active)
+        return 0;
+
+    smp_call_function(SMP_ALL_CPUS, timer_off, 0, 1);
+    active = 0;
+
+    uint64_t total = 0;
+    for (int i = 0; i < smp_cpu_count(); i++)
+        total += rings[i].recorded < rings[i].capacity ? rings[i].recorded : rings[i].capacity;
+    return total;
+}
+
+static int sample_symbol(uint64_t addr) {
+    int i = symbol_index(addr);
+    return i < 0 ? MAX_SYMBOLS : i;
+}
+
+static void count_sample(const profile_sample_t *s) {
+    int seen[PROFILE_DEPTH + 1];
+    int n = 0;
+
+    seen[n++] = sample_symbol(s->rip);
+    selfCount[seen[0]]++;
+    totalCount[seen[0]]++;
+
+    // una función recursiva cuenta una sola vez por muestra
+    for (int d = 0; d < s->depth; d++) {
+        int sym = sample_symbol(s->callers[d]);
+        int dup = 0;
+        for (int j = 0; j < n; j++)
+            dup |= (seen[j] == sym);
+        if (!dup) {
+            seen[n++] = sym;
+            totalCount[sym]++;
+        }
+    }
+}
+
+int profiler_report(profile_entry_t *out, int max) {
+    for (int i = 0; i <= MAX_SYMBOLS; i++)
+        selfCount[i] = totalCount[i] = 0;
+
+    for (int c = 0; c < smp_cpu_count(); c++) {
+        profile_ring_t *ring = &rings[c];
+        uint64_t kept = ring->recorded < ring->capacity ? ring->recorded : ring->capacity;
+        for (uint64_t i = 0; i < kept; i++)
+            count_sample(&ring->buf[i]);
+    }
+
+    int n = 0;
+    while (n < max) {
+        int best = -1;
+        for (int i = 0; i <= MAX_SYMBOLS; i++) {
+            if (selfCount[i] > 0 && (best < 0 || selfCount[i] > selfCount[best]))
+                best = i;
+        }
+        if (best < 0)
+            break;
+
+        const symbol_t *sym = symbol_get(best);
+        const char *name = sym ? sym->name : "[unknown]";
+        int k = 0;
+        for (; k < PROFILE_NAME_LEN - 1 && name[k]; k++)
+            out[n].name[k] = name[k];
+        out[n].name[k] = '\0';
+        out[n].addr = sym ? sym->addr : 0;
+        out[n].self = selfCount[best];
+        out[n].total = totalCount[best];
+        selfCount[best] = 0;
+        n++;
+    }
+    return n;
+}
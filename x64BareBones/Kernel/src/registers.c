@@ -16,6 +16,39 @@ void save_snapshot(const uint64_t *raw)
         saved_registers[i] = raw[ map[i] ];
 }
 
+void save_snapshot_from_frame(const interrupt_frame_t *f)
+{
+    saved_registers[0]  = f->rax;
+    saved_registers[1]  = f->rbx;
+    saved_registers[2]  = f->rcx;
+    saved_registers[3]  = f->rdx;
+    saved_registers[4]  = f->rsi;
+    saved_registers[5]  = f->rdi;
+    saved_registers[6]  = f->rbp;
+    saved_registers[7]  = f->r8;
+    saved_registers[8]  = f->r9;
+    saved_registers[9]  = f->r10;
+    saved_registers[10] = f->r11;
+    saved_registers[11] = f->r12;
+    saved_registers[12] = f->r13;
+    saved_registers[13] = f->r14;
+    saved_registers[14] = f->r15;
+    saved_registers[16] = f->rip;
+    saved_registers[17] = f->cs;
+    saved_registers[18] = f->rflags;
+
+    // mismo criterio que saveSnapshot: URSP/USS solo si venía de ring 3
+    if ((f->cs & 3) == 3) {
+        saved_registers[15] = f->rsp;
+        saved_registers[19] = f->rsp;
+        saved_registers[20] = f->ss;
+    } else {
+        saved_registers[15] = (uint64_t)&f->rsp;
+        saved_registers[19] = 0;
+        saved_registers[20] = 0;
+    }
+}
+
 uint64_t get_saved_registers(uint64_t *dst)
 {
     memcpy((void*)dst, (void*)saved_registers, REG_COUNT * sizeof(uint64_t)); //por ahora imprime basura si no hubo ctrl r
@@ -0,0 +1,1238 @@
+#include <stdint.h>
+#include <sched.h>
+#include <irq.h>
+#include <time.h>
+#include <lib.h>
+#include <spinlock.h>
+#include <bench_timer.h>
+#include <smp.h>
+#include <apic.h>
+#include <profiler.h>
+
+#define KERNEL_CS     0x08
+#define KERNEL_SS     0x10
+#define RFLAGS_IF     0x202                 // IF + el bit 1 reservado
+#define SCHED_AP_HZ   (1000000 / TIMER_TICK_US) // los APs al ritmo del PIT
+
+extern void _hlt(void);
+extern void _cli(void);
+
+// Los tiempos en TSC (wake_tsc, deadline, run_start) se toman con tsc_now():
+// la tarea puede migrar y compararse contra el TSC de otro CPU
+struct task {
+    interrupt_frame_t *frame;               // contexto guardado mientras no corre
+    task_t *next;                           // cola de listas de su CPU
+    task_t *wait_next;                      // cola de espera
+    wait_queue_t *waiting;                  // cola en la que está bloqueada
+    uint8_t *stack;                         // 0 = pila del kernel (main, idle de los APs)
+    fpu_context_t *fpuCtx;                  // &fpu, o el de userland para main
+    uint64_t wake_tick;                     // SLEEPING/BLOCKED; 0 = sin timeout
+    uint64_t wake_tsc;                      // esperando el próximo cuadro
+    kmutex_t *held;                         // kmutex tomados (por next_held)
+    kmutex_t *blocked_on;                   // el que espera tomar
+    uint64_t period;                        // ciclos por cuadro; 0 = sin cuadros
+    uint64_t deadline;                      // fin del cuadro actual (TSC)
+    uint64_t frames;
+    uint64_t missed;
+    uint32_t period_ms;
+    uint64_t run_start;
+    uint64_t switches;
+    uint64_t preemptions;
+    uint64_t migrations;
+    uint64_t cycles;
+    uint32_t id;
+    uint32_t affinity;                      // bit i = puede correr en el CPU i
+    volatile uint8_t state;
+    volatile uint8_t on_cpu;                // su pila está en uso (hasta sched_finish)
+    volatile uint8_t killed;                // sched_kill pendiente
+    uint8_t idle;
+    uint8_t user;                           // corre código de userland (syscall 42)
+    uint8_t cpu;                            // cola a la que pertenece
+    uint8_t pinned;                         // sched_migrate_disable anidados
+    uint8_t prio;                           // la propia
+    uint8_t eff_prio;                       // con la heredada: decide la cola
+    uint8_t qprio;                          // nivel en que está encolada
+    char name[SCHED_NAME_LEN];
+    fpu_context_t fpu;
+};
+
+typedef struct {
+    task_t *head;
+    task_t *tail;
+} task_list_t;
+
+// Una por CPU. El dueño elige la próxima tarea tomando solo este lock; los
+// demás lo toman para encolar (crear, despertar) o para robar. t->cpu solo
+// cambia con la cola de t tomada. Una lista por prioridad; el bit i de levels
+// indica que la i no está vacía.
+typedef struct {
+    spinlock_t lock;
+    uint8_t cpu;
+    volatile uint8_t online;
+    volatile uint8_t needResched;
+    uint8_t prevMigrate;                    // prev ya no puede correr acá
+    uint8_t hrMode;                         // timer a SCHED_FRAME_HZ
+    uint16_t subticks;                      // ticks de cuadro hasta el próximo tick
+    task_t *current;
+    task_t *idle;
+    task_t *prev;                           // la que se dejó, hasta sched_finish
+    task_list_t queue[SCHED_PRIO_LEVELS];
+    volatile uint32_t levels;
+    volatile uint32_t nr_ready;
+    int remaining;
+    uint64_t ticks;
+    uint64_t busy_cycles;
+    uint64_t idle_cycles;
+    uint64_t switches;
+    uint64_t steals;
+} __attribute__((aligned(64))) runqueue_t;
+
+static runqueue_t rqs[MAX_CPUS];
+static task_t tasks[SCHED_MAX_TASKS];
+static spinlock_t tasksLock;                // alta de slots
+static uint32_t nextId;
+static volatile uint32_t onlineMask;
+static volatile uint32_t hrUsers;           // tareas con período
+static int quantum = SCHED_DEFAULT_QUANTUM;
+static int active;
+
+// El scheduler corre siempre con IF=0: alcanza con el spin
+static void lock(spinlock_t *l) {
+    while (__atomic_test_and_set(&l->locked, __ATOMIC_ACQUIRE)) {
+        while (l->locked)
+            __asm__ volatile("pause");
+    }
+}
+
+static void unlock(spinlock_t *l) {
+    __atomic_clear(&l->locked, __ATOMIC_RELEASE);
+}
+
+static runqueue_t *this_rq(void) {
+    return &rqs[this_cpu()->index];
+}
+
+// Siempre en orden de CPU, así dos que se roban entre sí no se traban
+static void double_lock(runqueue_t *a, runqueue_t *b) {
+    if (a->cpu > b->cpu) {
+        runqueue_t *t = a;
+        a = b;
+        b = t;
+    }
+    lock(&a->lock);
+    lock(&b->lock);
+}
+
+static void double_unlock(runqueue_t *a, runqueue_t *b) {
+    unlock(&a->lock);
+    unlock(&b->lock);
+}
+
+static runqueue_t *lock_task_rq(task_t *t) {
+    for (;;) {
+        runqueue_t *rq = &rqs[t->cpu];
+        lock(&rq->lock);
+        if (rq->cpu == t->cpu)
+            return rq;
+        unlock(&rq->lock);
+    }
+}
+
+// Cada tarea va a la lista de su prioridad efectiva
+static void rq_push_back(runqueue_t *rq, task_t *t) {
+    task_list_t *q = &rq->queue[t->eff_prio];
+    t->qprio = t->eff_prio;
+    t->next = 0;
+    if (q->tail)
+        q->tail->next = t;
+    else
+        q->head = t;
+    q->tail = t;
+    rq->levels |= 1u << t->qprio;
+    rq->nr_ready++;
+}
+
+static void rq_push_front(runqueue_t *rq, task_t *t) {
+    task_list_t *q = &rq->queue[t->eff_prio];
+    t->qprio = t->eff_prio;
+    t->next = q->head;
+    q->head = t;
+    if (q->tail == 0)
+        q->tail = t;
+    rq->levels |= 1u << t->qprio;
+    rq->nr_ready++;
+}
+
+static void rq_unlink(runqueue_t *rq, task_t *prev, task_t *t) {
+    task_list_t *q = &rq->queue[t->qprio];
+    if (prev)
+        prev->next = t->next;
+    else
+        q->head = t->next;
+    if (q->tail == t)
+        q->tail = prev;
+    if (q->head == 0)
+        rq->levels &= ~(1u << t->qprio);
+    t->next = 0;
+    rq->nr_ready--;
+}
+
+static int rq_remove(runqueue_t *rq, task_t *t) {
+    task_t *prev = 0;
+    for (task_t *p = rq->queue[t->qprio].head; p; prev = p, p = p->next) {
+        if (p == t) {
+            rq_unlink(rq, prev, t);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int rq_load(runqueue_t *rq) {
+    return rq->nr_ready + (rq->current != rq->idle);
+}
+
+// Prioridad de la mejor lista (-1 si no hay) y de la que corre (-1 si idle)
+static int rq_top(runqueue_t *rq) {
+    uint32_t levels = rq->levels;
+    return levels ? 31 - __builtin_clz(levels) : -1;
+}
+
+static int rq_cur_prio(runqueue_t *rq) {
+    task_t *cur = rq->current;
+    return cur == rq->idle ? -1 : cur->eff_prio;
+}
+
+// Afinidad, CPUs online y sched_migrate_disable
+static int can_run(task_t *t, int cpu) {
+    if (t->pinned)
+        return t->cpu == cpu;
+    return (t->affinity & onlineMask & (1u << cpu)) != 0;
+}
+
+// Primera lista que puede correr acá, de la prioridad más alta; las que no
+// (afinidad cambiada) las lleva sched_finish a otro CPU
+static task_t *rq_pop(runqueue_t *rq) {
+    for (int level = rq_top(rq); level >= 0; level--) {
+        task_t *prev = 0;
+        for (task_t *t = rq->queue[level].head; t; prev = t, t = t->next) {
+            if (can_run(t, rq->cpu)) {
+                rq_unlink(rq, prev, t);
+                return t;
+            }
+        }
+    }
+    return 0;
+}
+
+// CPU permitido menos cargado; a igualdad se queda en prefer
+static int select_cpu(task_t *t, int prefer) {
+    int best = -1, bestLoad = 0;
+    for (int i = 0; i < MAX_CPUS; i++) {
+        if (!(t->affinity & onlineMask & (1u << i)))
+            continue;
+        int load = rq_load(&rqs[i]);
+        if (best < 0 || load < bestLoad || (load == bestLoad && i == prefer)) {
+            best = i;
+            bestLoad = load;
+        }
+    }
+    return best < 0 ? 0 : best;
+}
+
+// Si el dueño de rq está en el hlt de su idle, o en su cola hay una lista que
+// le gana a la que corre, le pide que vuelva a elegir
+static void kick(runqueue_t *rq) {
+    if (rq->current != rq->idle && rq_top(rq) <= rq_cur_prio(rq))
+        return;
+    rq->needResched = 1;
+    if (rq != this_rq())
+        lapic_send_ipi(smp_cpu(rq->cpu)->apic_id, SMP_WAKE_VECTOR);
+}
+
+static void free_task(task_t *t) {
+    if (t->period)
+        __atomic_sub_fetch(&hrUsers, 1, __ATOMIC_RELAXED);
+    t->period = 0;
+    if (t->stack)
+        page_free(t->stack, TASK_STACK_ORDER);
+    t->stack = 0;
+    __atomic_store_n(&t->state, TASK_FREE, __ATOMIC_RELEASE);
+}
+
+// SLEEPING/BLOCKED -> READY al frente de su lista: quien esperaba una tecla
+// no espera además a que pase toda la cola. Le saca el CPU a la que corre si
+// no es de mayor prioridad. Si ya la despertó otro, no hace nada.
+static void make_ready(task_t *t) {
+    runqueue_t *rq = lock_task_rq(t);
+    int woke = 0;
+    if (t->state == TASK_SLEEPING || t->state == TASK_BLOCKED) {
+        t->state = TASK_READY;
+        t->wake_tick = 0;
+        t->wake_tsc = 0;
+        rq_push_front(rq, t);
+        if (t->eff_prio >= rq_cur_prio(rq))
+            rq->needResched = 1;
+        woke = 1;
+    }
+    unlock(&rq->lock);
+    if (woke)
+        kick(rq);
+}
+
+// Con la cola de t tomada: si está lista cambia de lista. Si es la que corre
+// y bajó, o si una lista pasó a ganarle a la que corre, toca volver a elegir.
+static void set_eff_prio(runqueue_t *rq, task_t *t, int prio) {
+    if (t->eff_prio == prio)
+        return;
+    int queued = t->state == TASK_READY && rq_remove(rq, t);
+    t->eff_prio = prio;
+    if (queued)
+        rq_push_back(rq, t);
+    if (rq->current == t ? rq_top(rq) > prio : queued && prio > rq_cur_prio(rq))
+        rq->needResched = 1;
+}
+
+// Lleva t, que no está corriendo, a la cola de un CPU permitido
+static void migrate_task(task_t *t) {
+    for (;;) {
+        runqueue_t *src = &rqs[t->cpu];
+        runqueue_t *dst = &rqs[select_cpu(t, t->cpu)];
+        if (dst == src || t->pinned)
+            return;
+
+        double_lock(src, dst);
+        if (t->cpu != src->cpu) {
+            double_unlock(src, dst);
+            continue;
+        }
+        int queued = t->state == TASK_READY && !t->on_cpu && rq_remove(src, t);
+        if (queued || t->state == TASK_SLEEPING || t->state == TASK_BLOCKED) {
+            t->cpu = dst->cpu;
+            t->migrations++;
+            if (queued)
+                rq_push_back(dst, t);
+        }
+        double_unlock(src, dst);
+        if (queued)
+            kick(dst);
+        return;
+    }
+}
+
+// Trae de la cola más cargada (con al menos minReady listas) la última que
+// pueda correr acá: la que más tardaría en tocarle. run = 1 la deja marcada
+// para correrla ya (sched_switch) y busca desde la prioridad más alta; 0 la
+// encola en rq y se lleva de las de menos prioridad (balanceo).
+static task_t *steal(runqueue_t *rq, uint32_t minReady, int run) {
+    runqueue_t *src = 0;
+    for (int i = 0; i < MAX_CPUS; i++) {
+        runqueue_t *r = &rqs[i];
+        if (r == rq || !r->online || r->nr_ready < minReady)
+            continue;
+        if (src == 0 || r->nr_ready > src->nr_ready)
+            src = r;
+    }
+    if (src == 0)
+        return 0;
+
+    double_lock(rq, src);
+    task_t *found = 0, *foundPrev = 0;
+    for (int i = 0; i < SCHED_PRIO_LEVELS && found == 0; i++) {
+        int level = run ? SCHED_PRIO_LEVELS - 1 - i : i;
+        for (task_t *p = src->queue[level].head, *prev = 0; p; prev = p, p = p->next) {
+            if (!p->on_cpu && !p->killed && !p->pinned && can_run(p, rq->cpu)) {
+                found = p;
+                foundPrev = prev;
+            }
+        }
+    }
+    if (found) {
+        rq_unlink(src, foundPrev, found);
+        found->cpu = rq->cpu;
+        found->migrations++;
+        rq->steals++;
+        if (run) {
+            found->state = TASK_RUNNING;
+            found->on_cpu = 1;
+        } else {
+            rq_push_back(rq, found);
+        }
+    }
+    double_unlock(rq, src);
+    return found;
+}
+
+static void copy_name(char *dst, const char *src) {
+    int i = 0;
+    for (; src && src[i] && i < SCHED_NAME_LEN - 1; i++)
+        dst[i] = src[i];
+    dst[i] = 0;
+}
+
+// Primer "retorno" de una tarea: el frame inicial apunta acá con entry y arg
+// en RDI/RSI, como si la hubiera interrumpido una IRQ
+static void task_start(task_entry_t entry, uint64_t arg) {
+    entry(arg);
+    sched_exit();
+}
+
+// Sale DEAD (todavía sin cola) para que nadie más tome el slot
+static task_t *alloc_task(const char *name) {
+    task_t *found = 0;
+    lock(&tasksLock);
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        task_t *t = &tasks[i];
+        if (t->state != TASK_FREE)
+            continue;
+        memset(t, 0, sizeof(*t));
+        t->state = TASK_DEAD;
+        t->id = nextId++;
+        t->affinity = SMP_ALL_CPUS;
+        t->fpuCtx = &t->fpu;
+        copy_name(t->name, name);
+        found = t;
+        break;
+    }
+    unlock(&tasksLock);
+    return found;
+}
+
+// idle0, idle1...: siempre RUNNING para su CPU, nunca en una cola
+static task_t *alloc_idle(int cpu) {
+    char name[8] = "idle";
+    int n = 4;
+    if (cpu >= 10)
+        name[n++] = '0' + cpu / 10;
+    name[n++] = '0' + cpu % 10;
+    name[n] = 0;
+
+    task_t *t = alloc_task(name);
+    t->idle = 1;
+    t->cpu = cpu;
+    t->affinity = 1u << cpu;
+    return t;
+}
+
+// Pila nueva con un frame de pushState + iretq que arranca en task_start
+static int setup_stack(task_t *t, task_entry_t entry, uint64_t arg) {
+    t->stack = page_alloc(TASK_STACK_ORDER);
+    if (t->stack == 0)
+        return 0;
+
+    uint64_t top = (uint64_t)t->stack + TASK_STACK_SIZE;
+    interrupt_frame_t *frame = (interrupt_frame_t *)(top - 16) - 1;
+    memset(frame, 0, sizeof(*frame));
+    frame->rdi = (uint64_t)entry;
+    frame->rsi = arg;
+    frame->rip = (uint64_t)task_start;
+    frame->cs = KERNEL_CS;
+    frame->rflags = RFLAGS_IF;
+    frame->rsp = top - 8;                   // como recién llamada (RSP + 8 alineado)
+    frame->ss = KERNEL_SS;
+    t->frame = frame;
+    return 1;
+}
+
+static void idle_loop(uint64_t arg) {
+    for (;;) {
+        _cli();
+        if (!sched_run_pending())
+            _hlt();
+    }
+}
+
+// Despierta las vencidas de rq: por ticks del PIT (si no tscOnly) o, las que
+// esperan el próximo cuadro, por TSC
+static void wake_expired(runqueue_t *rq, int tscOnly) {
+    uint64_t now = get_ticks();
+    uint64_t tsc = tsc_now();
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        task_t *t = &tasks[i];
+        if (t->cpu != rq->cpu || (t->state != TASK_SLEEPING && t->state != TASK_BLOCKED))
+            continue;
+        if ((!tscOnly && t->wake_tick != 0 && now >= t->wake_tick)
+            || (t->wake_tsc != 0 && tsc >= t->wake_tsc))
+            make_ready(t);
+    }
+}
+
+// El timer de cuadros es el del LAPIC en modo APIC; en modo PIC (o sin LAPIC)
+// los cuadros irían al tick del PIT y sched_set_rt no acepta períodos
+static int frame_timer_ok(void) {
+    return lapicEoiAddress != 0 && irq_set_mode(IRQ_MODE_QUERY) == IRQ_MODE_APIC;
+}
+
+// Tick de cada CPU (IRQ0 en el BSP, LAPIC en los APs): despierta a los
+// vencidos de su cola, descuenta el quantum y si la cola quedó corta se trae
+// trabajo (cada tick si está ocioso, cada SCHED_BALANCE_TICKS si no)
+static void sched_tick(void *ctx) {
+    runqueue_t *rq = this_rq();
+    if (!rq->online)
+        return;
+
+    // aparecieron o se fueron las tareas con período (el profiler tiene el
+    // timer hasta que lo devuelva)
+    if (rq->hrMode != (hrUsers != 0 && frame_timer_ok()) && !profiler_active())
+        sched_timer_start();
+    wake_expired(rq, 0);
+
+    rq->ticks++;
+    if (rq->current == rq->idle) {
+        if (rq->nr_ready || steal(rq, 1, 0))
+            rq->needResched = 1;
+        return;
+    }
+    if (--rq->remaining <= 0 || this_cpu()->work_fn != 0)
+        rq->needResched = 1;
+    if (rq->ticks % SCHED_BALANCE_TICKS == 0)
+        steal(rq, rq_load(rq) + 1, 0);
+}
+
+// Un tick del timer del LAPIC a hz. Si va más rápido que el tick normal
+// solo despierta a las que esperan un cuadro y cada hz / SCHED_AP_HZ hace el
+// tick (en los APs; el BSP lo tiene por el IRQ0)
+static void lapic_tick(uint32_t hz) {
+    runqueue_t *rq = this_rq();
+    if (!rq->online)
+        return;
+    if (hz > SCHED_AP_HZ) {
+        wake_expired(rq, 1);
+        if (rq->cpu == 0 || ++rq->subticks < hz / SCHED_AP_HZ)
+            return;
+        rq->subticks = 0;
+    } else if (rq->cpu == 0) {
+        return;
+    }
+    sched_tick(0);
+}
+
+// SCHED_TICK_VECTOR: a SCHED_FRAME_HZ en modo cuadros, sino al ritmo del PIT
+static void sched_frame_tick(void *ctx) {
+    lapic_tick(this_rq()->hrMode ? SCHED_FRAME_HZ : SCHED_AP_HZ);
+}
+
+void sched_lapic_tick(uint32_t hz) {
+    if (active)
+        lapic_tick(hz);
+}
+
+static void init_rq(runqueue_t *rq, int cpu, task_t *idle) {
+    rq->cpu = cpu;
+    rq->idle = idle;
+    rq->remaining = quantum;
+}
+
+// En cada AP (por smp_call_function): su idle loop pasa a ser la tarea idle
+// del CPU y el timer del LAPIC le da los ticks
+static void ap_init(uint64_t arg) {
+    int cpu = this_cpu()->index;
+    runqueue_t *rq = &rqs[cpu];
+    task_t *idle = alloc_idle(cpu);
+    if (idle == 0)
+        return;
+
+    idle->fpuCtx = fpu_current();
+    idle->state = TASK_RUNNING;
+    idle->on_cpu = 1;
+    idle->run_start = tsc_now();
+    init_rq(rq, cpu, idle);
+    rq->current = idle;
+
+    sched_timer_start();
+    rq->online = 1;
+    __atomic_or_fetch(&onlineMask, 1u << cpu, __ATOMIC_RELEASE);
+}
+
+void sched_init(void) {
+    task_t *idle = alloc_idle(0);
+    setup_stack(idle, idle_loop, 0);
+    idle->state = TASK_READY;
+
+    task_t *main = alloc_task("main");
+    main->fpuCtx = fpu_current();
+    main->affinity = 1;                     // el shell y las excepciones viven en el BSP
+    main->state = TASK_RUNNING;
+    main->on_cpu = 1;
+    main->run_start = tsc_now();
+    main->switches = 1;
+
+    runqueue_t *rq = &rqs[0];
+    init_rq(rq, 0, idle);
+    rq->current = main;
+    rq->online = 1;
+    onlineMask = 1;
+
+    irq_register(IRQ_VECTOR(0), sched_tick, 0);
+    irq_register(SCHED_TICK_VECTOR, sched_frame_tick, 0);
+    active = 1;
+
+    // de a uno: el primero calibra el timer del LAPIC y los demás lo reusan
+    for (int i = 1; i < smp_cpu_count(); i++)
+        smp_call_function(1u << i, ap_init, 0, 1);
+}
+
+int sched_active(void) {
+    return active;
+}
+
+void sched_timer_start(void) {
+    runqueue_t *rq = this_rq();
+    rq->hrMode = hrUsers != 0 && frame_timer_ok();
+    rq->subticks = 0;
+    if (rq->hrMode)
+        lapic_timer_start(SCHED_TICK_VECTOR, SCHED_FRAME_HZ);
+    else if (rq->cpu != 0)
+        lapic_timer_start(SCHED_TICK_VECTOR, SCHED_AP_HZ);
+    else if (lapicEoiAddress != 0)
+        lapic_timer_stop();
+}
+
+// Con rq tomada. Una que mataron mientras esperaba se deja correr: sale de
+// su cola de espera y termina ella misma (sched_wait); lo mismo si tiene un
+// kmutex, que suelta antes de terminar
+static task_t *pick_next(runqueue_t *rq, task_t *prev) {
+    task_t *t;
+    while ((t = rq_pop(rq)) != 0) {
+        if (!t->killed || t->waiting || t->held) {
+            t->state = TASK_RUNNING;
+            t->on_cpu = 1;
+            return t;
+        }
+        t->state = TASK_DEAD;
+        if (t != prev)
+            free_task(t);                   // prev: la libera sched_finish
+    }
+    return 0;
+}
+
+interrupt_frame_t *sched_switch(interrupt_frame_t *frame) {
+    runqueue_t *rq = this_rq();
+    task_t *prev = rq->current;
+    prev->frame = frame;
+
+    lock(&rq->lock);
+    if (prev->killed && prev->state == TASK_RUNNING && prev->waiting == 0 && prev->held == 0)
+        prev->state = TASK_DEAD;
+    if (prev->state == TASK_RUNNING) {
+        prev->state = TASK_READY;
+        if (!prev->idle)
+            rq_push_back(rq, prev);
+    }
+    rq->prevMigrate = !prev->idle && prev->state != TASK_DEAD && !can_run(prev, rq->cpu);
+    // lo asignado con smp_submit corre en el idle de este CPU: va primero
+    int work = this_cpu()->work_fn != 0;
+    task_t *next = work ? 0 : pick_next(rq, prev);
+    if (next)
+        rq->current = next;
+    unlock(&rq->lock);
+
+    if (next == 0) {
+        next = work ? 0 : steal(rq, 1, 1);
+        if (next == 0) {
+            next = rq->idle;
+            next->state = TASK_RUNNING;
+            next->on_cpu = 1;
+        }
+        lock(&rq->lock);
+        rq->current = next;
+        unlock(&rq->lock);
+    }
+
+    rq->needResched = 0;
+    rq->remaining = quantum;
+    if (next == prev)
+        return frame;
+
+    uint64_t now = tsc_now();
+    uint64_t ran = now - prev->run_start;
+    prev->cycles += ran;
+    if (prev->idle)
+        rq->idle_cycles += ran;
+    else
+        rq->busy_cycles += ran;
+    next->run_start = now;
+    next->switches++;
+    rq->switches++;
+
+    // si prev puede seguir en otro CPU su estado FPU no puede quedar solo en
+    // estos registros
+    if (prev->affinity & ~(1u << rq->cpu))
+        fpu_release(prev->fpuCtx);
+    fpu_switch(next->fpuCtx);
+    rq->prev = prev;
+    return next->frame;
+}
+
+void sched_finish(void) {
+    runqueue_t *rq = this_rq();
+    task_t *prev = rq->prev;
+    if (prev == 0)
+        return;
+    rq->prev = 0;
+
+    if (prev->state == TASK_DEAD) {
+        free_task(prev);
+        return;
+    }
+    __atomic_store_n(&prev->on_cpu, 0, __ATOMIC_RELEASE);
+    if (rq->prevMigrate)
+        migrate_task(prev);
+}
+
+interrupt_frame_t *sched_preempt(interrupt_frame_t *frame) {
+    if (!active)
+        return frame;
+    runqueue_t *rq = this_rq();
+    if (!rq->needResched || !rq->online)
+        return frame;
+    // el idle de un AP en medio de un smp_submit termina ese trabajo primero
+    if (rq->current == rq->idle && this_cpu()->work_fn != 0)
+        return frame;
+    if (rq->current != rq->idle)
+        rq->current->preemptions++;
+    return sched_switch(frame);
+}
+
+int sched_run_pending(void) {
+    if (!active)
+        return 0;
+    runqueue_t *rq = this_rq();
+    if (!rq->online || (rq->nr_ready == 0 && !steal(rq, 1, 0)))
+        return 0;
+    _yield();
+    return 1;
+}
+
+static int create_task(task_entry_t entry, uint64_t arg, const char *name, int user) {
+    if (!active || entry == 0)
+        return -1;
+
+    uint64_t flags = irq_save();
+    task_t *t = alloc_task(name);
+    if (t == 0 || !setup_stack(t, entry, arg)) {
+        if (t)
+            free_task(t);
+        irq_restore(flags);
+        return -1;
+    }
+    t->user = user;
+    int id = t->id;
+    runqueue_t *rq = &rqs[select_cpu(t, this_cpu()->index)];
+    lock(&rq->lock);
+    t->cpu = rq->cpu;
+    t->state = TASK_READY;
+    rq_push_back(rq, t);
+    unlock(&rq->lock);
+    kick(rq);
+    irq_restore(flags);
+    return id;
+}
+
+int sched_create(task_entry_t entry, uint64_t arg, const char *name) {
+    return create_task(entry, arg, name, 0);
+}
+
+int sched_create_user(task_entry_t entry, uint64_t arg, const char *name) {
+    return create_task(entry, arg, name, 1);
+}
+
+void sched_exit(void) {
+    irq_save();
+    runqueue_t *rq = this_rq();
+    lock(&rq->lock);
+    rq->current->state = TASK_DEAD;
+    unlock(&rq->lock);
+    _yield();
+    for (;;)
+        _hlt();                             // no se vuelve a elegir
+}
+
+// Después de un cambio: si la mataron mientras tanto termina acá, salvo que
+// tenga un kmutex (termina al soltarlo)
+static void exit_if_killed(task_t *t) {
+    if (t->killed && t->held == 0)
+        sched_exit();
+}
+
+void sched_yield(void) {
+    uint64_t flags = irq_save();
+    task_t *t = this_rq()->current;
+    _yield();
+    exit_if_killed(t);
+    irq_restore(flags);
+}
+
+void sched_sleep(uint64_t ticks) {
+    if (ticks == 0) {
+        sched_yield();
+        return;
+    }
+    uint64_t flags = irq_save();
+    runqueue_t *rq = this_rq();
+    task_t *t = rq->current;
+    lock(&rq->lock);
+    t->wake_tick = get_ticks() + ticks;
+    t->state = TASK_SLEEPING;
+    unlock(&rq->lock);
+    _yield();
+    exit_if_killed(t);
+    irq_restore(flags);
+}
+
+static void wait_unlink(wait_queue_t *q, task_t *t) {
+    lock(&q->lock);
+    if (t->waiting == q) {
+        for (task_t **p = &q->head; *p; p = &(*p)->wait_next) {
+            if (*p == t) {
+                *p = t->wait_next;
+                break;
+            }
+        }
+        t->waiting = 0;
+    }
+    unlock(&q->lock);
+}
+
+// Con q tomada (la suelta): bloquea la tarea actual en q hasta que la
+// despierten. Orden de locks: primero la cola de espera, después la de listas.
+static void wait_locked(wait_queue_t *q, uint64_t timeout_ticks) {
+    runqueue_t *rq = this_rq();
+    task_t *t = rq->current;
+
+    t->waiting = q;
+    t->wait_next = q->head;
+    q->head = t;
+    lock(&rq->lock);
+    t->wake_tick = timeout_ticks ? get_ticks() + timeout_ticks : 0;
+    t->state = TASK_BLOCKED;
+    unlock(&rq->lock);
+    unlock(&q->lock);
+
+    _yield();
+    // por timeout o sched_kill puede seguir en q
+    wait_unlink(q, t);
+    exit_if_killed(t);
+}
+
+void sched_wait(wait_queue_t *q, uint64_t timeout_ticks) {
+    uint64_t flags = irq_save();
+    lock(&q->lock);
+    wait_locked(q, timeout_ticks);
+    irq_restore(flags);
+}
+
+// Con q tomada: la vacía. Se despierta fuera de su lock: una despertada puede
+// volver a esperar en q desde otro CPU antes de que se termine de recorrer.
+static int take_waiters(wait_queue_t *q, task_t **woken) {
+    int n = 0;
+    for (task_t *t = q->head; t && n < SCHED_MAX_TASKS; t = t->wait_next) {
+        t->waiting = 0;
+        woken[n++] = t;
+    }
+    q->head = 0;
+    return n;
+}
+
+void sched_wake_all(wait_queue_t *q) {
+    task_t *woken[SCHED_MAX_TASKS];
+
+    uint64_t flags = irq_save();
+    lock(&q->lock);
+    int n = take_waiters(q, woken);
+    unlock(&q->lock);
+
+    for (int i = 0; i < n; i++)
+        make_ready(woken[i]);
+    irq_restore(flags);
+}
+
+// Prioridad efectiva de t: la propia o la de la mejor tarea que espera uno de
+// sus kmutex. Se recalcula al soltar uno y al cambiarle la propia.
+static void update_prio(task_t *t) {
+    int prio = t->prio;
+    for (kmutex_t *m = t->held; m; m = m->next_held) {
+        lock(&m->waiters.lock);
+        for (task_t *w = m->waiters.head; w; w = w->wait_next) {
+            if (w->eff_prio > prio)
+                prio = w->eff_prio;
+        }
+        unlock(&m->waiters.lock);
+    }
+    runqueue_t *rq = lock_task_rq(t);
+    set_eff_prio(rq, t, prio);
+    unlock(&rq->lock);
+    kick(rq);
+}
+
+// Con el lock de espera del kmutex que tiene o tomado: sube o hasta prio, y
+// si o a su vez espera otro kmutex, también al dueño de ese
+static void pi_boost(task_t *o, int prio) {
+    for (int depth = 0; o && depth < SCHED_MAX_TASKS; depth++) {
+        runqueue_t *rq = lock_task_rq(o);
+        if (o->eff_prio >= prio) {
+            unlock(&rq->lock);
+            return;
+        }
+        set_eff_prio(rq, o, prio);
+        unlock(&rq->lock);
+        kick(rq);
+        kmutex_t *next = o->blocked_on;
+        o = next ? next->owner : 0;
+    }
+}
+
+void kmutex_lock(kmutex_t *m) {
+    if (!active)
+        return;
+    uint64_t flags = irq_save();
+    task_t *t = this_rq()->current;
+    for (;;) {
+        lock(&m->waiters.lock);
+        if (m->owner == t) {
+            m->depth++;
+            unlock(&m->waiters.lock);
+            break;
+        }
+        if (m->owner == 0) {
+            m->owner = t;
+            m->next_held = t->held;
+            t->held = m;
+            unlock(&m->waiters.lock);
+            break;
+        }
+        // el dueño corre con nuestra prioridad hasta que lo suelte
+        t->blocked_on = m;
+        pi_boost(m->owner, t->eff_prio);
+        wait_locked(&m->waiters, 0);
+        t->blocked_on = 0;
+    }
+    irq_restore(flags);
+}
+
+void kmutex_unlock(kmutex_t *m) {
+    if (!active)
+        return;
+    task_t *woken[SCHED_MAX_TASKS];
+
+    uint64_t flags = irq_save();
+    task_t *t = this_rq()->current;
+    lock(&m->waiters.lock);
+    if (m->owner != t || m->depth > 0) {
+        if (m->owner == t)
+            m->depth--;
+        unlock(&m->waiters.lock);
+        irq_restore(flags);
+        return;
+    }
+    m->owner = 0;
+    for (kmutex_t **p = &t->held; *p; p = &(*p)->next_held) {
+        if (*p == m) {
+            *p = m->next_held;
+            break;
+        }
+    }
+    m->next_held = 0;
+    int n = take_waiters(&m->waiters, woken);
+    unlock(&m->waiters.lock);
+
+    // devuelve lo prestado; quien esperaba y le gana corre ya, no al próximo tick
+    update_prio(t);
+    for (int i = 0; i < n; i++)
+        make_ready(woken[i]);
+    exit_if_killed(t);
+    if (this_rq()->needResched)
+        _yield();
+    irq_restore(flags);
+}
+
+static task_t *find_task(int id) {
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        task_t *t = &tasks[i];
+        if (t->id == (uint32_t)id && t->state != TASK_FREE && t->state != TASK_DEAD)
+            return t;
+    }
+    return 0;
+}
+
+int sched_kill(int id) {
+    uint64_t flags = irq_save();
+    task_t *t = find_task(id);
+    if (t == 0 || t->idle || t->stack == 0) {
+        irq_restore(flags);
+        return 0;
+    }
+
+    runqueue_t *rq = lock_task_rq(t);
+    if (t->id != (uint32_t)id || t->state == TASK_FREE || t->state == TASK_DEAD) {
+        unlock(&rq->lock);
+        irq_restore(flags);
+        return 0;
+    }
+    t->killed = 1;
+    if (rq->current == t) {
+        unlock(&rq->lock);
+        // a sí misma: ya, salvo que tenga un kmutex (termina al soltarlo)
+        if (rq == this_rq() && t->held == 0)
+            sched_exit();
+        rq->needResched = 1;                // termina en su próximo cambio
+    } else if (t->state == TASK_READY && !t->on_cpu && t->waiting == 0 && t->held == 0) {
+        rq_remove(rq, t);
+        t->state = TASK_DEAD;
+        unlock(&rq->lock);
+        free_task(t);
+    } else {
+        unlock(&rq->lock);
+        make_ready(t);                      // durmiendo o esperando: la saca pick_next
+    }
+    irq_restore(flags);
+    return 1;
+}
+
+int sched_set_affinity(int id, uint32_t mask) {
+    uint64_t flags = irq_save();
+    task_t *t = find_task(id);
+    if (t == 0) {
+        irq_restore(flags);
+        return -1;
+    }
+    int old = (int)(t->affinity & onlineMask);
+    if (mask == 0) {
+        irq_restore(flags);
+        return old;
+    }
+    if (t->idle || t->stack == 0 || (mask & onlineMask) == 0) {
+        irq_restore(flags);
+        return -1;
+    }
+
+    t->affinity = mask;
+    for (;;) {
+        runqueue_t *rq = lock_task_rq(t);
+        if (t->id != (uint32_t)id || t->state == TASK_FREE || t->state == TASK_DEAD) {
+            unlock(&rq->lock);
+            break;
+        }
+        if (rq->current == t) {
+            // corriendo: se mueve en su próximo cambio (si es la actual, ya)
+            rq->needResched = 1;
+            unlock(&rq->lock);
+            if (rq == this_rq() && !can_run(t, rq->cpu))
+                _yield();
+            break;
+        }
+        if (t->on_cpu) {                    // a mitad de un cambio
+            unlock(&rq->lock);
+            __asm__ volatile("pause");
+            continue;
+        }
+        unlock(&rq->lock);
+        if (!can_run(t, t->cpu))
+            migrate_task(t);
+        break;
+    }
+    irq_restore(flags);
+    return old;
+}
+
+int sched_set_rt(int id, int prio, uint32_t period_ms) {
+    if (prio < SCHED_PRIO_NORMAL || prio > SCHED_RT_PRIO_MAX)
+        return -1;
+    if (prio == SCHED_PRIO_NORMAL)
+        period_ms = 0;
+    if (period_ms != 0 && !frame_timer_ok())
+        return -1;
+
+    uint64_t flags = irq_save();
+    task_t *t = find_task(id);
+    if (t == 0 || t->idle) {
+        irq_restore(flags);
+        return -1;
+    }
+    int old = t->prio;
+    int hadPeriod = t->period != 0;
+    t->prio = prio;
+    t->period_ms = period_ms;
+    t->period = ms_to_cycles(period_ms);
+    t->deadline = 0;
+    t->frames = 0;
+    t->missed = 0;
+    if (hadPeriod != (t->period != 0)) {
+        __atomic_add_fetch(&hrUsers, t->period ? 1 : -1, __ATOMIC_RELAXED);
+        // este CPU cambia de timer ya; los demás en su próximo tick
+        if (!profiler_active())
+            sched_timer_start();
+    }
+    update_prio(t);
+    irq_restore(flags);
+    return old;
+}
+
+int sched_frame(int mode) {
+    if (!active)
+        return -1;
+    uint64_t flags = irq_save();
+    runqueue_t *rq = this_rq();
+    task_t *t = rq->current;
+    if (t->period == 0) {
+        irq_restore(flags);
+        return -1;
+    }
+
+    uint64_t now = tsc_now();
+    if (mode != SCHED_FRAME_WAIT || t->deadline == 0) {
+        t->deadline = now + t->period;
+        irq_restore(flags);
+        return 0;
+    }
+    t->frames++;
+    if (now > t->deadline) {
+        // se pasó: se cuenta y el próximo cuadro empieza ahora, sin tratar
+        // de recuperar los perdidos
+        t->missed++;
+        t->deadline = now + t->period;
+        irq_restore(flags);
+        return 1;
+    }
+
+    // el cuadro siguiente empieza donde terminaba este
+    lock(&rq->lock);
+    t->wake_tsc = t->deadline;
+    t->state = TASK_SLEEPING;
+    unlock(&rq->lock);
+    t->deadline += t->period;
+    _yield();
+    exit_if_killed(t);
+    irq_restore(flags);
+    return 0;
+}
+
+void sched_migrate_disable(void) {
+    uint64_t flags = irq_save();
+    if (active)
+        this_rq()->current->pinned++;
+    irq_restore(flags);
+}
+
+void sched_migrate_enable(void) {
+    uint64_t flags = irq_save();
+    if (active && this_rq()->current->pinned)
+        this_rq()->current->pinned--;
+    irq_restore(flags);
+}
+
+int sched_set_quantum(int ticks) {
+    if (ticks > 0)
+        quantum = ticks > SCHED_MAX_QUANTUM ? SCHED_MAX_QUANTUM : ticks;
+    return quantum;
+}
+
+int sched_get_tasks(task_info_t *out, int max) {
+    uint64_t flags = irq_save();
+    uint64_t now = tsc_now();
+    int n = 0;
+    for (int i = 0; i < SCHED_MAX_TASKS && n < max; i++) {
+        task_t *t = &tasks[i];
+        if (t->state == TASK_FREE)
+            continue;
+        out[n].id = t->id;
+        out[n].state = t->state;
+        out[n].cpu = t->cpu;
+        out[n].prio = t->prio;
+        out[n].eff_prio = t->eff_prio;
+        out[n].affinity = t->affinity & onlineMask;
+        out[n].period_ms = t->period_ms;
+        out[n].switches = t->switches;
+        out[n].preemptions = t->preemptions;
+        out[n].migrations = t->migrations;
+        out[n].cycles = t->cycles;
+        out[n].frames = t->frames;
+        out[n].missed = t->missed;
+        if (t->state == TASK_RUNNING && now > t->run_start)
+            out[n].cycles += now - t->run_start;
+        memcpy(out[n].name, t->name, SCHED_NAME_LEN);
+        n++;
+    }
+    irq_restore(flags);
+    return n;
+}
+
+int sched_get_cpu_stats(sched_cpu_stats_t *out, int max) {
+    uint64_t flags = irq_save();
+    uint64_t now = tsc_now();
+    int n = 0;
+    for (int i = 0; i < MAX_CPUS && n < max; i++) {
+        runqueue_t *rq = &rqs[i];
+        if (!rq->online)
+            continue;
+        lock(&rq->lock);
+        task_t *cur = rq->current;
+        uint64_t partial = now > cur->run_start ? now - cur->run_start : 0;
+        out[n].cpu = i;
+        out[n].current = cur->id;
+        out[n].ready = rq->nr_ready;
+        out[n].reserved = 0;
+        out[n].busy_cycles = rq->busy_cycles + (cur->idle ? 0 : partial);
+        out[n].idle_cycles = rq->idle_cycles + (cur->idle ? partial : 0);
+        out[n].switches = rq->switches;
+        out[n].steals = rq->steals;
+        unlock(&rq->lock);
+        n++;
+    }
+    irq_restore(flags);
+    return n;
+}
+
+int sched_current_id(void) {
+    if (!active)
+        return -1;
+    uint64_t flags = irq_save();
+    int id = (int)this_rq()->current->id;
+    irq_restore(flags);
+    return id;
+}
+
+int sched_in_idle(void) {
+    if (!active)
+        return 1;
+    runqueue_t *rq = this_rq();
+    return rq->current == rq->idle;
+}
+
+// main vuelve a _start, que limpia el .bss de userland (el heap y sus listas):
+// antes terminan las tareas que corren código de userland. Una que tiene el
+// lock de malloc sigue hasta soltarlo, así que se espera a que no quede ninguna.
+static void reap_user_tasks(void) {
+    for (;;) {
+        int alive = 0;
+        for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+            task_t *t = &tasks[i];
+            if (t->user && t->state != TASK_FREE && t->state != TASK_DEAD) {
+                sched_kill(t->id);
+                alive = 1;
+            }
+        }
+        if (!alive)
+            return;
+        sched_sleep(1);
+    }
+}
+
+void sched_exception(void) {
+    if (!active)
+        return;
+    task_t *t = this_rq()->current;
+    while (t->held)
+        kmutex_unlock(t->held);
+    if (t->stack != 0 && !t->idle)
+        sched_exit();
+    if (!t->idle)
+        reap_user_tasks();
+    // main vuelve al shell en la clase normal: quien la había pasado a tiempo
+    // real (tron) no llegó a devolverla, y su período dejaría el timer rápido
+    if (!t->idle)
+        sched_set_rt(t->id, SCHED_PRIO_NORMAL, 0);
+    // el shell se reinicia sobre la pila del BSP: en un AP nunca
+    if (this_cpu()->index != 0)
+        smp_abort_work();
+}
@@ -0,0 +1,364 @@
+#include <stdint.h>
+#include <slab.h>
+#include <pmm.h>
+#include <smp.h>
+#include <spinlock.h>
+#include <bench_timer.h>
+
+#define KMEM_MAX_EMPTY      1           // slabs vacíos que se guardan antes de devolverlos
+#define KMALLOC_SLAB_ORDER  3           // slabs de kmalloc: 32 KiB, así kfree enmascara siempre igual
+#define KMALLOC_CLASSES     8           // 16, 32, ..., 2048
+#define SLAB_MAGIC          0x534C4142u
+
+typedef struct slab {
+    struct slab *next;
+    struct slab *prev;
+    kmem_cache_t *cache;
+    void *free;                         // primer objeto libre; cada uno apunta al siguiente
+    uint32_t inuse;
+    uint32_t magic;
+} slab_t;
+
+// Un magazine por CPU; solo lo toca su CPU, con interrupciones deshabilitadas
+typedef struct {
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t hits;
+    void *objs[KMEM_MAGAZINE];
+} __attribute__((aligned(64))) magazine_t;
+
+struct kmem_cache {
+    spinlock_t lock;
+    char name[KMEM_NAME_LEN];
+    uint32_t obj_size;
+    uint32_t objs_per_slab;
+    uint32_t slab_order;
+    uint32_t first_offset;              // offset del primer objeto (después del encabezado)
+    uint64_t slab_mask;
+    slab_t *partial;
+    slab_t *full;
+    slab_t *empty;
+    uint32_t slabs;
+    uint32_t empty_count;
+    uint64_t allocs;                    // sin magazines se cuentan acá, bajo el lock
+    uint64_t frees;
+    magazine_t *mags;                   // MAX_CPUS magazines (una página), 0 si no hay
+};
+
+static kmem_cache_t caches[KMEM_MAX_CACHES];
+static int cacheCount = 0;
+static spinlock_t cachesLock;
+static kmem_cache_t *kmallocCaches[KMALLOC_CLASSES];
+static kmem_cache_t *benchCache;
+
+static const char *kmallocNames[KMALLOC_CLASSES] = {
+    "kmalloc-16", "kmalloc-32", "kmalloc-64", "kmalloc-128",
+    "kmalloc-256", "kmalloc-512", "kmalloc-1024", "kmalloc-2048"
+};
+
+static inline int cpu_index(void) {
+    // Antes de smp_init GS no apunta a un bloque per-CPU
+    return smp_cpu_count() ? this_cpu()->index : 0;
+}
+
+static void list_add(slab_t **head, slab_t *slab) {
+    slab->prev = 0;
+    slab->next = *head;
+    if (*head)
+        (*head)->prev = slab;
+    *head = slab;
+}
+
+static void list_del(slab_t **head, slab_t *slab) {
+    if (slab->prev)
+        slab->prev->next = slab->next;
+    else
+        *head = slab->next;
+    if (slab->next)
+        slab->next->prev = slab->prev;
+}
+
+static slab_t *slab_new(kmem_cache_t *cache) {
+    slab_t *slab = page_alloc(cache->slab_order);
+    if (slab == 0)
+        return 0;
+
+    slab->cache = cache;
+    slab->inuse = 0;
+    slab->magic = SLAB_MAGIC;
+    slab->free = 0;
+    // Lista libre en orden de direcciones: el primer alloc usa el primer objeto
+    uint8_t *base = (uint8_t *)slab + cache->first_offset;
+    for (int i = cache->objs_per_slab - 1; i >= 0; i--) {
+        void **obj = (void **)(base + (uint64_t)i * cache->obj_size);
+        *obj = slab->free;
+        slab->free = obj;
+    }
+    cache->slabs++;
+    return slab;
+}
+
+// Con el lock del caché tomado
+static void *slab_get(kmem_cache_t *cache) {
+    slab_t *slab = cache->partial;
+    if (slab == 0) {
+        slab = cache->empty;
+        if (slab) {
+            list_del(&cache->empty, slab);
+            cache->empty_count--;
+        } else if ((slab = slab_new(cache)) == 0) {
+            return 0;
+        }
+        list_add(&cache->partial, slab);
+    }
+
+    void **obj = slab->free;
+    slab->free = *obj;
+    if (++slab->inuse == cache->objs_per_slab) {
+        list_del(&cache->partial, slab);
+        list_add(&cache->full, slab);
+    }
+    return obj;
+}
+
+// Con el lock del caché tomado
+static void slab_put(kmem_cache_t *cache, void *obj) {
+    slab_t *slab = (slab_t *)((uint64_t)obj & cache->slab_mask);
+
+    *(void **)obj = slab->free;
+    slab->free = obj;
+    if (slab->inuse-- == cache->objs_per_slab) {
+        list_del(&cache->full, slab);
+        list_add(&cache->partial, slab);
+    }
+    if (slab->inuse == 0) {
+        list_del(&cache->partial, slab);
+        if (cache->empty_count < KMEM_MAX_EMPTY) {
+            list_add(&cache->empty, slab);
+            cache->empty_count++;
+        } else {
+            cache->slabs--;
+            page_free(slab, cache->slab_order);
+        }
+    }
+}
+
+// Medio magazine desde los slabs (el magazine está vacío)
+static void magazine_refill(kmem_cache_t *cache, magazine_t *mag) {
+    uint64_t flags = spin_lock_irqsave(&cache->lock);
+    while (mag->count < KMEM_MAGAZINE / 2) {
+        void *obj = slab_get(cache);
+        if (obj == 0)
+            break;
+        mag->objs[mag->count++] = obj;
+    }
+    spin_unlock_irqrestore(&cache->lock, flags);
+}
+
+// Medio magazine de vuelta a los slabs (el magazine está lleno)
+static void magazine_flush(kmem_cache_t *cache, magazine_t *mag) {
+    uint64_t flags = spin_lock_irqsave(&cache->lock);
+    while (mag->count > KMEM_MAGAZINE / 2)
+        slab_put(cache, mag->objs[--mag->count]);
+    spin_unlock_irqrestore(&cache->lock, flags);
+}
+
+void *kmem_cache_alloc(kmem_cache_t *cache) {
+    void *obj = 0;
+
+    if (cache->mags) {
+        uint64_t flags = irq_save();
+        magazine_t *mag = &cache->mags[cpu_index()];
+        if (mag->count == 0)
+            magazine_refill(cache, mag);
+        else
+            mag->hits++;
+        if (mag->count != 0) {
+            obj = mag->objs[--mag->count];
+            mag->allocs++;
+        }
+        irq_restore(flags);
+        return obj;
+    }
+
+    uint64_t flags = spin_lock_irqsave(&cache->lock);
+    obj = slab_get(cache);
+    if (obj)
+        cache->allocs++;
+    spin_unlock_irqrestore(&cache->lock, flags);
+    return obj;
+}
+
+void kmem_cache_free(kmem_cache_t *cache, void *obj) {
+    if (obj == 0)
+        return;
+
+    if (cache->mags) {
+        uint64_t flags = irq_save();
+        magazine_t *mag = &cache->mags[cpu_index()];
+        if (mag->count == KMEM_MAGAZINE)
+            magazine_flush(cache, mag);
+        else
+            mag->hits++;
+        mag->objs[mag->count++] = obj;
+        mag->frees++;
+        irq_restore(flags);
+        return;
+    }
+
+    uint64_t flags = spin_lock_irqsave(&cache->lock);
+    slab_put(cache, obj);
+    cache->frees++;
+    spin_unlock_irqrestore(&cache->lock, flags);
+}
+
+static kmem_cache_t *cache_create(const char *name, uint32_t size, uint32_t flags, int fixedOrder) {
+    uint32_t align = (flags & KMEM_CACHE_ALIGN) ? 64 : 8;
+    uint32_t objSize = ((size < 8 ? 8 : size) + align - 1) & ~(align - 1);
+    uint32_t offset = (sizeof(slab_t) + align - 1) & ~(align - 1);
+
+    // el orden más chico con KMEM_MIN_OBJS objetos (o el máximo con al menos uno)
+    uint32_t order = fixedOrder >= 0 ? (uint32_t)fixedOrder : 0;
+    uint32_t objs = ((PAGE_SIZE << order) - offset) / objSize;
+    while (fixedOrder < 0 && objs < KMEM_MIN_OBJS && order < PAGE_MAX_ORDER) {
+        order++;
+        objs = ((PAGE_SIZE << order) - offset) / objSize;
+    }
+    if (objs == 0)
+        return 0;
+
+    magazine_t *mags = 0;
+    if (flags & KMEM_MAGAZINES) {
+        if (sizeof(magazine_t) * MAX_CPUS > PAGE_SIZE || (mags = page_alloc(0)) == 0)
+            return 0;
+        for (int i = 0; i < MAX_CPUS; i++) {
+            mags[i].count = 0;
+            mags[i].allocs = 0;
+            mags[i].frees = 0;
+            mags[i].hits = 0;
+        }
+    }
+
+    uint64_t lockFlags = spin_lock_irqsave(&cachesLock);
+    if (cacheCount == KMEM_MAX_CACHES) {
+        spin_unlock_irqrestore(&cachesLock, lockFlags);
+        if (mags)
+            page_free(mags, 0);
+        return 0;
+    }
+    kmem_cache_t *cache = &caches[cacheCount++];
+    spin_unlock_irqrestore(&cachesLock, lockFlags);
+
+    int i = 0;
+    for (; name[i] && i < KMEM_NAME_LEN - 1; i++)
+        cache->name[i] = name[i];
+    cache->name[i] = 0;
+    cache->obj_size = objSize;
+    cache->objs_per_slab = objs;
+    cache->slab_order = order;
+    cache->first_offset = offset;
+    cache->slab_mask = ~((uint64_t)(PAGE_SIZE << order) - 1);
+    cache->mags = mags;
+    return cache;
+}
+
+kmem_cache_t *kmem_cache_create(const char *name, uint32_t size, uint32_t flags) {
+    return cache_create(name, size, flags, -1);
+}
+
+void kmem_init(void) {
+    for (int i = 0; i < KMALLOC_CLASSES; i++) {
+        kmallocCaches[i] = cache_create(kmallocNames[i], KMALLOC_MIN << i,
+                                        KMEM_MAGAZINES, KMALLOC_SLAB_ORDER);
+    }
+}
+
+void *kmalloc(uint64_t size) {
+    if (size == 0 || size > KMALLOC_MAX)
+        return 0;
+
+    int cls = 0;
+    if (size > KMALLOC_MIN)
+        cls = 64 - __builtin_clzll(size - 1) - 4;     // log2 del tamaño redondeado - log2(16)
+    kmem_cache_t *cache = kmallocCaches[cls];
+    return cache ? kmem_cache_alloc(cache) : 0;
+}
+
+void kfree(void *obj) {
+    if (obj == 0)
+        return;
+    slab_t *slab = (slab_t *)((uint64_t)obj & ~((uint64_t)(PAGE_SIZE << KMALLOC_SLAB_ORDER) - 1));
+    if (slab->magic == SLAB_MAGIC)
+        kmem_cache_free(slab->cache, obj);
+}
+
+int kmem_get_stats(kmem_stats_t *out, int max) {
+    int n = 0;
+    for (; n < cacheCount && n < max; n++) {
+        kmem_cache_t *cache = &caches[n];
+        kmem_stats_t *st = &out[n];
+
+        uint64_t flags = spin_lock_irqsave(&cache->lock);
+        for (int i = 0; i < KMEM_NAME_LEN; i++)
+            st->name[i] = cache->name[i];
+        st->obj_size = cache->obj_size;
+        st->objs_per_slab = cache->objs_per_slab;
+        st->slab_order = cache->slab_order;
+        st->slabs = cache->slabs;
+        st->allocs = cache->allocs;
+        st->frees = cache->frees;
+        st->cached = 0;
+        st->magazine_hits = 0;
+        spin_unlock_irqrestore(&cache->lock, flags);
+
+        // los magazines se leen sin lock: es una foto aproximada
+        for (int c = 0; cache->mags && c < MAX_CPUS; c++) {
+            st->allocs += cache->mags[c].allocs;
+            st->frees += cache->mags[c].frees;
+            st->magazine_hits += cache->mags[c].hits;
+            st->cached += cache->mags[c].count;
+        }
+        st->active = st->allocs - st->frees;
+    }
+    return n;
+}
+
+static uint64_t bench_pairs(kmem_cache_t *cache, int iterations) {
+    uint64_t start = rdtsc();
+    for (int i = 0; i < iterations; i++)
+        kmem_cache_free(cache, kmem_cache_alloc(cache));
+    return (rdtsc() - start) / iterations;
+}
+
+void kmem_benchmark(kmem_bench_t *out, int iterations) {
+    static void *batch[KMEM_BENCH_BATCH];
+    kmem_cache_t *cache = kmallocCaches[2];           // kmalloc-64
+
+    out->magazine_pair = 0;
+    out->slab_pair = 0;
+    out->batch_pair = 0;
+    if (iterations <= 0 || cache == 0)
+        return;
+    if (benchCache == 0)
+        benchCache = kmem_cache_create("bench-64", 64, KMEM_CACHE_ALIGN);
+
+    // primera vuelta para que haya slabs y magazines cargados
+    kmem_cache_free(cache, kmem_cache_alloc(cache));
+    out->magazine_pair = bench_pairs(cache, iterations);
+    if (benchCache)
+        out->slab_pair = bench_pairs(benchCache, iterations);
+
+    int rounds = iterations / KMEM_BENCH_BATCH;
+    if (rounds == 0)
+        rounds = 1;
+    uint64_t start = rdtsc();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < KMEM_BENCH_BATCH; i++)
+            batch[i] = kmem_cache_alloc(cache);
+        for (int i = 0; i < KMEM_BENCH_BATCH; i++)
+            kmem_cache_free(cache, batch[i]);
+    }
+    out->batch_pair = (rdtsc() - start) / ((uint64_t)rounds * KMEM_BENCH_BATCH);
+}
@@ -0,0 +1,273 @@
+#include <stdint.h>
+#include <smp.h>
+#include <apic.h>
+#include <interrupts.h>
+#include <bench_timer.h>
+#include <fpu.h>
+#include <sched.h>
+
+// Variables de sistema de Pure64 (Bootloader/Pure64/src/sysvar.asm)
+#define PURE64_APIC_IDS      ((volatile uint8_t *)0x5100)   // un byte por CPU detectada
+#define PURE64_CPU_ACTIVE    ((volatile uint8_t *)0x5700)   // indexado por APIC ID
+#define PURE64_CPU_DETECTED  (*(volatile uint16_t *)(0x5A00 + 260))
+
+#define AP_START_TIMEOUT_MS 100
+
+#define GDT_CODE64 0x00AF9A000000FFFFULL
+#define GDT_DATA   0x00CF92000000FFFFULL
+
+#pragma pack(push)
+#pragma pack(1)
+typedef struct {
+    uint16_t limit;
+    uint64_t base;
+} descriptor_ptr_t;
+#pragma pack(pop)
+
+extern void cpu_load_gdt(const descriptor_ptr_t *gdtr);
+extern void cpu_load_idt(const descriptor_ptr_t *idtr);
+extern void cpu_set_gs_base(uint64_t base);
+extern void cpu_switch_stack(uint64_t stackTop, void (*fn)(void));
+extern void cpu_pause(void);
+
+// Mailbox de llamadas: mailboxes[destino][origen]. Cada slot tiene un solo
+// productor (el origen) y un solo consumidor (el destino).
+typedef struct {
+    volatile smp_work_fn fn;            // != 0 => llamada pendiente
+    volatile uint64_t arg;
+    volatile uint32_t *remaining;       // 0 si el emisor no espera
+} __attribute__((aligned(64))) call_slot_t;
+
+static call_slot_t mailboxes[MAX_CPUS][MAX_CPUS];
+
+static cpu_t cpus[MAX_CPUS];
+static int cpuCount = 0;
+static uint8_t apStacks[MAX_CPUS][AP_STACK_SIZE] __attribute__((aligned(16)));
+
+// La IDT del kernel vive en 0 (idtLoader.c), 256 entradas de 16 bytes
+static const descriptor_ptr_t kernelIdtr = { 256 * 16 - 1, 0 };
+
+static void setup_cpu_tables(cpu_t *cpu) {
+    descriptor_ptr_t gdtr;
+
+    cpu->gdt[0] = 0;
+    cpu->gdt[1] = GDT_CODE64;
+    cpu->gdt[2] = GDT_DATA;
+    gdtr.limit = sizeof(cpu->gdt) - 1;
+    gdtr.base = (uint64_t)cpu->gdt;
+
+    cpu_load_gdt(&gdtr);
+    cpu_load_idt(&kernelIdtr);
+    cpu_set_gs_base((uint64_t)cpu);    // después de recargar selectores
+}
+
+static void ap_idle_loop(void) {
+    cpu_t *cpu = this_cpu();
+    cpu->online = 1;
+
+    for (;;) {
+        // el chequeo va con IF=0 y _hlt hace sti;hlt: una IPI de despertar
+        // que llegue en el medio se atiende recién en el hlt, no se pierde
+        _cli();
+        smp_work_fn fn = cpu->work_fn;
+        if (fn == 0) {
+            // tareas del scheduler para este CPU (propias o robadas): corren
+            // hasta que la cola se vacía y se vuelve acá
+            if (!sched_run_pending())
+                _hlt();
+            continue;
+        }
+        _sti();
+        fn(cpu->work_arg);
+        cpu->work_done++;
+        __atomic_store_n(&cpu->work_fn, 0, __ATOMIC_RELEASE);
+    }
+}
+
+// Llamado por _apStartHandler sobre la pila de Pure64; no vuelve
+void ap_main(void) {
+    uint8_t id = lapic_id();
+    cpu_t *cpu = 0;
+
+    for (int i = 1; i < cpuCount; i++) {
+        if (cpus[i].apic_id == id) {
+            cpu = &cpus[i];
+            break;
+        }
+    }
+    *lapicEoiAddress = 0;
+    if (cpu == 0)
+        return;                         // no registrado: queda en hlt
+
+    setup_cpu_tables(cpu);
+    fpu_init();
+    cpu_switch_stack(cpu->stack_top, ap_idle_loop);
+}
+
+void smp_init(void) {
+    cpu_t *bsp = &cpus[0];
+    bsp->self = bsp;
+    bsp->index = 0;
+    bsp->apic_id = lapic_id();
+    bsp->online = 1;
+    cpuCount = 1;
+    setup_cpu_tables(bsp);
+
+    if (lapicEoiAddress == 0)
+        return;
+
+    uint16_t detected = PURE64_CPU_DETECTED;
+    for (int i = 0; i < detected && cpuCount < MAX_CPUS; i++) {
+        uint8_t id = PURE64_APIC_IDS[i];
+        if (id == bsp->apic_id || !PURE64_CPU_ACTIVE[id])
+            continue;
+
+        cpu_t *cpu = &cpus[cpuCount];
+        cpu->self = cpu;
+        cpu->index = cpuCount;
+        cpu->apic_id = id;
+        cpu->stack_top = (uint64_t)&apStacks[cpuCount][AP_STACK_SIZE];
+        cpuCount++;
+    }
+
+    uint64_t timeout = get_tsc_frequency() / 1000 * AP_START_TIMEOUT_MS;
+    for (int i = 1; i < cpuCount; i++) {
+        lapic_send_ipi(cpus[i].apic_id, SMP_START_VECTOR);
+        uint64_t start = rdtsc();
+        while (!cpus[i].online && rdtsc() - start < timeout)
+            cpu_pause();
+    }
+}
+
+int smp_cpu_count(void) {
+    return cpuCount;
+}
+
+cpu_t *smp_cpu(int index) {
+    if (index < 0 || index >= cpuCount)
+        return 0;
+    return &cpus[index];
+}
+
+int smp_submit(int index, smp_work_fn fn, uint64_t arg) {
+    cpu_t *cpu = smp_cpu(index);
+    if (cpu == 0 || index == 0 || !cpu->online || cpu->work_fn != 0)
+        return 0;
+
+    cpu->work_arg = arg;
+    __atomic_store_n(&cpu->work_fn, fn, __ATOMIC_RELEASE);
+    lapic_send_ipi(cpu->apic_id, SMP_WAKE_VECTOR);
+    return 1;
+}
+
+void smp_wait(int index) {
+    cpu_t *cpu = smp_cpu(index);
+    if (cpu == 0)
+        return;
+    while (__atomic_load_n(&cpu->work_fn, __ATOMIC_ACQUIRE) != 0)
+        cpu_pause();
+}
+
+void smp_abort_work(void) {
+    cpu_t *cpu = this_cpu();
+    // quien espera con smp_wait sigue; el trabajo queda sin hacer
+    __atomic_store_n(&cpu->work_fn, 0, __ATOMIC_RELEASE);
+    cpu_switch_stack(cpu->stack_top, ap_idle_loop);
+    for (;;)
+        ;
+}
+
+int smp_get_cpus(cpu_info_t *info, int max) {
+    int n = 0;
+    for (; n < cpuCount && n < max; n++) {
+        info[n].index = cpus[n].index;
+        info[n].apic_id = cpus[n].apic_id;
+        info[n].online = cpus[n].online;
+        info[n].is_bsp = (n == 0);
+        info[n].reserved = 0;
+        info[n].work_done = cpus[n].work_done;
+    }
+    return n;
+}
+
+void smp_handle_calls(void) {
+    int self = this_cpu()->index;
+
+    for (int src = 0; src < cpuCount; src++) {
+        call_slot_t *slot = &mailboxes[self][src];
+        smp_work_fn fn = __atomic_load_n(&slot->fn, __ATOMIC_ACQUIRE);
+        if (fn == 0)
+            continue;
+        uint64_t arg = slot->arg;
+        volatile uint32_t *remaining = slot->remaining;
+
+        // se libera el slot antes de correr: sin espera, el emisor ya puede reusarlo
+        __atomic_store_n(&slot->fn, 0, __ATOMIC_RELEASE);
+        fn(arg);
+        if (remaining)
+            __atomic_sub_fetch(remaining, 1, __ATOMIC_RELEASE);
+    }
+}
+
+int smp_call_function(uint32_t cpu_mask, smp_work_fn fn, uint64_t arg, int wait) {
+    int self = this_cpu()->index;
+    volatile uint32_t remaining = 0;
+    int sent = 0;
+
+    for (int i = 0; i < cpuCount; i++) {
+        if (i == self || !(cpu_mask & (1u << i)) || !cpus[i].online)
+            continue;
+
+        call_slot_t *slot = &mailboxes[i][self];
+        while (__atomic_load_n(&slot->fn, __ATOMIC_ACQUIRE) != 0) {
+            smp_handle_calls();         // la llamada anterior a ese CPU sigue ahí
+            cpu_pause();
+        }
+        slot->arg = arg;
+        slot->remaining = wait ? &remaining : 0;
+        if (wait)
+            __atomic_add_fetch(&remaining, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->fn, fn, __ATOMIC_RELEASE);
+        lapic_send_ipi(cpus[i].apic_id, SMP_CALL_VECTOR);
+        sent++;
+    }
+
+    if (cpu_mask & (1u << self))
+        fn(arg);
+
+    while (wait && __atomic_load_n(&remaining, __ATOMIC_ACQUIRE) != 0) {
+        smp_handle_calls();
+        cpu_pause();
+    }
+    return sent;
+}
+
+static void call_nop(uint64_t arg) {
+}
+
+int smp_call_benchmark(ipi_latency_t *out, int max, int iterations) {
+    int self = this_cpu()->index;
+    int n = 0;
+
+    for (int i = 0; i < cpuCount && n < max; i++) {
+        if (i == self || !cpus[i].online)
+            continue;
+
+        uint64_t min = (uint64_t)-1, max_cycles = 0, total = 0;
+        for (int k = 0; k < iterations; k++) {
+            uint64_t start = rdtsc();
+            smp_call_function(1u << i, call_nop, 0, 1);
+            uint64_t cycles = rdtsc() - start;
+            total += cycles;
+            if (cycles < min) min = cycles;
+            if (cycles > max_cycles) max_cycles = cycles;
+        }
+        out[n].cpu = i;
+        out[n].apic_id = cpus[i].apic_id;
+        out[n].min_cycles = min;
+        out[n].avg_cycles = iterations > 0 ? total / iterations : 0;
+        out[n].max_cycles = max_cycles;
+        n++;
+    }
+    return n;
+}
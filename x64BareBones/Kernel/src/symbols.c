@@ -0,0 +1,68 @@
+#include <stdint.h>
+#include <symbols.h>
+
+static symbol_t symbols[MAX_SYMBOLS];
+static int symbolCount = 0;
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+int symbols_init(char *table) {
+    char *p = table;
+    symbolCount = 0;
+
+    while (*p != '\0' && symbolCount < MAX_SYMBOLS) {
+        uint64_t addr = 0;
+        for (int i = 0; i < 16; i++, p++) {
+            int v = hex_value(*p);
+            if (v < 0)
+                return symbolCount;
+            addr = (addr << 4) | v;
+        }
+        if (*p++ != ' ')
+            return symbolCount;
+
+        char *name = p;
+        while (*p != '\n' && *p != '\0')
+            p++;
+        if (*p != '\n' || p == name)
+            return symbolCount;
+        *p++ = '\0';
+
+        // la tabla viene ordenada; si no, se corta para no romper la búsqueda
+        if (symbolCount > 0 && addr < symbols[symbolCount - 1].addr)
+            return symbolCount;
+        symbols[symbolCount].addr = addr;
+        symbols[symbolCount].name = name;
+        symbolCount++;
+    }
+    return symbolCount;
+}
+
+int symbol_index(uint64_t addr) {
+    int lo = 0, hi = symbolCount - 1, found = -1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (symbols[mid].addr <= addr) {
+            found = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return found;
+}
+
+const symbol_t *symbol_get(int index) {
+    if (index < 0 || index >= symbolCount)
+        return 0;
+    return &symbols[index];
+}
+
+int symbol_count(void) {
+    return symbolCount;
+}
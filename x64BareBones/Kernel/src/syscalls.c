@@ -4,6 +4,8 @@
 #include <stdint.h>
 #include <audioDriver.h>
 #include <font.h>
+#include <sched.h>
+#include <spinlock.h>
 
 #define CHAR_COLOR 0xFFFFFF
 #define CHAR_START_X 10
@@ -18,8 +20,58 @@ extern uint8_t inb(uint16_t port);
 
 extern void outb(uint16_t port, uint8_t value);
 
+extern void _sti(void);
+extern void _cli(void);
+
+// El driver de video no es reentrante y las tareas pueden escribir desde
+// cualquier CPU: cada syscall que dibuja lo hace entera con el mutex tomado.
+// Dibuja con interrupciones: puede perder el CPU a mitad de un texto largo, y
+// si una tarea de más prioridad espera el mutex se lo presta a la que lo tiene.
+// Por eso ningún handler de IRQ dibuja: Ctrl+R/Ctrl+L van por una tarea
+// (keyboardDriver.c). Las excepciones toman el mutex pero dibujan con IF=0.
+static kmutex_t videoLock;
+
+uint64_t video_lock(void) {
+    kmutex_lock(&videoLock);
+    uint64_t flags = irq_save();
+    _sti();
+    return flags;
+}
+
+uint64_t video_lock_irqoff(void) {
+    kmutex_lock(&videoLock);
+    return irq_save();
+}
+
+void video_unlock(uint64_t flags) {
+    _cli();
+    kmutex_unlock(&videoLock);
+    irq_restore(flags);
+}
+
 void syscall_write(const char *str, int len) {
+    uint64_t flags = video_lock();
     writeString(str, len);
+    video_unlock(flags);
+}
+
+uint64_t syscall_writev(const iovec_t *iov, int iovcnt) {
+    uint64_t flags = video_lock();
+    uint64_t written = writeStringv(iov, iovcnt);
+    video_unlock(flags);
+    return written;
+}
+
+void syscall_draw_rect(uint32_t color, uint64_t x, uint64_t y, uint64_t width, uint64_t height) {
+    uint64_t flags = video_lock();
+    drawRect(color, x, y, width, height);
+    video_unlock(flags);
+}
+
+void syscall_put_char(char c, uint32_t x, uint32_t y, uint32_t color) {
+    uint64_t flags = video_lock();
+    putChar(c, x, y, color);
+    video_unlock(flags);
 }
 
 uint64_t sys_read(int fd, char * buffer, int count) {
@@ -37,8 +89,21 @@ uint64_t sys_read(int fd, char * buffer, int count) {
     return i;
 }
 
+uint64_t sys_read_timeout(int fd, char * buffer, int count, int64_t timeout_ms) {
+    if (fd != STDIN || count <= 0) {
+        return 0;
+    }
+    // devuelve apenas haya al menos una tecla, sin esperar a completar count
+    if (!keyboard_wait(timeout_ms)) {
+        return 0;
+    }
+    return sys_read(fd, buffer, count);
+}
+
 void syscall_clear_screen() {
+    uint64_t flags = video_lock();
     clearScreen();
+    video_unlock(flags);
 }
 
 static uint8_t read_rtc_register(uint8_t reg) {
@@ -85,7 +150,9 @@ void play_sound(uint32_t frequency, uint32_t duration_ms) {
 }
 
 void change_font_size(int new_size) {
+    uint64_t flags = video_lock();
     setScale(new_size);
+    video_unlock(flags);
 }
 
 
@@ -0,0 +1,181 @@
+#include <stdint.h>
+#include <taskpool.h>
+#include <smp.h>
+#include <interrupts.h>
+
+extern void cpu_pause(void);
+
+// de sched.h, que no se incluye porque también define task_t
+void sched_migrate_disable(void);
+void sched_migrate_enable(void);
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+} task_t;
+
+// top lo avanzan los ladrones (CAS), bottom solo el dueño
+typedef struct {
+    volatile int64_t top;
+    uint64_t pad0[7];
+    volatile int64_t bottom;
+    uint64_t pad1[7];
+    task_t tasks[TASK_DEQUE_SIZE];
+} deque_t;
+
+typedef struct {
+    range_fn fn;
+    void *arg;
+    uint64_t grain;
+    volatile uint64_t remaining;    // índices sin procesar
+} job_t;
+
+static deque_t deques[MAX_CPUS] __attribute__((aligned(64)));
+static taskpool_stats_t stats[MAX_CPUS];
+static int busy = 0;
+
+static int deque_push(deque_t *d, task_t task) {
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    if (b - t >= TASK_DEQUE_SIZE)
+        return 0;
+    d->tasks[b & (TASK_DEQUE_SIZE - 1)] = task;
+    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static int deque_pop(deque_t *d, task_t *task) {
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+
+    if (t > b) {                    // vacía
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    *task = d->tasks[b & (TASK_DEQUE_SIZE - 1)];
+    if (t == b) {
+        // último elemento: se compite con los ladrones por top
+        int won = __atomic_compare_exchange_n(&d->top, &t, t + 1, 0,
+                                              __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+    return 1;
+}
+
+static int deque_steal(deque_t *d, task_t *task) {
+    int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+    if (t >= b)
+        return 0;
+    *task = d->tasks[t & (TASK_DEQUE_SIZE - 1)];
+    return __atomic_compare_exchange_n(&d->top, &t, t + 1, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+// Parte el rango a la mitad dejando la mitad derecha a disposición de los
+// ladrones, y ejecuta lo que queda (<= grain, o todo si la deque se llenó)
+static void run_task(job_t *job, int self, task_t task) {
+    while (task.end - task.start > job->grain) {
+        uint64_t mid = task.start + (task.end - task.start) / 2;
+        task_t right = { mid, task.end };
+        if (!deque_push(&deques[self], right))
+            break;
+        task.end = mid;
+    }
+
+    job->fn(task.start, task.end, job->arg);
+    stats[self].executed++;
+    stats[self].iterations += task.end - task.start;
+    __atomic_sub_fetch(&job->remaining, task.end - task.start, __ATOMIC_RELEASE);
+}
+
+static int try_steal(int self, int cpus, task_t *task) {
+    for (int i = 1; i < cpus; i++) {
+        int victim = (self + i) % cpus;
+        if (deque_steal(&deques[victim], task)) {
+            stats[self].steals++;
+            return 1;
+        }
+    }
+    stats[self].failed_steals++;
+    return 0;
+}
+
+static void work_until_done(job_t *job, int self) {
+    int cpus = smp_cpu_count();
+    task_t task;
+
+    while (__atomic_load_n(&job->remaining, __ATOMIC_ACQUIRE) != 0) {
+        if (deque_pop(&deques[self], &task) || try_steal(self, cpus, &task))
+            run_task(job, self, task);
+        else
+            cpu_pause();
+    }
+}
+
+// Trabajo que se le asigna a cada AP con smp_submit
+static void pool_worker(uint64_t arg) {
+    work_until_done((job_t *)arg, this_cpu()->index);
+}
+
+int parallel_for(uint64_t start, uint64_t end, uint64_t grain, range_fn fn, void *arg) {
+    if (end <= start || fn == 0)
+        return 0;
+
+    int cpus = smp_cpu_count();
+    // llamada anidada desde un fn, sin APs o ya lanzado por una tarea de
+    // otro CPU: en serie
+    if (cpus <= 1 || __atomic_exchange_n(&busy, 1, __ATOMIC_ACQUIRE)) {
+        fn(start, end, arg);
+        return 1;
+    }
+    // los deques y los smp_wait son de este CPU: la tarea no se puede mover
+    sched_migrate_disable();
+
+    if (grain == 0) {
+        grain = (end - start) / (cpus * 8);
+        if (grain == 0)
+            grain = 1;
+    }
+
+    job_t job = { fn, arg, grain, end - start };
+    for (int i = 0; i < cpus; i++)
+        deques[i].top = deques[i].bottom = 0;
+
+    int self = this_cpu()->index;
+    task_t root = { start, end };
+    deque_push(&deques[self], root);
+
+    int workers = 1;
+    uint32_t submitted = 0;
+    for (int i = 0; i < cpus; i++) {
+        if (i != self && smp_submit(i, pool_worker, (uint64_t)&job)) {
+            submitted |= 1u << i;
+            workers++;
+        }
+    }
+
+    // las syscalls entran con IF=0; el timer y el teclado siguen andando
+    _sti();
+    work_until_done(&job, self);
+    for (int i = 0; i < cpus; i++) {
+        if (submitted & (1u << i))
+            smp_wait(i);
+    }
+    _cli();
+
+    sched_migrate_enable();
+    __atomic_store_n(&busy, 0, __ATOMIC_RELEASE);
+    return workers;
+}
+
+int taskpool_get_stats(taskpool_stats_t *out, int max) {
+    int n = 0;
+    for (; n < smp_cpu_count() && n < max; n++)
+        out[n] = stats[n];
+    return n;
+}
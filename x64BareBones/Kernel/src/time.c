@@ -1,9 +1,15 @@
 #include <time.h>
 #include <stdint.h>
+#include <sched.h>
 
 static unsigned long ticks = 0;
 
 void sleep(uint64_t pauseTicks) {
+    // con el scheduler la tarea duerme y el CPU queda para las demás
+    if (sched_active()) {
+        sched_sleep(pauseTicks);
+        return;
+    }
     uint64_t start = ticks;
 	_sti();
     while ((ticks - start) < pauseTicks) {
@@ -11,10 +17,14 @@ void sleep(uint64_t pauseTicks) {
 	_cli(); //no se por que al entrar a sleep estan las interrupciones desactivadas asi que las activo y por las dudas las desactivo
 }
 
-void timer_handler() {
+void timer_handler(void *ctx) {
 	ticks++;
 }
 
 uint64_t get_ticks() {
     return ticks;
 }
+
+uint64_t ms_to_ticks(uint64_t ms) {
+    return (ms * 1000 + TIMER_TICK_US - 1) / TIMER_TICK_US;
+}
@@ -0,0 +1,183 @@
+#include <stdint.h>
+#include <tscsync.h>
+#include <smp.h>
+#include <bench_timer.h>
+
+#define TSC_SYNC_TIMEOUT_MS 100
+
+extern void cpu_pause(void);
+
+// Cada campo que escribe un solo lado va en su propia línea de caché
+typedef struct {
+    volatile uint64_t ping __attribute__((aligned(64)));     // BSP -> AP
+    volatile uint64_t pong __attribute__((aligned(64)));     // AP -> BSP
+    volatile uint64_t ap_tsc;
+    volatile uint64_t last __attribute__((aligned(64)));     // test de warps
+    volatile uint64_t ready __attribute__((aligned(64)));    // AP adentro del test
+    volatile uint64_t go;
+    volatile uint64_t done;
+    volatile uint64_t abort;
+    volatile uint64_t ap_warps;
+    int corrected;
+} sync_shared_t;
+
+static sync_shared_t shared;
+static tsc_sync_t results[MAX_CPUS];
+static int resultCount = 0;
+
+static inline uint64_t read_clock(int corrected) {
+    return corrected ? tsc_now() : rdtsc();
+}
+
+// Corre en el AP (desde el handler de SMP_CALL_VECTOR, IF=0)
+static void sync_responder(uint64_t arg) {
+    sync_shared_t *s = (sync_shared_t *)arg;
+
+    __atomic_store_n(&s->ready, 1, __ATOMIC_RELEASE);
+    for (uint64_t r = 1; r <= TSC_SYNC_ROUNDS; r++) {
+        while (__atomic_load_n(&s->ping, __ATOMIC_ACQUIRE) != r) {
+            if (s->abort)
+                return;
+            cpu_pause();
+        }
+        s->ap_tsc = rdtsc();
+        __atomic_store_n(&s->pong, r, __ATOMIC_RELEASE);
+    }
+}
+
+// Cuenta lecturas menores a la última publicada por cualquiera de los dos CPUs
+static uint64_t warp_loop(sync_shared_t *s, int corrected) {
+    uint64_t warps = 0;
+    for (int i = 0; i < TSC_WARP_ITERATIONS; i++) {
+        uint64_t prev = __atomic_load_n(&s->last, __ATOMIC_ACQUIRE);
+        uint64_t now = read_clock(corrected);
+        if ((int64_t)(now - prev) < 0) {
+            warps++;
+            continue;
+        }
+        __atomic_compare_exchange_n(&s->last, &prev, now, 0,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+    }
+    return warps;
+}
+
+static void warp_ap(uint64_t arg) {
+    sync_shared_t *s = (sync_shared_t *)arg;
+
+    __atomic_store_n(&s->ready, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&s->go, __ATOMIC_ACQUIRE)) {
+        if (s->abort)
+            return;
+        cpu_pause();
+    }
+    s->ap_warps = warp_loop(s, s->corrected);
+    __atomic_store_n(&s->done, 1, __ATOMIC_RELEASE);
+}
+
+static void reset_shared(void) {
+    shared.ping = 0;
+    shared.pong = 0;
+    shared.ap_tsc = 0;
+    shared.last = 0;
+    shared.ready = 0;
+    shared.go = 0;
+    shared.done = 0;
+    shared.abort = 0;
+    shared.ap_warps = 0;
+}
+
+// Espera a que el AP entre a la función pedida; si no aparece, lo descarta
+static int wait_flag(volatile uint64_t *flag) {
+    uint64_t deadline = rdtsc() + ms_to_cycles(TSC_SYNC_TIMEOUT_MS);
+    while (!__atomic_load_n(flag, __ATOMIC_ACQUIRE)) {
+        if (rdtsc() > deadline) {
+            shared.abort = 1;
+            return 0;
+        }
+        cpu_pause();
+    }
+    return 1;
+}
+
+static int measure_offset(int cpu, int64_t *offset, uint64_t *rtt) {
+    reset_shared();
+    smp_call_function(1u << cpu, sync_responder, (uint64_t)&shared, 0);
+    if (!wait_flag(&shared.ready))
+        return 0;
+
+    uint64_t best = (uint64_t)-1;
+    for (uint64_t r = 1; r <= TSC_SYNC_ROUNDS; r++) {
+        uint64_t t0 = rdtsc();
+        __atomic_store_n(&shared.ping, r, __ATOMIC_RELEASE);
+        while (__atomic_load_n(&shared.pong, __ATOMIC_ACQUIRE) != r)
+            cpu_pause();
+        uint64_t t2 = rdtsc();
+        uint64_t t1 = shared.ap_tsc;
+
+        // la ronda más corta es la que menos ruido tiene (sin interrupciones en el medio)
+        if (t2 - t0 < best) {
+            best = t2 - t0;
+            *offset = (int64_t)(t1 - (t0 + (t2 - t0) / 2));
+        }
+    }
+    *rtt = best;
+    return 1;
+}
+
+static uint64_t measure_warps(int cpu, int corrected) {
+    reset_shared();
+    shared.corrected = corrected;
+    smp_call_function(1u << cpu, warp_ap, (uint64_t)&shared, 0);
+    if (!wait_flag(&shared.ready))
+        return 0;
+
+    __atomic_store_n(&shared.go, 1, __ATOMIC_RELEASE);
+    uint64_t warps = warp_loop(&shared, corrected);
+    while (!__atomic_load_n(&shared.done, __ATOMIC_ACQUIRE))
+        cpu_pause();
+    return warps + shared.ap_warps;
+}
+
+uint64_t tsc_sync_init(void) {
+    uint64_t max_skew = 0;
+    int count = smp_cpu_count();
+
+    resultCount = 0;
+    for (int i = 0; i < count && i < MAX_CPUS; i++) {
+        cpu_t *cpu = smp_cpu(i);
+        tsc_sync_t *res = &results[resultCount++];
+
+        res->cpu = i;
+        res->apic_id = cpu->apic_id;
+        res->offset = 0;
+        res->rtt = 0;
+        res->warps_raw = 0;
+        res->warps_corrected = 0;
+        if (i == 0 || !cpu->online)
+            continue;
+
+        int64_t offset = 0;
+        uint64_t rtt = 0;
+        if (!measure_offset(i, &offset, &rtt))
+            continue;
+
+        res->rtt = rtt;
+        res->warps_raw = measure_warps(i, 0);
+        res->offset = offset;
+        cpu->tsc_offset = offset;
+        res->warps_corrected = measure_warps(i, 1);
+
+        uint64_t skew = offset < 0 ? (uint64_t)-offset : (uint64_t)offset;
+        if (skew > max_skew)
+            max_skew = skew;
+    }
+    return max_skew;
+}
+
+int tsc_sync_get(tsc_sync_t *out, int max) {
+    int n = 0;
+    for (; n < resultCount && n < max; n++) {
+        out[n] = results[n];
+    }
+    return n;
+}
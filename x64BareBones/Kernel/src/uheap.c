@@ -0,0 +1,122 @@
+#include <stdint.h>
+#include <uheap.h>
+#include <pmm.h>
+#include <paging.h>
+#include <lib.h>
+#include <spinlock.h>
+#include <sched.h>
+
+static uint64_t heapBase;
+static uint64_t heapEnd;
+static uint64_t heapBreak;
+
+// Bloques entregados por uheap_mmap: munmap solo acepta estos y el orden sale
+// de acá, no del tamaño que manda userland
+typedef struct {
+    void *addr;
+    uint8_t order;
+} mmap_block_t;
+
+static mmap_block_t mapped[USER_MMAP_SLOTS];
+static spinlock_t mappedLock;
+
+// El lock del malloc de userland: al ser un kmutex, una tarea que matan con
+// él tomado sigue hasta soltarlo y el dueño hereda la prioridad de quien espera
+static kmutex_t userHeapLock;
+
+uint64_t uheap_init(void) {
+    // ventana + 2 MiB de guarda arriba, que paging.c deja sin mapear
+    for (uint64_t size = USER_HEAP_MAX; size >= USER_HEAP_MIN; size /= 2) {
+        uint64_t base = pmm_reserve_anywhere(size + USER_HEAP_GUARD, USER_HEAP_ALIGN, "user heap");
+        if (base != 0) {
+            heapBase = heapBreak = base;
+            heapEnd = base + size;
+            paging_add_guard(heapEnd);
+            paging_set_small_range(heapBase, heapEnd);
+            // de a 2 MiB, para que siga yendo con páginas grandes
+            paging_add_lazy(heapBase, heapEnd, PAGE_SIZE_2M, "user heap");
+            return size;
+        }
+    }
+    return 0;
+}
+
+uint64_t uheap_sbrk(int64_t increment) {
+    uint64_t old = heapBreak;
+    uint64_t next = old + (uint64_t)increment;
+
+    if (heapBase == 0 || next < heapBase || next > heapEnd
+        || (increment > 0 && next < old))
+        return (uint64_t)-1;
+    if (increment < 0) {
+        // Lo que queda arriba del break tiene que volver a leer cero: las
+        // unidades enteras se descartan y el resto de la primera se limpia
+        uint64_t unitEnd = (next + PAGE_SIZE_2M - 1) & ~(PAGE_SIZE_2M - 1);
+        if (unitEnd > old)
+            unitEnd = old;
+        memset((void *)next, 0, unitEnd - next);
+        paging_discard(unitEnd, old);
+    }
+    heapBreak = next;
+    return old;
+}
+
+static unsigned order_for(uint64_t bytes) {
+    unsigned order = 0;
+    while (order <= PAGE_MAX_ORDER && ((uint64_t)PAGE_SIZE << order) < bytes)
+        order++;
+    return order;
+}
+
+void *uheap_mmap(uint64_t bytes) {
+    unsigned order = order_for(bytes);
+    if (bytes == 0 || order > PAGE_MAX_ORDER)
+        return 0;
+    void *block = page_alloc(order);
+    if (block == 0)
+        return 0;
+
+    uint64_t flags = spin_lock_irqsave(&mappedLock);
+    int slot = -1;
+    for (int i = 0; i < USER_MMAP_SLOTS && slot < 0; i++) {
+        if (mapped[i].addr == 0)
+            slot = i;
+    }
+    if (slot >= 0) {
+        mapped[slot].addr = block;
+        mapped[slot].order = order;
+    }
+    spin_unlock_irqrestore(&mappedLock, flags);
+
+    if (slot < 0) {
+        page_free(block, order);
+        return 0;
+    }
+    memset(block, 0, (uint64_t)PAGE_SIZE << order);
+    return block;
+}
+
+void uheap_munmap(void *addr, uint64_t bytes) {
+    if (addr == 0)
+        return;
+    int order = -1;
+    uint64_t flags = spin_lock_irqsave(&mappedLock);
+    for (int i = 0; i < USER_MMAP_SLOTS; i++) {
+        if (mapped[i].addr == addr) {
+            order = mapped[i].order;
+            mapped[i].addr = 0;
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&mappedLock, flags);
+    if (order >= 0)
+        page_free(addr, order);
+}
+
+void uheap_lock(void) {
+    kmutex_lock(&userHeapLock);
+}
+
+void uheap_unlock(void) {
+    kmutex_unlock(&userHeapLock);
+}
@@ -6,6 +6,7 @@
 #include "../lib.h"
 #include "../bench/bench.h"
 #include "../tron.h"
+#include "../malloc.h"
 
 #define REG_COUNT 21
 
@@ -20,7 +21,21 @@ void shell_print_help() {
     print("  clear          - clear screen\n");
     print("  time           - display system time\n");
     print("  'ctrl + r'     - display CPU registers\n");
-    print("  fontscale 1-3  - change font size\n\n");
+    print("  fontscale 1-3  - change font size\n");
+    print("  irqmode [m]    - show/select interrupt controller (pic/apic)\n");
+    print("  cpus           - list online CPUs and their APIC IDs\n");
+    print("  pool           - per-CPU task pool counters (tasks, steals)\n");
+    print("  interrupts     - per-vector counts and handler time histograms\n");
+    print("  meminfo        - physical pages, fragmentation and user heap\n");
+    print("  vmmap [m]      - page table layout, TLB reach (m: default/2m/4k)\n");
+    print("  profile <cmd>  - run a command under the sampling profiler\n");
+    print("  bg <cmd>       - run a command as a background task\n");
+    print("  ps             - list tasks (state, CPU time, switches, CPU)\n");
+    print("  kill <id>      - terminate a background task\n");
+    print("  affinity <id> [mask] - show/set the CPUs a task may run on (hex)\n");
+    print("  rt <id> <p> [ms] - priority 0 (normal) or 1-15 (real time), frame period\n");
+    print("  cpuload        - per-core utilisation over one second\n");
+    print("  quantum [n]    - show/set the scheduler quantum in timer ticks\n\n");
     
     print("Exception Tests (dump registers + return to shell):\n");
     print("  divzero        - trigger division by zero exception\n");
@@ -36,16 +51,19 @@ void shell_print_help() {
     print("  bench fpu [n]  - FPU benchmark Mandelbrot (default: 256)\n");
     print("  bench io [m]   - I/O benchmark (kbd/fb/all)\n");
     print("  bench env      - show environment info\n");
+    print("  bench irq [m]  - IRQ entry/exit overhead (pic/apic/both)\n");
+    print("  bench ipi [n]  - cross-core call round trip (default: 1000)\n");
+    print("  bench slab [n] - kernel slab alloc/free cost (default: 10000)\n");
+    print("  bench mem [m]  - bandwidth/pointer chase per page size (default: 32 MiB)\n");
+    print("  bench copy [m] - kernel memcpy/memset per routine, 16 B up (default: 32 MiB)\n");
+    print("  bench str      - userland memcpy/strlen/... vs the old byte loops\n");
 }
 
 static int read_line(char *buf, int max) {
     int i = 0;
     while (i < max - 1) {
         char c = 0;
-        int r = 0;
-        do {
-            r = read(&c, 1);
-        } while (r == 0);
+        while (read_blocking(&c, 1) == 0);
         if (c == '\n') {
             printChar('\n');
             break;
@@ -104,11 +122,8 @@ static const char *regName[REG_COUNT] = {
 };
 
 static void print_hex64(uint64_t v) {
-    char buf[17]; buf[16]=0;
-    for (int i=15;i>=0;i--) { int d=v&0xF;
-        buf[i]= d<10?'0'+d:'A'+(d-10);
-        v>>=4;
-    }
+    char buf[17];
+    uint64_to_hex(v, buf, 16);
     print(buf);
 }
 
@@ -189,6 +204,26 @@ static int parse_int(const char *str) {
     return result;
 }
 
+// Igual para una máscara en hex (con o sin 0x); -1 si no hay dígitos
+static int64_t parse_hex(const char *str) {
+    int64_t result = 0;
+    int digits = 0;
+    if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+        str += 2;
+    for (;; str++, digits++) {
+        char c = *str;
+        if (c >= '0' && c <= '9')
+            result = result * 16 + (c - '0');
+        else if (c >= 'a' && c <= 'f')
+            result = result * 16 + (c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            result = result * 16 + (c - 'A' + 10);
+        else
+            break;
+    }
+    return digits ? result : -1;
+}
+
 // Helper para verificar si un string comienza con un prefijo
 static int starts_with(const char *str, const char *prefix) {
     int i = 0;
@@ -213,6 +248,443 @@ static const char* get_arg(const char *line, const char *cmd) {
     return p;
 }
 
+static void print_cpus(void) {
+    cpu_info_t cpus[MAX_CPUS];
+    char idx[12], id[12], work[12];
+    int n = getCpuInfo(cpus, MAX_CPUS);
+
+    for (int i = 0; i < n; i++) {
+        int_to_str(cpus[i].index, idx);
+        int_to_str(cpus[i].apic_id, id);
+        int_to_str((int)cpus[i].work_done, work);
+        const char *parts[] = {
+            "  CPU ", idx, "  APIC ID ", id,
+            cpus[i].is_bsp ? "  BSP" : "  AP ",
+            cpus[i].online ? "  online" : "  offline",
+            "  jobs ", work, "\n"
+        };
+        print_parts(parts, 9);
+    }
+}
+
+static void print_pool_stats(void) {
+    taskpool_stats_t stats[MAX_CPUS];
+    char idx[12], tasks[12], iters[12], steals[12], failed[12];
+    int n = getPoolStats(stats, MAX_CPUS);
+
+    for (int i = 0; i < n; i++) {
+        int_to_str(i, idx);
+        int_to_str((int)stats[i].executed, tasks);
+        int_to_str((int)stats[i].iterations, iters);
+        int_to_str((int)stats[i].steals, steals);
+        int_to_str((int)stats[i].failed_steals, failed);
+        const char *parts[] = {
+            "  CPU ", idx, "  tasks ", tasks, "  iters ", iters,
+            "  steals ", steals, "  failed ", failed, "\n"
+        };
+        print_parts(parts, 11);
+    }
+}
+
+static const char *vector_name(uint32_t vector) {
+    switch (vector) {
+        case 0x00: return "#DE divide";
+        case 0x06: return "#UD opcode";
+        case 0x07: return "#NM fpu";
+        case 0x20: return "timer";
+        case 0x21: return "keyboard";
+        case 0x80: return "syscall";
+        case 0x81: return "task switch";
+        case 0xF0: return "smp start";
+        case 0xF1: return "smp wake";
+        case 0xF2: return "profiler";
+        case 0xF3: return "smp call";
+        case 0xFF: return "spurious";
+        default:   return "irq";
+    }
+}
+
+static void print_interrupts(void) {
+    static irq_stat_t stats[32];
+    static const char hex[] = "0123456789ABCDEF";
+    char vec[5] = "0x00";
+    char count[24], avg[24], max[24], bucket[8], n[24];
+    int total = getIrqStats(stats, 32);
+
+    print("  VEC   NAME         COUNT   AVG cyc   MAX cyc\n");
+    for (int i = 0; i < total; i++) {
+        irq_stat_t *s = &stats[i];
+        vec[2] = hex[(s->vector >> 4) & 0xF];
+        vec[3] = hex[s->vector & 0xF];
+        uint64_to_str(s->count, count);
+        uint64_to_str(s->total_cycles / s->count, avg);
+        uint64_to_str(s->max_cycles, max);
+        const char *row[] = {
+            "  ", vec, "  ", vector_name(s->vector), "  ", count,
+            "  ", avg, "  ", max, "\n"
+        };
+        print_parts(row, 11);
+
+        // histograma log2: solo los buckets con muestras
+        print("        log2:");
+        for (int b = 0; b < IRQSTAT_BUCKETS; b++) {
+            if (s->hist[b] == 0)
+                continue;
+            int_to_str(b, bucket);
+            uint64_to_str(s->hist[b], n);
+            const char *cell[] = { " 2^", bucket, "=", n };
+            print_parts(cell, 4);
+        }
+        printChar('\n');
+    }
+}
+
+static void commandProc(const char *line);
+
+#define PROFILE_TOP 15
+
+static void print_meminfo(void) {
+    static page_stats_t st;
+    static const char *orderName[PAGE_ORDERS] = {
+        "4K", "8K", "16K", "32K", "64K", "128K", "256K", "512K", "1M", "2M"
+    };
+    char a[24], b[24], c[24], d[24];
+
+    getMemInfo(&st);
+    uint64_to_str(st.usable_bytes / 1024, a);
+    int_to_str((int)st.e820_entries, b);
+    const char *usable[] = { "  E820 usable: ", a, " KiB (", b, " entries)\n" };
+    print_parts(usable, 5);
+
+    uint64_to_str(st.total_pages, a);
+    uint64_to_str(st.free_pages, b);
+    uint64_to_str(st.free_pages * 4, c);
+    uint64_to_str(st.reserved_pages, d);
+    const char *pages[] = {
+        "  pages: ", a, " managed, ", b, " free (", c, " KiB), ", d, " reserved\n"
+    };
+    print_parts(pages, 9);
+
+    print("  free blocks:");
+    for (int o = 0; o < PAGE_ORDERS; o++) {
+        uint64_to_str(st.free_blocks[o], a);
+        const char *blk[] = { " ", orderName[o], "=", a };
+        print_parts(blk, 4);
+    }
+    print("\n");
+
+    if (st.largest_order < PAGE_ORDERS) {
+        int_to_str((int)(st.frag_2m_permille / 10), a);
+        int_to_str((int)(st.frag_2m_permille % 10), b);
+        const char *frag[] = {
+            "  largest free block: ", orderName[st.largest_order],
+            "  2M fragmentation: ", a, ".", b, "%\n"
+        };
+        print_parts(frag, 7);
+    } else {
+        print("  no free memory\n");
+    }
+
+    for (uint32_t i = 0; i < st.reserved_count && i < PMM_MAX_RESERVED; i++) {
+        uint64_to_str(st.reserved[i].start / 1024, a);
+        uint64_to_str(st.reserved[i].end / 1024, b);
+        const char *res[] = {
+            "  reserved ", st.reserved[i].name, ": ", a, " KiB - ", b, " KiB\n"
+        };
+        print_parts(res, 7);
+    }
+
+    malloc_stats_t heap;
+    malloc_get_stats(&heap);
+    uint64_to_str(heap.heap_bytes / 1024, a);
+    uint64_to_str(heap.mapped_bytes / 1024, b);
+    uint64_to_str(heap.large_free_bytes / 1024, c);
+    const char *uh[] = {
+        "  user heap: ", a, " KiB sbrk, ", b, " KiB mapped, ", c, " KiB free (large)\n"
+    };
+    print_parts(uh, 7);
+    uint64_to_str(heap.allocs, a);
+    uint64_to_str(heap.frees, b);
+    uint64_to_str(heap.fast_allocs, c);
+    const char *uc[] = { "  malloc: ", a, " allocs, ", b, " frees, ", c, " from size-class lists\n" };
+    print_parts(uc, 7);
+}
+
+static void print_vmmap(const char *arg) {
+    static paging_info_t info;
+    static const char *kindName[PAGE_KINDS] = { "4K", "2M", "1G" };
+    static const char *cacheName[] = { "WB", "WC", "UC", "guard" };
+    static const char *modeName[] = { "default", "2M only", "4K heap" };
+    // alcance = entradas * tamaño de página, en la unidad de cada tamaño
+    static const uint32_t kindScale[PAGE_KINDS] = { 4, 2, 1 };
+    static const char *kindUnit[PAGE_KINDS] = { " KiB", " MiB", " GiB" };
+    char a[24], b[24], c[24];
+
+    int mode = PAGING_MODE_QUERY;
+    if (str_eq(arg, "default")) mode = PAGING_MODE_DEFAULT;
+    else if (str_eq(arg, "2m")) mode = PAGING_MODE_2M;
+    else if (str_eq(arg, "4k")) mode = PAGING_MODE_4K_HEAP;
+    if (setPagingMode(mode) < 0) {
+        print("Kernel page tables not available\n");
+        return;
+    }
+
+    getPagingInfo(&info);
+    uint64_to_str(info.table_pages, a);
+    const char *head[] = {
+        "  mode: ", modeName[info.mode], "  1G pages: ", info.features & PAGING_FEATURE_1G ? "yes" : "no",
+        "  PAT: ", info.features & PAGING_FEATURE_PAT ? "yes" : "no", "  table pages: ", a, "\n"
+    };
+    print_parts(head, 9);
+
+    for (uint32_t i = 0; i < info.run_count && i < PAGING_MAX_RUNS; i++) {
+        print("  0x");
+        print_hex64(info.runs[i].start);
+        print("-0x");
+        print_hex64(info.runs[i].end);
+        const char *run[] = { "  ", kindName[info.runs[i].kind], "  ", cacheName[info.runs[i].cache], "\n" };
+        print_parts(run, 5);
+    }
+
+    print(info.tlb_estimated ? "  entries / TLB reach L1, L2 (estimated):\n" : "  entries / TLB reach L1, L2:\n");
+    for (int k = 0; k < PAGE_KINDS; k++) {
+        uint64_to_str(info.pages[k], a);
+        uint64_to_str((uint64_t)info.l1_dtlb[k] * kindScale[k], b);
+        uint64_to_str((uint64_t)info.l2_tlb[k] * kindScale[k], c);
+        const char *row[] = {
+            "    ", kindName[k], ": ", a, " mapped, reach ", b, kindUnit[k], ", ", c, kindUnit[k], "\n"
+        };
+        print_parts(row, 11);
+    }
+
+    if (info.lazy_count)
+        print("  demand-zero regions (zeroed on first touch):\n");
+    for (uint32_t i = 0; i < info.lazy_count && i < PAGING_MAX_LAZY; i++) {
+        const lazy_region_info_t *r = &info.lazy[i];
+        uint64_to_str(r->touched, a);
+        uint64_to_str((r->end - r->start) / r->unit, b);
+        uint64_to_str(r->faults, c);
+        print("    0x");
+        print_hex64(r->start);
+        print("-0x");
+        print_hex64(r->end);
+        const char *row[] = {
+            "  ", r->unit == 4096 ? "4K" : "2M", "  ", a, "/", b, " touched, ", c, " faults  ", r->name, "\n"
+        };
+        print_parts(row, 11);
+    }
+}
+
+static void run_profiled(const char *cmd) {
+    static profile_entry_t top[PROFILE_TOP];
+    char buf[24], self[24], pct[8], total[24];
+
+    if (profileStart() == 0) {
+        print("Profiler not available (no LAPIC)\n");
+        return;
+    }
+    commandProc(cmd);
+    uint64_t samples = profileStop();
+
+    uint64_to_str(samples, buf);
+    const char *head[] = { "\n=== Profile: ", buf, " samples ===\n", "     SELF   %   TOTAL  FUNCTION\n" };
+    print_parts(head, 4);
+    if (samples == 0)
+        return;
+
+    int n = profileReport(top, PROFILE_TOP);
+    for (int i = 0; i < n; i++) {
+        uint64_to_str(top[i].self, self);
+        uint64_to_str(top[i].self * 100 / samples, pct);
+        uint64_to_str(top[i].total, total);
+        const char *row[] = { "  ", self, "  ", pct, "%  ", total, "  ", top[i].name, "\n" };
+        print_parts(row, 9);
+    }
+}
+
+// La línea se copia: el shell reusa su buffer mientras la tarea corre
+static void background_entry(uint64_t arg) {
+    char *line = (char *)arg;
+    commandProc(line);
+    free(line);
+}
+
+static void run_background(const char *cmd) {
+    char id[12];
+    uint64_t len = strlen(cmd);
+    char *line = malloc(len + 1);
+    if (line == 0) {
+        print("Not enough memory\n");
+        return;
+    }
+    memcpy(line, cmd, len + 1);
+    int task = taskCreate(background_entry, (uint64_t)line, line);
+    if (task < 0) {
+        free(line);
+        print("Could not create the task\n");
+        return;
+    }
+    int_to_str(task, id);
+    const char *msg[] = { "[", id, "] ", line, "\n" };
+    print_parts(msg, 5);
+}
+
+// "ts"/"rtN" y, si un mutex le presta más, ">N" con la efectiva
+static void prio_to_str(const task_info_t *t, char *out) {
+    int n = 0;
+    if (t->prio == TASK_PRIO_NORMAL) {
+        out[n++] = 't';
+        out[n++] = 's';
+    } else {
+        out[n++] = 'r';
+        out[n++] = 't';
+        n += int_to_str(t->prio, out + n);
+    }
+    if (t->eff_prio != t->prio) {
+        out[n++] = '>';
+        n += int_to_str(t->eff_prio, out + n);
+    }
+    out[n] = 0;
+}
+
+static void print_tasks(void) {
+    static task_info_t list[SCHED_MAX_TASKS];
+    static const char *stateName[] = { "free ", "ready", "run  ", "sleep", "wait ", "dead " };
+    char id[12], pct[8], ms[24], sw[24], pre[24], q[12], cpu[4], mask[5];
+    char prio[12], missed[24], frames[24];
+    int n = getTasks(list, SCHED_MAX_TASKS);
+    int self = taskSelf();
+    uint64_t total = 0;
+
+    for (int i = 0; i < n; i++)
+        total += list[i].cycles;
+
+    print("    ID  STATE  CPU%   CPU ms  SWITCHES  PREEMPT  CPU  MASK  PRIO  MISSED  NAME\n");
+    for (int i = 0; i < n; i++) {
+        task_info_t *t = &list[i];
+        int_to_str(t->id, id);
+        uint64_to_str(total ? t->cycles * 100 / total : 0, pct);
+        uint64_to_str(cycles_to_ms(t->cycles), ms);
+        uint64_to_str(t->switches, sw);
+        uint64_to_str(t->preemptions, pre);
+        int_to_str(t->cpu, cpu);
+        uint64_to_hex(t->affinity, mask, 4);
+        prio_to_str(t, prio);
+        uint64_to_str(t->missed, missed);
+        uint64_to_str(t->frames, frames);
+        // con período: cuadros que pasaron el deadline sobre los terminados
+        const char *row[] = {
+            (int)t->id == self ? "  * " : "    ", id, "  ", stateName[t->state], "  ",
+            pct, "%  ", ms, "  ", sw, "  ", pre, "  ", cpu, "  ", mask, "  ", prio, "  ",
+            t->period_ms ? missed : "-", t->period_ms ? "/" : "", t->period_ms ? frames : "",
+            "  ", t->name, "\n"
+        };
+        print_parts(row, 25);
+    }
+    int_to_str(schedQuantum(0), q);
+    const char *foot[] = { "  quantum: ", q, " ticks\n" };
+    print_parts(foot, 3);
+}
+
+static void set_affinity(const char *args) {
+    char old[5], now[5];
+    if (args[0] < '0' || args[0] > '9') {
+        print("Usage: affinity <id> [mask]\n");
+        return;
+    }
+    int id = parse_int(args);
+    const char *rest = args;
+    while (*rest >= '0' && *rest <= '9')
+        rest++;
+    while (*rest == ' ')
+        rest++;
+
+    int64_t mask = *rest ? parse_hex(rest) : 0;
+    int prev = mask > 0 ? taskAffinity(id, (uint32_t)mask) : -1;
+    if (mask < 0 || (mask > 0 && prev < 0)) {
+        print("No such task, or no online CPU in the mask\n");
+        return;
+    }
+    int cur = taskAffinity(id, 0);
+    if (cur < 0) {
+        print("No such task\n");
+        return;
+    }
+    uint64_to_hex((uint32_t)cur, now, 4);
+    if (mask > 0) {
+        uint64_to_hex((uint32_t)prev, old, 4);
+        const char *msg[] = { "Affinity: 0x", old, " -> 0x", now, "\n" };
+        print_parts(msg, 5);
+    } else {
+        const char *msg[] = { "Affinity: 0x", now, "\n" };
+        print_parts(msg, 3);
+    }
+}
+
+static void set_realtime(const char *args) {
+    char old[12], now[12], ms[12];
+    if (args[0] < '0' || args[0] > '9') {
+        print("Usage: rt <id> <prio> [period_ms]\n");
+        return;
+    }
+    int id = parse_int(args);
+    const char *rest = args;
+    while (*rest >= '0' && *rest <= '9')
+        rest++;
+    while (*rest == ' ')
+        rest++;
+    if (*rest < '0' || *rest > '9') {
+        print("Usage: rt <id> <prio> [period_ms]\n");
+        return;
+    }
+    int prio = parse_int(rest);
+    while (*rest >= '0' && *rest <= '9')
+        rest++;
+    while (*rest == ' ')
+        rest++;
+    int period = (*rest >= '0' && *rest <= '9') ? parse_int(rest) : 0;
+
+    int prev = taskRealtime(id, prio, (uint32_t)period);
+    if (prev < 0) {
+        print("No such task, or priority not in 0-15\n");
+        return;
+    }
+    int_to_str(prev, old);
+    int_to_str(prio, now);
+    int_to_str(period, ms);
+    const char *msg[] = { "Priority: ", old, " -> ", now, prio && period ? ", frame " : "",
+                          prio && period ? ms : "", prio && period ? " ms" : "", "\n" };
+    print_parts(msg, 8);
+}
+
+// Dos lecturas de los contadores del scheduler separadas un segundo (el
+// shell duerme en el medio, así que el BSP cuenta casi todo como ocioso)
+static void print_cpu_load(void) {
+    static sched_cpu_stats_t before[MAX_CPUS], after[MAX_CPUS];
+    char cpu[4], pct[8], ready[12], sw[24], steals[24], task[12];
+
+    int n = getSchedCpuStats(before, MAX_CPUS);
+    taskSleep(1000);
+    if (getSchedCpuStats(after, MAX_CPUS) < n)
+        return;
+
+    print("  CPU  BUSY%  READY  SWITCHES/s  STEALS  RUNNING\n");
+    for (int i = 0; i < n; i++) {
+        uint64_t busy = after[i].busy_cycles - before[i].busy_cycles;
+        uint64_t idle = after[i].idle_cycles - before[i].idle_cycles;
+        int_to_str(after[i].cpu, cpu);
+        uint64_to_str(busy + idle ? busy * 100 / (busy + idle) : 0, pct);
+        int_to_str(after[i].ready, ready);
+        uint64_to_str(after[i].switches - before[i].switches, sw);
+        uint64_to_str(after[i].steals, steals);
+        int_to_str(after[i].current, task);
+        const char *row[] = {
+            "  ", cpu, "    ", pct, "%    ", ready, "      ", sw, "      ", steals, "    ", task, "\n"
+        };
+        print_parts(row, 13);
+    }
+}
+
 static void setUsername(const char *name) {
     if (name == NULL || name[0] == '\0') {
         username = "User";
@@ -240,6 +712,51 @@ static void commandProc(const char *line) {
         changeFontSize(2);
     else if (str_eq(line, "fontscale 3"))
         changeFontSize(3);
+    else if (starts_with(line, "irqmode")) {
+        const char *arg = get_arg(line, "irqmode");
+        int mode = IRQ_MODE_QUERY;
+        if (str_eq(arg, "pic")) mode = IRQ_MODE_PIC;
+        else if (str_eq(arg, "apic")) mode = IRQ_MODE_APIC;
+        int active = irqMode(mode);
+        if (active < 0)
+            print("Interrupt controller not available\n");
+        else
+            print(active == IRQ_MODE_APIC ? "IRQs via IOAPIC/LAPIC\n" : "IRQs via 8259 PIC\n");
+    }
+    else if (str_eq(line, "cpus"))
+        print_cpus();
+    else if (str_eq(line, "pool"))
+        print_pool_stats();
+    else if (str_eq(line, "interrupts"))
+        print_interrupts();
+    else if (str_eq(line, "meminfo"))
+        print_meminfo();
+    else if (starts_with(line, "vmmap"))
+        print_vmmap(get_arg(line, "vmmap"));
+    else if (starts_with(line, "profile "))
+        run_profiled(get_arg(line, "profile"));
+    else if (starts_with(line, "bg "))
+        run_background(get_arg(line, "bg"));
+    else if (str_eq(line, "ps"))
+        print_tasks();
+    else if (starts_with(line, "kill ")) {
+        const char *arg = get_arg(line, "kill");
+        if (arg[0] < '0' || arg[0] > '9' || !taskKill(parse_int(arg)))
+            print("No such task\n");
+    }
+    else if (starts_with(line, "affinity"))
+        set_affinity(get_arg(line, "affinity"));
+    else if (starts_with(line, "rt "))
+        set_realtime(get_arg(line, "rt"));
+    else if (str_eq(line, "cpuload"))
+        print_cpu_load();
+    else if (starts_with(line, "quantum")) {
+        const char *arg = get_arg(line, "quantum");
+        char q[12];
+        int_to_str(schedQuantum(arg[0] >= '0' && arg[0] <= '9' ? parse_int(arg) : 0), q);
+        const char *msg[] = { "Quantum: ", q, " ticks\n" };
+        print_parts(msg, 3);
+    }
     else if (str_eq(line, "playbeep")) {
         print("Playing beep sound...\n");
         playBeep(8, 220, 200);      //A
@@ -281,12 +798,51 @@ static void commandProc(const char *line) {
         }
     } else if (str_eq(line, "bench env")) {
         bench_env();
+    } else if (starts_with(line, "bench irq")) {
+        const char *arg = get_arg(line, "bench irq");
+        bench_irq(arg);
+    } else if (starts_with(line, "bench ipi")) {
+        const char *arg = get_arg(line, "bench ipi");
+        int iterations = 1000;
+        if (arg[0] >= '0' && arg[0] <= '9') {
+            iterations = parse_int(arg);
+        }
+        bench_ipi(iterations);
+    } else if (starts_with(line, "bench slab")) {
+        const char *arg = get_arg(line, "bench slab");
+        int iterations = 10000;
+        if (arg[0] >= '0' && arg[0] <= '9') {
+            iterations = parse_int(arg);
+        }
+        bench_slab(iterations);
+    } else if (starts_with(line, "bench mem")) {
+        const char *arg = get_arg(line, "bench mem");
+        int mib = 32;
+        if (arg[0] >= '0' && arg[0] <= '9') {
+            mib = parse_int(arg);
+        }
+        bench_mem(mib);
+    } else if (starts_with(line, "bench copy")) {
+        const char *arg = get_arg(line, "bench copy");
+        int mib = 32;
+        if (arg[0] >= '0' && arg[0] <= '9') {
+            mib = parse_int(arg);
+        }
+        bench_copy(mib);
+    } else if (str_eq(line, "bench str")) {
+        bench_str();
     } else if (str_eq(line, "bench")) {
         print("Benchmark commands:\n");
         print("  bench fps [seconds]  - FPS benchmark\n");
         print("  bench fpu [size]     - FPU benchmark (Mandelbrot)\n");
         print("  bench io [mode]      - I/O benchmark (kbd/fb/all)\n");
         print("  bench env            - Environment info\n");
+        print("  bench irq [mode]     - IRQ overhead (pic/apic/both)\n");
+        print("  bench ipi [n]        - Cross-core call latency\n");
+        print("  bench slab [n]       - Slab allocator cost\n");
+        print("  bench mem [MiB]      - Bandwidth / pointer chase per page size\n");
+        print("  bench copy [MiB]     - Kernel memcpy/memset bandwidth\n");
+        print("  bench str            - Userland string/memory library\n");
     } else
         print("Unknown command\n");
 }
@@ -1,28 +1,16 @@
 /* _loader.c */
 #include <stdint.h>
+#include "lib.h"
 
 extern char bss;
 extern char endOfBinary;
 
 int main();
 
-void * memset(void * destiny, int32_t c, uint64_t length);
-
 int _start() {
-	//Clean BSS
-	memset(&bss, 0, &endOfBinary - &bss);
+	//Clean BSS: el kernel lo deja de demanda en cero (o lo limpia él)
+	_sys_demand_zero(SYS_DEMAND_ZERO, &bss, &endOfBinary);
 
 	return main();
 
 }
-
-
-void * memset(void * destiation, int32_t c, uint64_t length) {
-	uint8_t chr = (uint8_t)c;
-	char * dst = (char*)destiation;
-
-	while(length--)
-		dst[length] = chr;
-
-	return destiation;
-}
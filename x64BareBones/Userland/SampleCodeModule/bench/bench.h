@@ -30,5 +30,40 @@ void bench_io(const char* mode);
  */
 void bench_env(void);
 
+/**
+ * @brief Mide el costo de cada interrupcion del timer detectando saltos del TSC
+ * @param mode "pic", "apic", "both" o "" (controlador actual)
+ */
+void bench_irq(const char *mode);
+
+/**
+ * @brief Mide la latencia ida y vuelta de smp_call_function hacia cada AP
+ * @param iterations Llamadas por CPU
+ */
+void bench_ipi(int iterations);
+
+/**
+ * @brief Mide pares alloc/free del slab del kernel y lista sus cachés
+ * @param iterations Pares por medición
+ */
+void bench_slab(int iterations);
+
+/**
+ * @brief Ancho de banda y pointer chase con cada modo de mapeo (1G/2M/4K)
+ * @param mib Tamaño del buffer en MiB
+ */
+void bench_mem(int mib);
+
+/**
+ * @brief Ancho de banda de memcpy/memset del kernel por rutina, de 16 B a 64 MiB
+ * @param mib Tamaño del buffer en MiB (el bloque más grande es la mitad)
+ */
+void bench_copy(int mib);
+
+/**
+ * @brief Ciclos por llamada de la libc de userland contra las versiones de a byte
+ */
+void bench_str(void);
+
 #endif // BENCH_H
 
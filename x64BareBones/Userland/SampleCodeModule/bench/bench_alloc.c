@@ -0,0 +1,54 @@
+#include "bench.h"
+#include "../lib.h"
+#include "../syscalls.h"
+
+#define MAX_ITERATIONS 1000000
+
+/**
+ * Benchmark del slab del kernel
+ * Pares kmem_cache_alloc/kmem_cache_free sobre kmalloc-64: con magazines por
+ * CPU (sin lock), sobre un caché sin magazines (lock + lista del slab) y de a
+ * lotes, que obliga a recargar y vaciar magazines.
+ */
+void bench_slab(int iterations) {
+    print("=== Slab Allocator Benchmark ===\n");
+
+    if (iterations <= 0) iterations = 10000;
+    if (iterations > MAX_ITERATIONS) iterations = MAX_ITERATIONS;
+
+    kmem_bench_t res;
+    slabBench(&res, iterations);
+
+    char iters[16], a[24], b[24], c[24];
+    int_to_str(iterations, iters);
+    uint64_to_str(res.magazine_pair, a);
+    uint64_to_str(res.slab_pair, b);
+    uint64_to_str(res.batch_pair, c);
+    const char *parts[] = {
+        "Pares por medicion: ", iters, "\n\n",
+        "  magazine (alloc+free):  ", a, " cyc\n",
+        "  slab sin magazine:      ", b, " cyc\n",
+        "  lotes de 64:            ", c, " cyc por par\n\n"
+    };
+    print_parts(parts, 12);
+
+    static kmem_stats_t caches[KMEM_MAX_CACHES];
+    int n = getSlabStats(caches, KMEM_MAX_CACHES);
+    print("  cache          size  objs/slab  slabs  active  cached  hits%\n");
+    for (int i = 0; i < n; i++) {
+        char size[12], per[12], slabs[12], active[24], cached[24], hits[8];
+        int_to_str((int)caches[i].obj_size, size);
+        int_to_str((int)caches[i].objs_per_slab, per);
+        int_to_str((int)caches[i].slabs, slabs);
+        uint64_to_str(caches[i].active, active);
+        uint64_to_str(caches[i].cached, cached);
+        uint64_t ops = caches[i].allocs + caches[i].frees;
+        int_to_str(ops ? (int)(caches[i].magazine_hits * 100 / ops) : 0, hits);
+        const char *row[] = {
+            "  ", caches[i].name, "  ", size, "  ", per, "  ", slabs,
+            "  ", active, "  ", cached, "  ", hits, "\n"
+        };
+        print_parts(row, 15);
+    }
+    print("\n=== Fin Benchmark ===\n\n");
+}
@@ -5,22 +5,67 @@
 #define SCREEN_WIDTH 1024
 #define SCREEN_HEIGHT 768
 
-// Helper para convertir uint64_t a string
-static void uint64_to_str_helper(uint64_t v, char *buf) {
-    char tmp[32];
-    int i = 0;
-    if (v == 0) {
-        buf[0] = '0';
-        buf[1] = 0;
-        return;
+// Offset con signo, escrito como "+N" o "-N"
+static void int64_to_str_signed(int64_t v, char *buf) {
+    if (v < 0) {
+        buf[0] = '-';
+        uint64_to_str((uint64_t)-v, buf + 1);
+    } else {
+        buf[0] = '+';
+        uint64_to_str((uint64_t)v, buf + 1);
+    }
+}
+
+// Offsets del TSC por core medidos por el kernel al arrancar.
+// Devuelve el mayor |offset| y deja en *monotonic si tsc_now() no retrocedió
+// entre cores en el test de warps.
+static uint64_t print_tsc_sync(int *monotonic) {
+    tsc_sync_t sync[MAX_CPUS];
+    char buf[32];
+    uint64_t max_skew = 0;
+    int n = getTscSync(sync, MAX_CPUS);
+
+    *monotonic = 1;
+    print("--- TSC Sync (vs BSP) ---\n");
+    print("CPU  APIC  Offset(cyc)    RTT(cyc)  Warps raw/corr\n");
+    for (int i = 0; i < n; i++) {
+        int64_to_str_signed(sync[i].offset, buf);
+        char cpu[8], apic[8], rtt[24], raw[24], corr[24];
+        int_to_str((int)sync[i].cpu, cpu);
+        int_to_str((int)sync[i].apic_id, apic);
+        uint64_to_str(sync[i].rtt, rtt);
+        uint64_to_str(sync[i].warps_raw, raw);
+        uint64_to_str(sync[i].warps_corrected, corr);
+        print(cpu);
+        print(i == 0 ? " (BSP) " : "       ");
+        print(apic);
+        print("     ");
+        print(buf);
+        print("     ");
+        print(rtt);
+        print("     ");
+        print(raw);
+        print("/");
+        print(corr);
+        print("\n");
+
+        uint64_t skew = sync[i].offset < 0 ? (uint64_t)-sync[i].offset : (uint64_t)sync[i].offset;
+        if (skew > max_skew) max_skew = skew;
+        if (sync[i].warps_corrected != 0) *monotonic = 0;
     }
-    while (v > 0) {
-        tmp[i++] = '0' + (v % 10);
-        v /= 10;
+    if (n <= 1) {
+        print("(un solo CPU: no hay skew que medir)\n");
     }
-    int len = 0;
-    while (i > 0) buf[len++] = tmp[--i];
-    buf[len] = 0;
+
+    print("Max skew:           ");
+    uint64_to_str(max_skew, buf);
+    print(buf);
+    print(" cycles\n");
+    print("Cross-core monotonic: ");
+    print(*monotonic ? "YES" : "NO");
+    print(" (bench_start/stop usan el TSC corregido;\n");
+    print("                      error residual <= RTT/2 por core)\n\n");
+    return max_skew;
 }
 
 void bench_env(void) {
@@ -55,16 +100,19 @@ void bench_env(void) {
     // Frecuencia TSC
     uint64_t freq = get_tsc_freq();
     print("TSC Frequency:      ");
-    uint64_to_str_helper(freq, buf);
+    uint64_to_str(freq, buf);
     print(buf);
     print(" Hz\n");
     
     // Estimar frecuencia en GHz
     uint64_t freq_mhz = freq / 1000000;
     print("                    ~");
-    uint64_to_str_helper(freq_mhz, buf);
+    uint64_to_str(freq_mhz, buf);
     print(buf);
     print(" MHz\n\n");
+
+    int monotonic;
+    uint64_t max_skew = print_tsc_sync(&monotonic);
     
     // Detección de entorno virtualizado (heurística)
     print("--- Environment ---\n");
@@ -86,7 +134,7 @@ void bench_env(void) {
     
     print("Entorno:            [Manual: QEMU/VBox/PC1/PC2]\n");
     print("TSC Freq:           ");
-    uint64_to_str_helper(freq, buf);
+    uint64_to_str(freq, buf);
     print(buf);
     print(" Hz\n");
     print("Resolution:         ");
@@ -99,6 +147,10 @@ void bench_env(void) {
     print("Invariant TSC:      ");
     print(inv_tsc ? "YES" : "NO");
     print("\n");
+    print("TSC Skew:           ");
+    uint64_to_str(max_skew, buf);
+    print(buf);
+    print(monotonic ? " cycles (monotonic)\n" : " cycles (NOT monotonic)\n");
     
     print("\n=== Fin Detection ===\n\n");
 }
@@ -1,6 +1,7 @@
 #include "bench.h"
 #include "../lib.h"
 #include "../syscalls.h"
+#include "../malloc.h"
 
 #define SYS_DRAW_RECT 4
 #define SYS_SLEEP 3
@@ -8,24 +9,6 @@
 #define SCREEN_WIDTH 1024
 #define SCREEN_HEIGHT 768
 
-// Helper para convertir uint64_t a string
-static void uint64_to_str_helper(uint64_t v, char *buf) {
-    char tmp[32];
-    int i = 0;
-    if (v == 0) {
-        buf[0] = '0';
-        buf[1] = 0;
-        return;
-    }
-    while (v > 0) {
-        tmp[i++] = '0' + (v % 10);
-        v /= 10;
-    }
-    int len = 0;
-    while (i > 0) buf[len++] = tmp[--i];
-    buf[len] = 0;
-}
-
 void bench_fps(int seconds) {
     print("=== FPS Benchmark ===\n");
     print("Dibujando rectangulos durante ");
@@ -40,26 +23,29 @@ void bench_fps(int seconds) {
     // Asumimos ~18.2 ticks/segundo
     uint64_t target_ticks = seconds * 18;
     
-    #define MAX_FRAMES 1000
-    uint64_t frame_times[MAX_FRAMES];
+    // Historial de frames sin límite: crece al doble con realloc
+    int frame_capacity = 256;
+    uint64_t *frame_times = malloc(frame_capacity * sizeof(uint64_t));
     int frame_count = 0;
+    if (frame_times == 0) {
+        print("Sin memoria para el historial de frames\n");
+        return;
+    }
     
     uint64_t start_time = bench_start();
     uint64_t start_tick = _sys_get_ticks(5);
     
     // Loop de dibujado
-    while ((_sys_get_ticks(5) - start_tick) < target_ticks && frame_count < MAX_FRAMES) {
+    while ((_sys_get_ticks(5) - start_tick) < target_ticks) {
         uint64_t frame_start = bench_start();
         
         clearScreen();
         
         // Texto informativo (arriba a la izquierda)
-        print("=== FPS Benchmark en progreso ===\n");
-        print("Frame: ");
         char frame_buf[16];
         int_to_str(frame_count + 1, frame_buf);
-        print(frame_buf);
-        print("\n\n");
+        const char *overlay[] = { "=== FPS Benchmark en progreso ===\n", "Frame: ", frame_buf, "\n\n" };
+        print_parts(overlay, 4);
         
         // Dibujar rectángulos a la DERECHA y ABAJO del texto
         // Desde x=400 para no tapar texto
@@ -74,7 +60,14 @@ void bench_fps(int seconds) {
         // Pequeño delay para simular frame rate real
         _sys_sleep(SYS_SLEEP, 1);
         
-        frame_times[frame_count++] = bench_stop(frame_start);
+        uint64_t frame_cycles = bench_stop(frame_start);
+        if (frame_count == frame_capacity) {
+            uint64_t *grown = realloc(frame_times, 2 * frame_capacity * sizeof(uint64_t));
+            if (grown == 0) break;
+            frame_times = grown;
+            frame_capacity *= 2;
+        }
+        frame_times[frame_count++] = frame_cycles;
     }
     
     uint64_t total_time = bench_stop(start_time);
@@ -84,6 +77,7 @@ void bench_fps(int seconds) {
     // Calcular estadísticas
     if (frame_count == 0) {
         print("No se pudieron medir frames\n");
+        free(frame_times);
         return;
     }
     
@@ -120,6 +114,7 @@ void bench_fps(int seconds) {
         }
         stddev_cycles = x;
     }
+    free(frame_times);
     
     // Calcular FPS
     int fps_total = 0;
@@ -131,12 +126,12 @@ void bench_fps(int seconds) {
     print("=== Resultados FPS Benchmark ===\n\n");
     
     print("Frames totales:     ");
-    uint64_to_str_helper(frame_count, buf);
+    uint64_to_str(frame_count, buf);
     print(buf);
     print("\n");
     
     print("Tiempo total:       ");
-    uint64_to_str_helper(total_ms, buf);
+    uint64_to_str(total_ms, buf);
     print(buf);
     print(" ms\n");
     
@@ -146,25 +141,25 @@ void bench_fps(int seconds) {
     print(" fps\n");
     
     print("Frame avg:          ");
-    uint64_to_str_helper(avg_ms, buf);
+    uint64_to_str(avg_ms, buf);
     print(buf);
     print(" ms (");
-    uint64_to_str_helper(avg_cycles, buf);
+    uint64_to_str(avg_cycles, buf);
     print(buf);
     print(" cycles)\n");
     
     print("Frame min:          ");
-    uint64_to_str_helper(cycles_to_ms(min_cycles), buf);
+    uint64_to_str(cycles_to_ms(min_cycles), buf);
     print(buf);
     print(" ms\n");
     
     print("Frame max:          ");
-    uint64_to_str_helper(cycles_to_ms(max_cycles), buf);
+    uint64_to_str(cycles_to_ms(max_cycles), buf);
     print(buf);
     print(" ms\n");
     
     print("StdDev:             ");
-    uint64_to_str_helper(cycles_to_ms(stddev_cycles), buf);
+    uint64_to_str(cycles_to_ms(stddev_cycles), buf);
     print(buf);
     print(" ms\n");
     
@@ -1,24 +1,7 @@
 #include "bench.h"
 #include "../lib.h"
 #include "../syscalls.h"
-
-// Helper para convertir uint64_t a string
-static void uint64_to_str_helper(uint64_t v, char *buf) {
-    char tmp[32];
-    int i = 0;
-    if (v == 0) {
-        buf[0] = '0';
-        buf[1] = 0;
-        return;
-    }
-    while (v > 0) {
-        tmp[i++] = '0' + (v % 10);
-        v /= 10;
-    }
-    int len = 0;
-    while (i > 0) buf[len++] = tmp[--i];
-    buf[len] = 0;
-}
+#include "../malloc.h"
 
 /**
  * Calcula iteraciones de Mandelbrot para un punto complejo (x0, y0)
@@ -39,12 +22,45 @@ static int mandelbrot_iterations(double x0, double y0, int max_iter) {
     return iteration;
 }
 
+typedef struct {
+    int size;
+    int max_iter;
+    uint64_t *row_iters;            // una entrada por fila: sin estado compartido
+} mandel_ctx_t;
+
+// Cuerpo del parallel_for: filas [start, end) de la grilla. Corre también en
+// los APs, así que no hace syscalls.
+static void mandelbrot_rows(uint64_t start, uint64_t end, void *arg) {
+    mandel_ctx_t *ctx = (mandel_ctx_t *)arg;
+    int size = ctx->size;
+
+    for (uint64_t py = start; py < end; py++) {
+        uint64_t iters = 0;
+        for (int px = 0; px < size; px++) {
+            // Mapear coordenadas de pixel a plano complejo
+            // x: [-2.5, 1.0], y: [-1.0, 1.0]
+            double x0 = -2.5 + (3.5 * px) / size;
+            double y0 = -1.0 + (2.0 * (int)py) / size;
+            iters += mandelbrot_iterations(x0, y0, ctx->max_iter);
+        }
+        ctx->row_iters[py] = iters;
+    }
+}
+
+static mandel_ctx_t ctx;
+
 void bench_fpu(int size) {
     print("=== FPU Benchmark (Mandelbrot Set) ===\n");
     char buf[32];
     
     if (size <= 0) size = 256;
-    if (size > 1024) size = 1024; // Límite razonable
+
+    // La grilla sale del heap: el tamaño solo lo limita la memoria
+    ctx.row_iters = malloc((uint64_t)size * sizeof(uint64_t));
+    if (ctx.row_iters == 0) {
+        print("Sin memoria para la grilla\n");
+        return;
+    }
     
     print("Grid size: ");
     int_to_str(size, buf);
@@ -69,19 +85,9 @@ void bench_fpu(int size) {
         uint64_t start = bench_start();
         
         // Calcular Mandelbrot set
-        uint64_t total_iterations = 0;
-        
-        for (int py = 0; py < size; py++) {
-            for (int px = 0; px < size; px++) {
-                // Mapear coordenadas de pixel a plano complejo
-                // x: [-2.5, 1.0], y: [-1.0, 1.0]
-                double x0 = -2.5 + (3.5 * px) / size;
-                double y0 = -1.0 + (2.0 * py) / size;
-                
-                int iters = mandelbrot_iterations(x0, y0, max_iterations);
-                total_iterations += iters;
-            }
-        }
+        ctx.size = size;
+        ctx.max_iter = max_iterations;
+        mandelbrot_rows(0, size, &ctx);
         
         run_times[run] = bench_stop(start);
         
@@ -89,7 +95,7 @@ void bench_fpu(int size) {
         int_to_str(run + 1, buf);
         print(buf);
         print(": ");
-        uint64_to_str_helper(cycles_to_ms(run_times[run]), buf);
+        uint64_to_str(cycles_to_ms(run_times[run]), buf);
         print(buf);
         print(" ms\n");
     }
@@ -123,29 +129,59 @@ void bench_fpu(int size) {
     print("\n=== Resultados FPU Benchmark ===\n\n");
     
     print("Operaciones FP:     ~");
-    uint64_to_str_helper(total_ops / 1000000, buf);
+    uint64_to_str(total_ops / 1000000, buf);
     print(buf);
     print(" millones\n");
     
     print("Tiempo promedio:    ");
-    uint64_to_str_helper(avg_ms, buf);
+    uint64_to_str(avg_ms, buf);
     print(buf);
     print(" ms\n");
     
     print("Tiempo minimo:      ");
-    uint64_to_str_helper(cycles_to_ms(min_cycles), buf);
+    uint64_to_str(cycles_to_ms(min_cycles), buf);
     print(buf);
     print(" ms\n");
     
     print("Tiempo maximo:      ");
-    uint64_to_str_helper(cycles_to_ms(max_cycles), buf);
+    uint64_to_str(cycles_to_ms(max_cycles), buf);
     print(buf);
     print(" ms\n");
     
     print("MFLOPS (aprox):     ");
-    uint64_to_str_helper(mflops, buf);
+    uint64_to_str(mflops, buf);
     print(buf);
     print("\n");
+
+    // Mismas filas repartidas entre todos los CPUs con work stealing
+    uint64_t par_total = 0;
+    int cpus = 1;
+    for (int run = 0; run < NUM_RUNS; run++) {
+        uint64_t start = bench_start();
+        cpus = parallelFor(0, size, 2, mandelbrot_rows, &ctx);
+        par_total += bench_stop(start);
+    }
+    uint64_t par_avg = par_total / NUM_RUNS;
+
+    print("\n=== Paralelo (parallel_for) ===\n\n");
+
+    print("CPUs:               ");
+    int_to_str(cpus, buf);
+    print(buf);
+    print("\n");
+
+    print("Tiempo promedio:    ");
+    uint64_to_str(cycles_to_ms(par_avg), buf);
+    print(buf);
+    print(" ms\n");
+
+    print("Speedup (x100):     ");
+    uint64_to_str(par_avg ? avg_cycles * 100 / par_avg : 0, buf);
+    print(buf);
+    print("\n");
+
+    free(ctx.row_iters);
+    ctx.row_iters = 0;
     
     print("\n=== Fin Benchmark ===\n\n");
 }
@@ -8,36 +8,16 @@
 #define SCREEN_WIDTH 1024
 #define SCREEN_HEIGHT 768
 
-// Helper para convertir uint64_t a string
-static void uint64_to_str_helper(uint64_t v, char *buf) {
-    char tmp[32];
-    int i = 0;
-    if (v == 0) {
-        buf[0] = '0';
-        buf[1] = 0;
-        return;
-    }
-    while (v > 0) {
-        tmp[i++] = '0' + (v % 10);
-        v /= 10;
-    }
-    int len = 0;
-    while (i > 0) buf[len++] = tmp[--i];
-    buf[len] = 0;
-}
-
-// Usar la función str_eq de lib.h (ya está declarada)
-extern int str_eq(const char *a, const char *b);
-
 /**
  * Benchmark de latencia de teclado
- * Mide el tiempo desde que el usuario presiona una tecla hasta que
- * la recibimos en userland
+ * Mide el tiempo desde que el IRQ de teclado encola la tecla hasta que
+ * la recibimos en userland. El read es bloqueante (la CPU queda en hlt),
+ * asi que se mide la latencia real de wake-up y no el costo del polling.
  */
 static void bench_keyboard_latency(void) {
     print("=== Keyboard Latency Benchmark ===\n");
     print("Presiona 10 teclas rapido...\n");
-    print("(El benchmark mide el tiempo de respuesta)\n\n");
+    print("(El benchmark mide IRQ -> retorno del read bloqueante)\n\n");
     
     #define NUM_SAMPLES 10
     uint64_t samples[NUM_SAMPLES];
@@ -48,22 +28,17 @@ static void bench_keyboard_latency(void) {
     while (_sys_read(SYS_READ, 0, &c, 1) > 0);
     
     while (sample_count < NUM_SAMPLES) {
-        // Esperar a que haya una tecla disponible
-        uint64_t start = bench_start();
-        
-        // Busy-wait hasta que read retorne algo
-        while (_sys_read(SYS_READ, 0, &c, 1) == 0) {
-            // Nota: Esto mide la latencia desde que llamamos read
-            // hasta que obtenemos la tecla. No es la latencia real del IRQ,
-            // pero da una aproximación del overhead del sistema
+        // Dormir en el kernel hasta que haya una tecla disponible
+        if (read_blocking(&c, 1) == 0) {
+            continue;
         }
+        uint64_t now = bench_start();
+        uint64_t irq_tsc = _sys_kbd_last_tsc(SYS_KBD_LAST_TSC);
         
-        uint64_t cycles = bench_stop(start);
-        samples[sample_count++] = cycles;
+        samples[sample_count++] = (now > irq_tsc) ? now - irq_tsc : 0;
         
         printChar(c);
     }
-    
     print("\n\n");
     
     // Calcular estadísticas
@@ -82,28 +57,38 @@ static void bench_keyboard_latency(void) {
     char buf[32];
     
     print("Samples:            ");
-    uint64_to_str_helper(NUM_SAMPLES, buf);
+    uint64_to_str(NUM_SAMPLES, buf);
     print(buf);
     print("\n");
     
     print("Latencia promedio:  ");
-    uint64_to_str_helper(cycles_to_us(avg), buf);
+    uint64_to_str(cycles_to_us(avg), buf);
     print(buf);
     print(" us (");
-    uint64_to_str_helper(avg, buf);
+    uint64_to_str(avg, buf);
     print(buf);
     print(" cycles)\n");
     
     print("Latencia min:       ");
-    uint64_to_str_helper(cycles_to_us(min_val), buf);
+    uint64_to_str(cycles_to_us(min_val), buf);
     print(buf);
     print(" us\n");
     
     print("Latencia max:       ");
-    uint64_to_str_helper(cycles_to_us(max_val), buf);
+    uint64_to_str(cycles_to_us(max_val), buf);
     print(buf);
     print(" us\n");
     
+    uint64_t overflows, dropped;
+    kbdRingStats(&overflows, &dropped);
+    print("Ring overflows:     ");
+    uint64_to_str(overflows, buf);
+    print(buf);
+    print(" (");
+    uint64_to_str(dropped, buf);
+    print(buf);
+    print(" teclas descartadas)\n");
+    
     print("\n");
 }
 
@@ -168,27 +153,27 @@ static void bench_framebuffer_bandwidth(void) {
     print(" pixels\n");
     
     print("Iteraciones:        ");
-    uint64_to_str_helper(NUM_ITERS, buf);
+    uint64_to_str(NUM_ITERS, buf);
     print(buf);
     print("\n");
     
     print("Tiempo promedio:    ");
-    uint64_to_str_helper(avg_us, buf);
+    uint64_to_str(avg_us, buf);
     print(buf);
     print(" us\n");
     
     print("Tiempo min:         ");
-    uint64_to_str_helper(cycles_to_us(min_val), buf);
+    uint64_to_str(cycles_to_us(min_val), buf);
     print(buf);
     print(" us\n");
     
     print("Tiempo max:         ");
-    uint64_to_str_helper(cycles_to_us(max_val), buf);
+    uint64_to_str(cycles_to_us(max_val), buf);
     print(buf);
     print(" us\n");
     
     print("Ancho de banda:     ~");
-    uint64_to_str_helper(bandwidth_mbps, buf);
+    uint64_to_str(bandwidth_mbps, buf);
     print(buf);
     print(" MB/s\n");
     
@@ -213,7 +198,7 @@ void bench_io(const char* mode) {
         bench_keyboard_latency();
         print("Presiona una tecla para continuar...\n");
         char c;
-        while (_sys_read(SYS_READ, 0, &c, 1) == 0);
+        read_blocking(&c, 1);
         clearScreen();
         bench_framebuffer_bandwidth();
     }
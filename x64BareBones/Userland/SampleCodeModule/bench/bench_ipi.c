@@ -0,0 +1,43 @@
+#include "bench.h"
+#include "../lib.h"
+#include "../syscalls.h"
+
+#define MAX_ITERATIONS 100000
+
+/**
+ * Benchmark de llamadas entre cores
+ * El kernel llama a una función vacía en cada AP con smp_call_function y
+ * espera la respuesta: mide IPI + despertar del AP + mailbox + vuelta.
+ */
+void bench_ipi(int iterations) {
+    print("=== Cross-core Call Benchmark (IPI + mailbox) ===\n");
+
+    if (iterations <= 0) iterations = 1000;
+    if (iterations > MAX_ITERATIONS) iterations = MAX_ITERATIONS;
+
+    ipi_latency_t results[MAX_CPUS];
+    int n = ipiBench(results, MAX_CPUS, iterations);
+    if (n == 0) {
+        print("No hay otros CPUs online\n\n");
+        return;
+    }
+
+    char iters[16], cpu[12], apic[12], min[24], avg[24], max[24], us[24];
+    int_to_str(iterations, iters);
+    const char *head[] = { "Llamadas por CPU:   ", iters, "\n\n", "  CPU  APIC   MIN cyc   AVG cyc   MAX cyc   AVG us\n" };
+    print_parts(head, 4);
+
+    for (int i = 0; i < n; i++) {
+        int_to_str(results[i].cpu, cpu);
+        int_to_str(results[i].apic_id, apic);
+        uint64_to_str(results[i].min_cycles, min);
+        uint64_to_str(results[i].avg_cycles, avg);
+        uint64_to_str(results[i].max_cycles, max);
+        uint64_to_str(cycles_to_us(results[i].avg_cycles), us);
+        const char *row[] = {
+            "  ", cpu, "    ", apic, "    ", min, "   ", avg, "   ", max, "   ", us, "\n"
+        };
+        print_parts(row, 13);
+    }
+    print("\n=== Fin Benchmark ===\n\n");
+}
@@ -0,0 +1,102 @@
+#include "bench.h"
+#include "../lib.h"
+#include "../syscalls.h"
+
+#define SYS_GET_TICKS 5
+
+#define CALIBRATION_ITERS 10000
+#define MAX_GAPS 256
+#define MEASURE_TICKS 36      // ~2 segundos a 18.2 Hz
+
+// rdtsc directo: aca no sirve bench_start() porque cada syscall es otra interrupcion
+static inline uint64_t read_tsc(void) {
+    uint32_t lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/**
+ * Benchmark de overhead de IRQ
+ * Un loop lee el TSC continuamente; cada vez que el salto entre dos lecturas
+ * supera el umbral calibrado es porque nos interrumpieron. El tamaño del
+ * salto es el costo completo de la interrupcion (entrada, handler, EOI, iretq).
+ * Mientras corre no hay que tocar el teclado: solo se ve el timer (IRQ0).
+ */
+static void measure_irq_overhead(void) {
+    print("Controlador:        ");
+    print(irqMode(IRQ_MODE_QUERY) == IRQ_MODE_APIC ? "IOAPIC/LAPIC\n" : "8259 PIC\n");
+
+    // Calibrar el costo de una vuelta del loop sin interrupciones
+    uint64_t min_delta = (uint64_t)-1;
+    uint64_t prev = read_tsc();
+    for (int i = 0; i < CALIBRATION_ITERS; i++) {
+        uint64_t now = read_tsc();
+        if (now - prev < min_delta) min_delta = now - prev;
+        prev = now;
+    }
+    uint64_t threshold = min_delta * 8 + 100;
+
+    static uint64_t gaps[MAX_GAPS];
+    int gap_count = 0;
+
+    uint64_t start_tick = _sys_get_ticks(SYS_GET_TICKS);
+    prev = read_tsc();
+    while (gap_count < MAX_GAPS) {
+        uint64_t now = read_tsc();
+        uint64_t delta = now - prev;
+        if (delta > threshold) {
+            // el propio get_ticks es una interrupcion: se consulta solo despues de un salto
+            gaps[gap_count++] = delta - min_delta;
+            if (_sys_get_ticks(SYS_GET_TICKS) - start_tick >= MEASURE_TICKS)
+                break;
+            now = read_tsc();
+        }
+        prev = now;
+    }
+
+    if (gap_count == 0) {
+        print("No se detectaron interrupciones\n");
+        return;
+    }
+
+    char buf[32];
+
+    print("Umbral:             ");
+    uint64_to_str(threshold, buf);
+    print(buf);
+    print(" cycles\n");
+
+    print("Interrupciones:     ");
+    uint64_to_str(gap_count, buf);
+    print(buf);
+    print("\n\n");
+
+    print_stats("IRQ overhead (entrada -> iretq)", gaps, gap_count);
+}
+
+static void run_with_mode(int mode) {
+    if (irqMode(mode) != mode) {
+        print(mode == IRQ_MODE_APIC ? "APIC no disponible\n\n" : "PIC no disponible\n\n");
+        return;
+    }
+    measure_irq_overhead();
+}
+
+void bench_irq(const char *mode) {
+    print("=== IRQ Overhead Benchmark ===\n");
+    print("No presiones teclas mientras mide...\n\n");
+
+    if (str_eq(mode, "pic")) {
+        run_with_mode(IRQ_MODE_PIC);
+    } else if (str_eq(mode, "apic")) {
+        run_with_mode(IRQ_MODE_APIC);
+    } else if (str_eq(mode, "both")) {
+        // compara ambos caminos y deja el controlador como estaba
+        int previous = irqMode(IRQ_MODE_QUERY);
+        run_with_mode(IRQ_MODE_PIC);
+        run_with_mode(IRQ_MODE_APIC);
+        irqMode(previous);
+    } else {
+        measure_irq_overhead();
+    }
+}
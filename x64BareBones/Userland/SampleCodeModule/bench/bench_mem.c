@@ -0,0 +1,288 @@
+#include "bench.h"
+#include "../lib.h"
+#include "../syscalls.h"
+#include "../malloc.h"
+
+#define MEM_DEFAULT_MIB 32
+#define MEM_MAX_MIB     60
+#define BW_PASSES       4
+#define CHASE_HOPS      (1 << 20)
+#define CHASE_SIZES     3
+#define PAGE_BYTES      4096
+#define LINE_BYTES      64
+
+static volatile uint64_t sink;
+static uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t rng_next(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+// MiB/s sin pasar por números de 128 bits: (bytes / 1K) * (Hz / 1K) / ciclos
+static uint64_t mib_per_s(uint64_t bytes, uint64_t cycles) {
+    uint64_t freq = get_tsc_freq();
+    if (cycles == 0 || freq == 0)
+        return 0;
+    return (bytes >> 10) * (freq >> 10) / cycles;
+}
+
+static uint64_t measure_read(const uint64_t *buf, uint64_t words) {
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    uint64_t start = bench_start();
+    for (int p = 0; p < BW_PASSES; p++) {
+        for (uint64_t i = 0; i < words; i += 4) {
+            s0 += buf[i];
+            s1 += buf[i + 1];
+            s2 += buf[i + 2];
+            s3 += buf[i + 3];
+        }
+    }
+    uint64_t cycles = bench_stop(start);
+    sink = s0 + s1 + s2 + s3;
+    return cycles;
+}
+
+static uint64_t measure_write(uint64_t *buf, uint64_t words) {
+    uint64_t start = bench_start();
+    for (int p = 0; p < BW_PASSES; p++) {
+        for (uint64_t i = 0; i < words; i++)
+            buf[i] = i + p;
+    }
+    return bench_stop(start);
+}
+
+// Copia la primera mitad del buffer sobre la segunda
+static uint64_t measure_copy(uint64_t *buf, uint64_t words) {
+    uint64_t half = words / 2;
+    uint64_t start = bench_start();
+    for (int p = 0; p < BW_PASSES; p++) {
+        for (uint64_t i = 0; i < half; i++)
+            buf[half + i] = buf[i];
+    }
+    return bench_stop(start);
+}
+
+static void **chain_node(uint8_t *buf, uint64_t page) {
+    return (void **)(buf + page * PAGE_BYTES + (page % (PAGE_BYTES / LINE_BYTES)) * LINE_BYTES);
+}
+
+// Ciclo aleatorio (Sattolo) sobre las primeras pages páginas, un nodo por
+// página y cada uno en una línea distinta para no caer siempre en el mismo set
+static void **build_chain(uint8_t *buf, uint32_t *perm, uint64_t pages) {
+    for (uint64_t i = 0; i < pages; i++)
+        perm[i] = (uint32_t)i;
+    for (uint64_t i = pages - 1; i > 0; i--) {
+        uint64_t j = rng_next() % i;
+        uint32_t tmp = perm[i];
+        perm[i] = perm[j];
+        perm[j] = tmp;
+    }
+    for (uint64_t i = 0; i < pages; i++)
+        *chain_node(buf, perm[i]) = chain_node(buf, perm[(i + 1) % pages]);
+    return chain_node(buf, perm[0]);
+}
+
+// Ciclos por salto: cada carga depende de la anterior y cae en otra página
+static uint64_t chase(void **start, uint64_t warmup) {
+    void **p = start;
+    for (uint64_t i = 0; i < warmup; i++)
+        p = (void **)*p;
+
+    uint64_t t = bench_start();
+    for (uint64_t i = 0; i < CHASE_HOPS; i++)
+        p = (void **)*p;
+    uint64_t cycles = bench_stop(t);
+    sink = (uint64_t)p;
+    return cycles / CHASE_HOPS;
+}
+
+static const char *page_kind_of(const void *addr) {
+    static paging_info_t info;
+    static const char *kindName[PAGE_KINDS] = { "4K", "2M", "1G" };
+    uint64_t a = (uint64_t)addr;
+
+    getPagingInfo(&info);
+    for (uint32_t i = 0; i < info.run_count && i < PAGING_MAX_RUNS; i++) {
+        if (a >= info.runs[i].start && a < info.runs[i].end)
+            return kindName[info.runs[i].kind];
+    }
+    return "?";
+}
+
+/**
+ * Benchmark de memoria y TLB
+ * Ancho de banda (lectura, escritura, copia) y latencia de un pointer chase
+ * con un salto por página sobre un buffer del heap, con cada modo de mapeo
+ * del kernel: páginas de 1 GiB donde se pueda, solo 2 MiB y el heap de
+ * userland con páginas de 4 KiB. La diferencia en el chase es el costo de
+ * los misses de TLB (page walks) cuando el buffer excede el alcance de la TLB.
+ */
+void bench_mem(int mib) {
+    static const int modes[] = { PAGING_MODE_DEFAULT, PAGING_MODE_2M, PAGING_MODE_4K_HEAP };
+    static const char *modeName[] = { "default", "2M only", "4K heap" };
+
+    print("=== Memory / TLB Benchmark ===\n");
+
+    int original = setPagingMode(PAGING_MODE_QUERY);
+    if (original < 0) {
+        print("Kernel page tables not available\n");
+        return;
+    }
+
+    if (mib <= 0) mib = MEM_DEFAULT_MIB;
+    if (mib > MEM_MAX_MIB) mib = MEM_MAX_MIB;
+
+    uint8_t *raw = 0;
+    while (mib >= 1 && (raw = malloc(((uint64_t)mib << 20) + PAGE_BYTES)) == 0)
+        mib /= 2;
+    uint64_t bytes = (uint64_t)mib << 20;
+    uint64_t pages = bytes / PAGE_BYTES;
+    uint32_t *perm = raw ? malloc(pages * sizeof(uint32_t)) : 0;
+    if (perm == 0) {
+        free(raw);
+        print("Not enough memory for the buffer\n");
+        return;
+    }
+    uint8_t *buf = (uint8_t *)(((uint64_t)raw + PAGE_BYTES - 1) & ~(uint64_t)(PAGE_BYTES - 1));
+    uint64_t words = bytes / sizeof(uint64_t);
+
+    uint64_t chasePages[CHASE_SIZES] = { pages / 32, pages / 4, pages };
+    char a[24], b[24], c[24];
+    int_to_str(mib, a);
+    uint64_to_str(chasePages[0] * 4, b);
+    uint64_to_str(chasePages[1] * 4, c);
+    const char *head[] = {
+        "Buffer: ", a, " MiB, ", "chase sets: ", b, " KiB / ", c, " KiB / ", a, " MiB\n\n",
+        "  mode     page  read MiB/s  write MiB/s  copy MiB/s  chase cyc/hop\n"
+    };
+    print_parts(head, 11);
+
+    for (int m = 0; m < 3; m++) {
+        if (setPagingMode(modes[m]) != modes[m]) {
+            const char *na[] = { "  ", modeName[m], "  not available\n" };
+            print_parts(na, 3);
+            continue;
+        }
+
+        char rd[24], wr[24], cp[24], ch[CHASE_SIZES][24];
+        uint64_to_str(mib_per_s(bytes * BW_PASSES, measure_read((uint64_t *)buf, words)), rd);
+        uint64_to_str(mib_per_s(bytes * BW_PASSES, measure_write((uint64_t *)buf, words)), wr);
+        uint64_to_str(mib_per_s(bytes / 2 * BW_PASSES, measure_copy((uint64_t *)buf, words)), cp);
+        for (int s = 0; s < CHASE_SIZES; s++) {
+            uint64_t n = chasePages[s] ? chasePages[s] : 1;
+            void **start = build_chain(buf, perm, n);
+            uint64_to_str(chase(start, n), ch[s]);
+        }
+
+        const char *row[] = {
+            "  ", modeName[m], "  ", page_kind_of(buf), "    ", rd, "       ", wr,
+            "        ", cp, "      ", ch[0], " / ", ch[1], " / ", ch[2]
+        };
+        print_parts(row, 16);
+        print("\n");
+    }
+
+    setPagingMode(original);
+    free(perm);
+    free(raw);
+    print("\n  page = page size backing the buffer in that mode\n");
+    print("\n=== Fin Benchmark ===\n\n");
+}
+
+#define COPY_DEFAULT_MIB 32
+#define COL_WIDTH        9
+
+// Valor alineado a la derecha en COL_WIDTH columnas ("-" si no se midió)
+static void format_col(char *out, uint64_t value, int valid) {
+    char num[24];
+    int len;
+    if (valid) {
+        len = uint64_to_str(value, num);
+    } else {
+        num[0] = '-';
+        num[1] = '\0';
+        len = 1;
+    }
+    int pad = COL_WIDTH - len;
+    int i = 0;
+    while (pad-- > 0)
+        out[i++] = ' ';
+    for (int j = 0; j <= len; j++)
+        out[i++] = num[j];
+}
+
+static void format_size(char *out, uint64_t size) {
+    static const char *unit[] = { " B", " KiB", " MiB" };
+    int u = 0;
+    while (size >= 1024 && u < 2) {
+        size /= 1024;
+        u++;
+    }
+    int len = uint64_to_str(size, out);
+    const char *s = unit[u];
+    while (*s)
+        out[len++] = *s++;
+    while (len < 8)
+        out[len++] = ' ';
+    out[len] = '\0';
+}
+
+static void print_copy_table(const mem_bench_t *res, int fill) {
+    print(fill ? "  memset MiB/s\n" : "  memcpy MiB/s\n");
+    print("  size          auto    bytes    words      rep     simd       nt\n");
+    for (uint32_t i = 0; i < res->count; i++) {
+        const mem_bench_row_t *row = &res->rows[i];
+        const uint64_t *cycles = fill ? row->fill : row->copy;
+        char size[16], col[MEM_IMPLS][24];
+        format_size(size, row->size);
+        for (int k = 0; k < MEM_IMPLS; k++)
+            format_col(col[k], mib_per_s(row->size * row->reps, cycles[k]), cycles[k] != 0);
+        const char *line[] = {
+            "  ", size, " ", col[0], col[1], col[2], col[3], col[4], col[5], "\n"
+        };
+        print_parts(line, 10);
+    }
+    print("\n");
+}
+
+/**
+ * Benchmark de memcpy/memset del kernel
+ * Cada rutina (loop de bytes en C, 8 bytes, rep movsb/stosb, SSE y stores
+ * non-temporal) más la elección automática, de 16 B hasta la mitad del
+ * buffer (64 MiB como máximo). "auto" debería seguir a la mejor en cada fila.
+ */
+void bench_copy(int mib) {
+    static mem_bench_t res;
+
+    print("=== memcpy / memset Benchmark ===\n");
+    if (mib <= 0) mib = COPY_DEFAULT_MIB;
+    if (mib > MEM_MAX_MIB) mib = MEM_MAX_MIB;
+
+    uint8_t *buf = 0;
+    while (mib >= 1 && (buf = malloc((uint64_t)mib << 20)) == 0)
+        mib /= 2;
+    if (buf == 0) {
+        print("Not enough memory for the buffer\n");
+        return;
+    }
+
+    memBench(&res, buf, (uint64_t)mib << 20);
+    free(buf);
+
+    char a[24], b[24];
+    int_to_str(mib, a);
+    uint64_to_str(res.nt_threshold >> 20, b);
+    const char *head[] = {
+        "Buffer: ", a, " MiB  ERMS: ", res.features & MEM_FEATURE_ERMS ? "yes" : "no",
+        "  FSRM: ", res.features & MEM_FEATURE_FSRM ? "yes" : "no",
+        "  non-temporal from ", b, " MiB\n\n"
+    };
+    print_parts(head, 9);
+
+    print_copy_table(&res, 0);
+    print_copy_table(&res, 1);
+    print("=== Fin Benchmark ===\n\n");
+}
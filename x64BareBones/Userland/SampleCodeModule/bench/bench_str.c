@@ -0,0 +1,214 @@
+#include "bench.h"
+#include "../lib.h"
+#include "../malloc.h"
+
+#define STR_BENCH_TRAFFIC (4ULL << 20)      // bytes por medición
+#define STR_BENCH_MAX     (64 * 1024)
+#define STR_BENCH_FORMATS 20000             // conversiones por medición
+#define COL_WIDTH         9
+
+#define OP_MEMCPY 0
+#define OP_MEMSET 1
+#define OP_MEMCMP 2
+#define OP_STRLEN 3
+#define OP_STRCMP 4
+#define OP_UTOA   5
+
+#define IMPL_OLD 0
+#define IMPL_NEW 1
+
+static volatile uint64_t sink;
+
+// ----------------------------------------------------------------------------
+// Versiones anteriores (de a byte), como referencia
+// ----------------------------------------------------------------------------
+
+static void old_copy(uint8_t *dst, const uint8_t *src, uint64_t length) {
+    for (uint64_t i = 0; i < length; i++)
+        dst[i] = src[i];
+}
+
+// El memset de _loader.c
+static void old_fill(uint8_t *dst, uint8_t chr, uint64_t length) {
+    while (length--)
+        dst[length] = chr;
+}
+
+static int old_cmp(const uint8_t *a, const uint8_t *b, uint64_t length) {
+    for (uint64_t i = 0; i < length; i++) {
+        if (a[i] != b[i])
+            return a[i] - b[i];
+    }
+    return 0;
+}
+
+static int old_len(const char *s) {
+    int l = 0;
+    while (s[l]) l++;
+    return l;
+}
+
+static int old_eq(const char *a, const char *b) {
+    int i = 0;
+    while (a[i] && b[i] && a[i] == b[i]) i++;
+    return a[i] == b[i];
+}
+
+// El uint64_to_str_helper que tenía cada bench
+static void old_utoa(uint64_t v, char *buf) {
+    char tmp[32];
+    int i = 0;
+    if (v == 0) {
+        buf[0] = '0';
+        buf[1] = 0;
+        return;
+    }
+    while (v > 0) {
+        tmp[i++] = '0' + (v % 10);
+        v /= 10;
+    }
+    int len = 0;
+    while (i > 0) buf[len++] = tmp[--i];
+    buf[len] = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+static void run_op(int op, int impl, uint8_t *a, uint8_t *b, uint64_t size) {
+    char num[24];
+    switch (op) {
+    case OP_MEMCPY:
+        if (impl == IMPL_OLD) old_copy(b, a, size); else memcpy(b, a, size);
+        break;
+    case OP_MEMSET:
+        if (impl == IMPL_OLD) old_fill(b, 0x5A, size); else memset(b, 0x5A, size);
+        break;
+    case OP_MEMCMP:
+        sink = impl == IMPL_OLD ? old_cmp(a, b, size) : memcmp(a, b, size);
+        break;
+    case OP_STRLEN:
+        sink = impl == IMPL_OLD ? old_len((char *)a) : strlen((char *)a);
+        break;
+    case OP_STRCMP:
+        sink = impl == IMPL_OLD ? old_eq((char *)a, (char *)b) : strcmp((char *)a, (char *)b);
+        break;
+    case OP_UTOA:
+        // size = valor a convertir
+        if (impl == IMPL_OLD) old_utoa(size, num); else uint64_to_str(size, num);
+        sink = num[0];
+        break;
+    }
+}
+
+// Ciclos por llamada
+static uint64_t measure(int op, int impl, uint8_t *a, uint8_t *b, uint64_t size) {
+    uint64_t reps = STR_BENCH_FORMATS;
+    if (op != OP_UTOA) {
+        reps = STR_BENCH_TRAFFIC / size;
+        if (reps > STR_BENCH_FORMATS) reps = STR_BENCH_FORMATS;
+    }
+
+    run_op(op, impl, a, b, size);
+    uint64_t start = bench_start();
+    for (uint64_t r = 0; r < reps; r++)
+        run_op(op, impl, a, b, size);
+    return bench_stop(start) / reps;
+}
+
+// Valor alineado a la derecha en COL_WIDTH columnas ("-" si no se midió)
+static void format_col(char *out, uint64_t value, int valid) {
+    char num[24];
+    int len;
+    if (valid) {
+        len = uint64_to_str(value, num);
+    } else {
+        num[0] = '-';
+        num[1] = '\0';
+        len = 1;
+    }
+    int pad = COL_WIDTH - len;
+    while (pad-- > 0)
+        *out++ = ' ';
+    memcpy(out, num, len + 1);
+}
+
+// "12.3x" con una décima
+static void format_speedup(char *out, uint64_t old, uint64_t best) {
+    uint64_t tenths = best ? old * 10 / best : 0;
+    int len = uint64_to_str(tenths / 10, out);
+    out[len++] = '.';
+    out[len++] = '0' + tenths % 10;
+    out[len++] = 'x';
+    out[len] = 0;
+}
+
+static void print_row(const char *name, int op, const char *label, uint8_t *a, uint8_t *b, uint64_t size) {
+    int simd = op <= OP_MEMCMP && size >= STRING_SIMD_MIN_BYTES;
+
+    uint64_t old = measure(op, IMPL_OLD, a, b, size);
+    string_set_simd(0);
+    uint64_t words = measure(op, IMPL_NEW, a, b, size);
+    string_set_simd(1);
+    uint64_t sse = simd ? measure(op, IMPL_NEW, a, b, size) : 0;
+    uint64_t best = simd && sse < words ? sse : words;
+
+    char cOld[24], cWords[24], cSse[24], speed[24];
+    format_col(cOld, old, 1);
+    format_col(cWords, words, 1);
+    format_col(cSse, sse, simd);
+    format_speedup(speed, old, best);
+    const char *line[] = { "  ", name, label, cOld, cWords, cSse, "    ", speed, "\n" };
+    print_parts(line, 9);
+}
+
+/**
+ * Benchmark de la libc de userland
+ * Ciclos por llamada de las versiones de a byte que había antes contra las
+ * nuevas de a 8 bytes y, desde STRING_SIMD_MIN_BYTES, con SSE. Las cadenas
+ * de strcmp son iguales (se recorren enteras).
+ */
+void bench_str(void) {
+    static const uint64_t memSizes[] = { 16, 256, 4096, STR_BENCH_MAX };
+    static const char *memLabels[] = { "16 B    ", "256 B   ", "4 KiB   ", "64 KiB  " };
+    static const uint64_t strSizes[] = { 8, 64, 1024 };
+    static const char *strLabels[] = { "8       ", "64      ", "1024    " };
+    static const uint64_t values[] = { 7, 1234567890ULL, 18446744073709551615ULL };
+    static const char *valueLabels[] = { "1 dig   ", "10 dig  ", "20 dig  " };
+    static const char *memNames[] = { "memcpy  ", "memset  ", "memcmp  " };
+
+    print("=== libc (string) Benchmark ===\n");
+
+    uint8_t *a = malloc(STR_BENCH_MAX + 1);
+    uint8_t *b = malloc(STR_BENCH_MAX + 1);
+    if (a == 0 || b == 0) {
+        free(a);
+        free(b);
+        print("Not enough memory for the buffers\n");
+        return;
+    }
+    for (uint64_t i = 0; i < STR_BENCH_MAX; i++)
+        a[i] = b[i] = 'a' + i % 26;
+
+    print("cycles per call\n");
+    print("  op      size          old    words      sse    speedup\n");
+    for (int op = OP_MEMCPY; op <= OP_MEMCMP; op++) {
+        for (int s = 0; s < 4; s++) {
+            if (op == OP_MEMCMP)
+                memcpy(b, a, memSizes[s]);
+            print_row(memNames[op], op, memLabels[s], a, b, memSizes[s]);
+        }
+    }
+    for (int s = 0; s < 3; s++) {
+        a[strSizes[s]] = b[strSizes[s]] = 0;
+        print_row("strlen  ", OP_STRLEN, strLabels[s], a, b, strSizes[s]);
+        print_row("strcmp  ", OP_STRCMP, strLabels[s], a, b, strSizes[s]);
+        a[strSizes[s]] = b[strSizes[s]] = 'a';
+    }
+    for (int v = 0; v < 3; v++)
+        print_row("utoa    ", OP_UTOA, valueLabels[v], a, b, values[v]);
+
+    free(a);
+    free(b);
+    print("\n  speedup = old / best of words and sse\n");
+    print("\n=== Fin Benchmark ===\n\n");
+}
@@ -0,0 +1,46 @@
+// keys.h
+#ifndef KEYS_H
+#define KEYS_H
+
+// Keycodes devueltos por getKeyEvents/getKeyState.
+// 0x01-0x58: make codes del set 1; 0x60-0x7F: teclas extendidas (0xE0 xx)
+
+#define KEY_ESC      0x01
+#define KEY_Q        0x10
+#define KEY_W        0x11
+#define KEY_E        0x12
+#define KEY_R        0x13
+#define KEY_I        0x17
+#define KEY_O        0x18
+#define KEY_P        0x19
+#define KEY_ENTER    0x1C
+#define KEY_LCTRL    0x1D
+#define KEY_A        0x1E
+#define KEY_S        0x1F
+#define KEY_D        0x20
+#define KEY_J        0x24
+#define KEY_K        0x25
+#define KEY_L        0x26
+#define KEY_LSHIFT   0x2A
+#define KEY_RSHIFT   0x36
+#define KEY_SPACE    0x39
+
+#define KEY_KP_ENTER 0x60
+#define KEY_RCTRL    0x61
+#define KEY_KP_SLASH 0x62
+#define KEY_RALT     0x63
+#define KEY_HOME     0x64
+#define KEY_UP       0x65
+#define KEY_PGUP     0x66
+#define KEY_LEFT     0x67
+#define KEY_RIGHT    0x68
+#define KEY_END      0x69
+#define KEY_DOWN     0x6A
+#define KEY_PGDN     0x6B
+#define KEY_INSERT   0x6C
+#define KEY_DELETE   0x6D
+#define KEY_LGUI     0x6E
+#define KEY_RGUI     0x6F
+#define KEY_MENU     0x70
+
+#endif // KEYS_H
@@ -4,15 +4,11 @@
 #include "lib.h"
 
 int str_eq(const char *a, const char *b) {
-    int i = 0;
-    while (a[i] && b[i] && a[i] == b[i]) i++;
-    return a[i] == b[i];
+    return strcmp(a, b) == 0;
 }
 
 int str_len(const char *s) {
-    int l = 0;
-    while (s[l]) l++;
-    return l;
+    return (int)strlen(s);
 }
 
 void print(const char *s) {
@@ -23,8 +19,209 @@ void printChar(char c) {
     _sys_write(SYS_WRITE, &c, 1);
 }
 
+void printv(const iovec_t *iov, int count) {
+    _sys_writev(SYS_WRITEV, iov, count);
+}
+
+void print_parts(const char **parts, int count) {
+    iovec_t iov[PRINT_PARTS_MAX];
+    if (count > PRINT_PARTS_MAX) count = PRINT_PARTS_MAX;
+    for (int i = 0; i < count; i++) {
+        iov[i].base = parts[i];
+        iov[i].len = str_len(parts[i]);
+    }
+    printv(iov, count);
+}
+
+static kbd_ring_t *kbd_ring;
+
+static kbd_ring_t * get_kbd_ring(void) {
+    // una sola syscall para obtener la pagina; despues se lee directo
+    if (kbd_ring == NULL)
+        kbd_ring = _sys_kbd_ring(SYS_KBD_RING);
+    return kbd_ring;
+}
+
 int read(char *buf, int count) {
-    return _sys_read(SYS_READ, 0, buf, count);
+    kbd_ring_t *ring = get_kbd_ring();
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    int n = 0;
+
+    while (n < count) {
+        // acquire: el dato queda visible antes que el tail que lo publica
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head == tail)
+            break;
+
+        char c = ring->data[head & (KBD_RING_SIZE - 1)];
+        // si el kernel consumio en el medio, head se actualiza y se reintenta
+        if (__atomic_compare_exchange_n(&ring->head, &head, head + 1, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            buf[n++] = c;
+    }
+    return n;
+}
+
+void kbdRingStats(uint64_t *overflows, uint64_t *dropped) {
+    kbd_ring_t *ring = get_kbd_ring();
+    *overflows = __atomic_load_n(&ring->overflows, __ATOMIC_RELAXED);
+    *dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+}
+
+int read_timeout(char *buf, int count, int timeout_ms) {
+    // solo se entra al kernel si hay que dormir
+    int n = read(buf, count);
+    if (n > 0 || timeout_ms == 0)
+        return n;
+    return _sys_read_timeout(SYS_READ_TIMEOUT, 0, buf, count, timeout_ms);
+}
+
+int read_blocking(char *buf, int count) {
+    return read_timeout(buf, count, READ_FOREVER);
+}
+
+int getKeyEvents(key_event_t *events, int max) {
+    return _sys_get_key_events(SYS_GET_KEY_EVENTS, events, max);
+}
+
+void getKeyState(uint64_t state[2]) {
+    _sys_get_key_state(SYS_GET_KEY_STATE, state);
+}
+
+int isKeyDown(const uint64_t state[2], uint8_t keycode) {
+    return (state[(keycode >> 6) & 1] >> (keycode & 63)) & 1;
+}
+
+int irqMode(int mode) {
+    return _sys_irq_mode(SYS_IRQ_MODE, mode);
+}
+
+int getCpuInfo(cpu_info_t *info, int max) {
+    return _sys_cpu_info(SYS_CPU_INFO, info, max);
+}
+
+int parallelFor(uint64_t start, uint64_t end, uint64_t grain, range_fn fn, void *arg) {
+    return _sys_parallel_for(SYS_PARALLEL_FOR, start, end, grain, fn, arg);
+}
+
+int getPoolStats(taskpool_stats_t *stats, int max) {
+    return _sys_pool_stats(SYS_POOL_STATS, stats, max);
+}
+
+int getIrqStats(irq_stat_t *stats, int max) {
+    return _sys_irq_stats(SYS_IRQ_STATS, stats, max);
+}
+
+int profileStart(void) {
+    return (int)_sys_profile(SYS_PROFILE, 1);
+}
+
+uint64_t profileStop(void) {
+    return _sys_profile(SYS_PROFILE, 0);
+}
+
+int profileReport(profile_entry_t *out, int max) {
+    return _sys_profile_report(SYS_PROFILE_REPORT, out, max);
+}
+
+int ipiBench(ipi_latency_t *out, int max, int iterations) {
+    return _sys_ipi_bench(SYS_IPI_BENCH, out, max, iterations);
+}
+
+int getTscSync(tsc_sync_t *out, int max) {
+    return _sys_tsc_sync(SYS_TSC_SYNC, out, max);
+}
+
+void getMemInfo(page_stats_t *stats) {
+    _sys_mem_info(SYS_MEM_INFO, stats);
+}
+
+int getSlabStats(kmem_stats_t *stats, int max) {
+    return _sys_slab_stats(SYS_SLAB_STATS, stats, max);
+}
+
+void slabBench(kmem_bench_t *out, int iterations) {
+    _sys_slab_bench(SYS_SLAB_BENCH, out, iterations);
+}
+
+void *sbrk(int64_t increment) {
+    return (void *)_sys_sbrk(SYS_SBRK, increment);
+}
+
+void *mapPages(uint64_t bytes) {
+    return _sys_mmap(SYS_MMAP, bytes);
+}
+
+void unmapPages(void *addr, uint64_t bytes) {
+    _sys_munmap(SYS_MUNMAP, addr, bytes);
+}
+
+void getPagingInfo(paging_info_t *info) {
+    _sys_paging_info(SYS_PAGING_INFO, info);
+}
+
+int setPagingMode(int mode) {
+    return _sys_paging_mode(SYS_PAGING_MODE, mode);
+}
+
+void memBench(mem_bench_t *out, void *buf, uint64_t bytes) {
+    _sys_mem_bench(SYS_MEM_BENCH, out, buf, bytes);
+}
+
+int taskCreate(task_entry_t entry, uint64_t arg, const char *name) {
+    return _sys_task_create(SYS_TASK_CREATE, entry, arg, name);
+}
+
+void taskExit(void) {
+    _sys_task_exit(SYS_TASK_EXIT);
+}
+
+void taskYield(void) {
+    _sys_task_yield(SYS_TASK_YIELD);
+}
+
+void taskSleep(uint64_t ms) {
+    _sys_task_sleep(SYS_TASK_SLEEP, ms);
+}
+
+int taskKill(int id) {
+    return _sys_task_kill(SYS_TASK_KILL, id);
+}
+
+int getTasks(task_info_t *out, int max) {
+    return _sys_task_list(SYS_TASK_LIST, out, max);
+}
+
+int schedQuantum(int ticks) {
+    return _sys_sched_quantum(SYS_SCHED_QUANTUM, ticks);
+}
+
+int taskSelf(void) {
+    return _sys_task_self(SYS_TASK_SELF);
+}
+
+int taskAffinity(int id, uint32_t mask) {
+    return _sys_task_affinity(SYS_TASK_AFFINITY, id, mask);
+}
+
+int getSchedCpuStats(sched_cpu_stats_t *out, int max) {
+    return _sys_sched_cpu_stats(SYS_SCHED_CPU_STATS, out, max);
+}
+
+int taskRealtime(int id, int prio, uint32_t period_ms) {
+    return _sys_task_realtime(SYS_TASK_REALTIME, id, prio, period_ms);
+}
+
+int taskFrame(int mode) {
+    return _sys_task_frame(SYS_TASK_FRAME, mode);
+}
+
+void heapLock(void) {
+    _sys_heap_lock(SYS_HEAP_LOCK);
+}
+
+void heapUnlock(void) {
+    _sys_heap_unlock(SYS_HEAP_UNLOCK);
 }
 
 void clearScreen() {
@@ -47,27 +244,6 @@ void playBeep(int channel, double freq, int duration) {
     _sys_playBeep(channel, freq, duration);
 }
 
-int int_to_str(int v, char *buf) {
-    char tmp[16];
-    int i = 0;
-    if (v == 0) {
-        buf[0] = '0';
-        buf[1] = 0;
-        return 1;
-    }
-    int neg = 0;
-    if (v < 0) { neg = 1; v = -v; }
-    while (v > 0) {
-        tmp[i++] = '0' + (v % 10);
-        v /= 10;
-    }
-    int len = 0;
-    if (neg) buf[len++] = '-';
-    while (i--) buf[len++] = tmp[i];
-    buf[len] = 0;
-    return len;
-}
-
 // ============================================================================
 // Benchmarking API Implementation
 // ============================================================================
@@ -101,25 +277,6 @@ int has_invariant_tsc(void) {
     return _sys_has_invariant_tsc(SYS_HAS_INVARIANT_TSC);
 }
 
-// Helper para convertir uint64_t a string
-static int uint64_to_str(uint64_t v, char *buf) {
-    char tmp[32];
-    int i = 0;
-    if (v == 0) {
-        buf[0] = '0';
-        buf[1] = 0;
-        return 1;
-    }
-    while (v > 0) {
-        tmp[i++] = '0' + (v % 10);
-        v /= 10;
-    }
-    int len = 0;
-    while (i > 0) buf[len++] = tmp[--i];
-    buf[len] = 0;
-    return len;
-}
-
 // Función simple para calcular raíz cuadrada (para desviación estándar)
 static uint64_t sqrt_uint64(uint64_t n) {
     if (n == 0) return 0;
@@ -167,47 +324,24 @@ void print_stats(const char* name, uint64_t* samples, int count) {
     uint64_t min_ms = cycles_to_ms(min);
     uint64_t max_ms = cycles_to_ms(max);
     
-    char buf[32];
-    
-    print("=== ");
-    print(name);
-    print(" ===\n");
-    
-    print("Samples: ");
-    uint64_to_str(count, buf);
-    print(buf);
-    print("\n");
-    
-    print("Avg: ");
-    uint64_to_str(avg_ms, buf);
-    print(buf);
-    print(" ms (");
-    uint64_to_str(avg, buf);
-    print(buf);
-    print(" cycles)\n");
+    char cnt_buf[32], ms_buf[32], cyc_buf[32];
     
-    print("StdDev: ");
-    uint64_to_str(stddev_ms, buf);
-    print(buf);
-    print(" ms (");
-    uint64_to_str(stddev, buf);
-    print(buf);
-    print(" cycles)\n");
+    const char *title[] = { "=== ", name, " ===\n" };
+    print_parts(title, 3);
     
-    print("Min: ");
-    uint64_to_str(min_ms, buf);
-    print(buf);
-    print(" ms (");
-    uint64_to_str(min, buf);
-    print(buf);
-    print(" cycles)\n");
+    uint64_to_str(count, cnt_buf);
+    const char *samples_line[] = { "Samples: ", cnt_buf, "\n" };
+    print_parts(samples_line, 3);
     
-    print("Max: ");
-    uint64_to_str(max_ms, buf);
-    print(buf);
-    print(" ms (");
-    uint64_to_str(max, buf);
-    print(buf);
-    print(" cycles)\n");
+    // Cada línea se arma en segmentos y se escribe con una sola syscall
+    const char *labels[] = { "Avg: ", "StdDev: ", "Min: ", "Max: " };
+    uint64_t values_ms[] = { avg_ms, stddev_ms, min_ms, max_ms };
+    uint64_t values_cycles[] = { avg, stddev, min, max };
+    for (int i = 0; i < 4; i++) {
+        uint64_to_str(values_ms[i], ms_buf);
+        uint64_to_str(values_cycles[i], cyc_buf);
+        const char *line[] = { labels[i], ms_buf, " ms (", cyc_buf, " cycles)\n" };
+        print_parts(line, 5);
+    }
     print("\n");
 }
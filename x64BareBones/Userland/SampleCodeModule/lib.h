@@ -5,6 +5,8 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "syscalls.h"
+#include "keys.h"
+#include "string.h"
 
 
 #define SYS_WRITE             0
@@ -20,6 +22,49 @@
 #define SYS_HAS_TSC           14
 #define SYS_HAS_INVARIANT_TSC 15
 #define SYS_PUT_CHAR          16
+#define SYS_WRITEV            17
+#define SYS_READ_TIMEOUT      18
+#define SYS_KBD_LAST_TSC      19
+#define SYS_GET_KEY_EVENTS    20
+#define SYS_GET_KEY_STATE     21
+#define SYS_KBD_RING          22
+#define SYS_IRQ_MODE          23
+#define SYS_CPU_INFO          24
+#define SYS_PARALLEL_FOR      25
+#define SYS_POOL_STATS        26
+#define SYS_IRQ_STATS         27
+#define SYS_PROFILE           28
+#define SYS_PROFILE_REPORT    29
+#define SYS_IPI_BENCH         30
+#define SYS_TSC_SYNC          31
+#define SYS_MEM_INFO          32
+#define SYS_SLAB_STATS        33
+#define SYS_SLAB_BENCH        34
+#define SYS_SBRK              35
+#define SYS_MMAP              36
+#define SYS_MUNMAP            37
+#define SYS_PAGING_INFO       38
+#define SYS_PAGING_MODE       39
+#define SYS_MEM_BENCH         40
+#define SYS_DEMAND_ZERO       41
+#define SYS_TASK_CREATE       42
+#define SYS_TASK_EXIT         43
+#define SYS_TASK_YIELD        44
+#define SYS_TASK_SLEEP        45
+#define SYS_TASK_KILL         46
+#define SYS_TASK_LIST         47
+#define SYS_SCHED_QUANTUM     48
+#define SYS_TASK_SELF         49
+#define SYS_TASK_AFFINITY     50
+#define SYS_SCHED_CPU_STATS   51
+#define SYS_TASK_REALTIME     52
+#define SYS_TASK_FRAME        53
+#define SYS_HEAP_LOCK         54
+#define SYS_HEAP_UNLOCK       55
+
+#define IRQ_MODE_PIC   0
+#define IRQ_MODE_APIC  1
+#define IRQ_MODE_QUERY (-1)
 
 int str_len(const char *s);
 int str_eq(const char *a, const char *b);
@@ -28,8 +73,275 @@ void print(const char *s);
 
 void printChar(char c);
 
+/**
+ * @brief Escribe varios segmentos con una sola syscall (un solo redibujo del cursor)
+ * @param iov Array de segmentos (puntero, longitud)
+ * @param count Cantidad de segmentos
+ */
+void printv(const iovec_t *iov, int count);
+
+/**
+ * @brief Imprime varios strings terminados en '\0' con una sola syscall
+ * @param parts Array de strings
+ * @param count Cantidad de strings (hasta PRINT_PARTS_MAX)
+ */
+#define PRINT_PARTS_MAX 16
+void print_parts(const char **parts, int count);
+
+/**
+ * @brief Lee sin bloquear directamente de la ring compartida (sin syscalls)
+ * @return Cantidad de caracteres leidos (0 si no habia teclas)
+ */
 int read(char *buf, int count);
 
+/**
+ * @brief Contadores de la ring de teclado
+ * @param overflows Veces que la ring se lleno
+ * @param dropped Teclas descartadas por ring llena
+ */
+void kbdRingStats(uint64_t *overflows, uint64_t *dropped);
+
+#define READ_FOREVER (-1)
+
+/**
+ * @brief Lee del teclado durmiendo en el kernel hasta que haya al menos una tecla
+ * @param timeout_ms 0 = no bloquea, READ_FOREVER = sin limite
+ * @return Cantidad de caracteres leidos (0 si vencio el timeout)
+ */
+int read_timeout(char *buf, int count, int timeout_ms);
+
+/**
+ * @brief Lee bloqueando hasta que haya al menos una tecla (sin polling)
+ */
+int read_blocking(char *buf, int count);
+
+/**
+ * @brief Saca de la cola del kernel hasta max eventos make/break
+ * @return Cantidad de eventos copiados
+ */
+int getKeyEvents(key_event_t *events, int max);
+
+/**
+ * @brief Copia el bitmap de 128 bits de teclas presionadas (una sola syscall por frame)
+ */
+void getKeyState(uint64_t state[2]);
+
+/**
+ * @brief Consulta una tecla en un bitmap obtenido con getKeyState
+ */
+int isKeyDown(const uint64_t state[2], uint8_t keycode);
+
+/**
+ * @brief Elige el controlador de interrupciones (PIC 8259 o IOAPIC/LAPIC)
+ * @param mode IRQ_MODE_PIC, IRQ_MODE_APIC o IRQ_MODE_QUERY
+ * @return Modo activo, -1 si el pedido no esta disponible
+ */
+int irqMode(int mode);
+
+#define MAX_CPUS 16
+
+/**
+ * @brief Lista las CPUs que el kernel trajo de Pure64 (la 0 es el BSP)
+ * @param info Array de salida
+ * @param max Capacidad de info
+ * @return Cantidad de CPUs escritas
+ */
+int getCpuInfo(cpu_info_t *info, int max);
+
+/**
+ * @brief Reparte fn sobre [start, end) entre todos los CPUs (work stealing)
+ * fn no puede hacer syscalls: corre también en los APs
+ * @param grain Rango minimo por tarea (0 = lo elige el kernel)
+ * @return Cantidad de CPUs que participaron
+ */
+int parallelFor(uint64_t start, uint64_t end, uint64_t grain, range_fn fn, void *arg);
+
+/**
+ * @brief Contadores del pool de tareas por CPU (ejecutadas, robos)
+ * @return Cantidad de CPUs escritas
+ */
+int getPoolStats(taskpool_stats_t *stats, int max);
+
+/**
+ * @brief Contadores por vector de la IDT (solo los que se dispararon)
+ * @return Cantidad de vectores escritos
+ */
+int getIrqStats(irq_stat_t *stats, int max);
+
+/**
+ * @brief Arranca el profiler por muestreo en todos los CPUs libres
+ * @return Cantidad de CPUs muestreados (0 si no se pudo)
+ */
+int profileStart(void);
+
+/**
+ * @brief Detiene el profiler
+ * @return Cantidad de muestras guardadas
+ */
+uint64_t profileStop(void);
+
+/**
+ * @brief Funciones con mas muestras propias (resueltas con los link maps)
+ * @return Cantidad de entradas escritas
+ */
+int profileReport(profile_entry_t *out, int max);
+
+/**
+ * @brief Mide la ida y vuelta de una llamada cruzada (IPI + mailbox) a cada AP
+ * @return Cantidad de CPUs medidos
+ */
+int ipiBench(ipi_latency_t *out, int max, int iterations);
+
+/**
+ * @brief Offset, ida y vuelta y warps del TSC de cada CPU contra el BSP
+ * Lo mide el kernel al arrancar; bench_start/bench_stop ya aplican el offset
+ * @return Cantidad de CPUs escritas (la 0 es el BSP)
+ */
+int getTscSync(tsc_sync_t *out, int max);
+
+/**
+ * @brief Páginas libres, bloques por orden y zonas reservadas del allocator físico
+ */
+void getMemInfo(page_stats_t *stats);
+
+/**
+ * @brief Contadores de los cachés de objetos del kernel (kmalloc-N y los propios)
+ * @return Cantidad de cachés escritos
+ */
+int getSlabStats(kmem_stats_t *stats, int max);
+
+/**
+ * @brief Ciclos por par alloc/free del slab (con y sin magazines por CPU)
+ */
+void slabBench(kmem_bench_t *out, int iterations);
+
+/**
+ * @brief Mueve el break del heap (lo nuevo viene en cero); sbrk(0) lo consulta
+ * @return Break anterior, (void *)-1 si no hay lugar en la ventana
+ */
+void *sbrk(int64_t increment);
+
+/**
+ * @brief Bloque de páginas en cero fuera del heap (hasta USER_MMAP_MAX)
+ * @return 0 si no hay memoria
+ */
+void *mapPages(uint64_t bytes);
+
+/**
+ * @brief Devuelve un bloque de mapPages; el kernel ignora cualquier otra
+ * dirección y toma el tamaño de lo que entregó
+ */
+void unmapPages(void *addr, uint64_t bytes);
+
+/**
+ * @brief Tramos del mapeo (tamaño de página y tipo de memoria) y entradas de TLB
+ */
+void getPagingInfo(paging_info_t *info);
+
+/**
+ * @brief Cambia el tamaño de página con que el kernel mapea la memoria
+ * @param mode PAGING_MODE_*, o PAGING_MODE_QUERY para consultar
+ * @return Modo activo, -1 si no se pudo
+ */
+int setPagingMode(int mode);
+
+/**
+ * @brief Mide memcpy/memset del kernel (cada rutina) copiando dentro de buf
+ * @param bytes Tamaño de buf; el bloque más grande medido es bytes / 2
+ */
+void memBench(mem_bench_t *out, void *buf, uint64_t bytes);
+
+/**
+ * @brief Crea una tarea que corre entry(arg) con su propia pila, repartiendo
+ * el CPU por quantum con las demás (incluido el shell)
+ * @param name Nombre para ps (se copia, hasta 15 caracteres)
+ * @return Id de la tarea, -1 si no hay lugar
+ */
+int taskCreate(task_entry_t entry, uint64_t arg, const char *name);
+
+/**
+ * @brief Termina la tarea actual (volver de entry hace lo mismo)
+ */
+void taskExit(void);
+
+/**
+ * @brief Cede el CPU a la siguiente tarea lista
+ */
+void taskYield(void);
+
+/**
+ * @brief Duerme la tarea actual; las demás siguen corriendo
+ */
+void taskSleep(uint64_t ms);
+
+/**
+ * @brief Termina otra tarea (si tiene el lock de malloc, al soltarlo)
+ * @return 1 si existía
+ */
+int taskKill(int id);
+
+/**
+ * @brief Tareas vivas con su estado, cambios de contexto y tiempo de CPU
+ * @return Cantidad de tareas escritas
+ */
+int getTasks(task_info_t *out, int max);
+
+/**
+ * @brief Cambia el quantum del scheduler en ticks del timer (<= 0 consulta)
+ * @return Quantum vigente
+ */
+int schedQuantum(int ticks);
+
+/**
+ * @brief Id de la tarea actual
+ */
+int taskSelf(void);
+
+/**
+ * @brief Limita los CPUs en que puede correr una tarea (main no se mueve)
+ * @param mask Bit i = CPU i; 0 solo consulta
+ * @return Máscara anterior, -1 si no existe o ningún CPU de mask está online
+ */
+int taskAffinity(int id, uint32_t mask);
+
+/**
+ * @brief Ciclos ocupado/ocioso, cola y robos de cada CPU
+ * @return Cantidad de CPUs escritas
+ */
+int getSchedCpuStats(sched_cpu_stats_t *out, int max);
+
+#define TASK_PRIO_NORMAL   0
+#define TASK_RT_PRIO_MAX   15
+#define FRAME_RESTART      0
+#define FRAME_WAIT         1
+
+/**
+ * @brief Pasa una tarea a tiempo real (le gana siempre a las normales y a las
+ * RT de menos prioridad) o la devuelve a la clase normal
+ * @param prio TASK_PRIO_NORMAL o 1..TASK_RT_PRIO_MAX
+ * @param period_ms Duración de cada cuadro para taskFrame (0 = sin cuadros);
+ * necesita el modo APIC (con el PIT solo los cuadros serían de 55 ms)
+ * @return Prioridad anterior, -1 si no existe, prio no es válida o se pide
+ * período en modo PIC
+ */
+int taskRealtime(int id, int prio, uint32_t period_ms);
+
+/**
+ * @brief Marca los cuadros de la tarea actual (necesita período)
+ * @param mode FRAME_RESTART: el cuadro empieza ahora (al arrancar o después
+ * de una pausa); FRAME_WAIT: terminó el cuadro, duerme hasta el próximo
+ * @return 1 si el cuadro se pasó del deadline, 0 si no, -1 sin período
+ */
+int taskFrame(int mode);
+
+/**
+ * @brief Lock de malloc, del lado del kernel: quien espera duerme y le presta
+ * su prioridad al dueño; a una tarea que matan con él tomado la termina al
+ * soltarlo
+ */
+void heapLock(void);
+void heapUnlock(void);
+
 void clearScreen(void);
 
 void getTime(rtc_time_t *tm);
@@ -40,8 +352,6 @@ void changeFontSize(int size);
 
 void playBeep(int channel, double freq, int duration);
 
-int int_to_str(int v, char *buf);
-
 // ============================================================================
 // Benchmarking API - Wrappers sencillos a TSC/PIT
 // ============================================================================
@@ -0,0 +1,310 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "malloc.h"
+#include "lib.h"
+
+#define SPAN_SIZE       (64 * 1024)
+#define SMALL_MIN       16
+#define SMALL_MAX       1024
+#define SMALL_CLASSES   7                   // 16, 32, ..., 1024
+#define MMAP_MIN        (128 * 1024)
+#define ALIGNMENT       16
+#define LARGE_MIN_SPLIT 64                  // resto mínimo para partir un bloque libre
+
+#define BLOCK_HEAP 1
+#define BLOCK_MMAP 2
+
+typedef struct free_obj {
+    struct free_obj *next;
+} free_obj_t;
+
+// Encabezado de bloques grandes y de mapPages; el usuario recibe hdr + 1
+typedef struct {
+    uint64_t size;                          // incluye el encabezado
+    uint64_t kind;
+} block_hdr_t;
+
+// Pedido más grande posible: más arriba, sumar el encabezado y redondear a
+// ALIGNMENT da la vuelta y queda un bloque diminuto
+#define MALLOC_MAX ((size_t)-1 - sizeof(block_hdr_t) - ALIGNMENT)
+
+// Bloque grande libre (dentro del heap), lista ordenada por dirección
+typedef struct free_block {
+    uint64_t size;
+    struct free_block *next;
+} free_block_t;
+
+static free_obj_t *bins[SMALL_CLASSES];
+static uint8_t *spanCursor[SMALL_CLASSES];  // parte todavía no usada del span actual
+static uint8_t *spanLimit[SMALL_CLASSES];
+static uint8_t spanClass[USER_HEAP_MAX / SPAN_SIZE];   // 0 = bloques grandes, c + 1 = clase c
+static uint8_t *heapBase;
+static free_block_t *largeFree;
+static malloc_stats_t stats;
+
+static inline uint64_t align_up(uint64_t v, uint64_t a) {
+    return (v + a - 1) & ~(a - 1);
+}
+
+static inline int size_class(size_t size) {
+    if (size <= SMALL_MIN)
+        return 0;
+    return 64 - __builtin_clzll(size - 1) - 4;      // log2 redondeado - log2(16)
+}
+
+// Las tareas comparten el heap. El lock es un kmutex del kernel: con un flag
+// en userland, una tarea que mataban a mitad de malloc lo dejaba tomado para
+// siempre; así termina recién al soltarlo, con las listas enteras.
+static void heap_lock(void) {
+    heapLock();
+}
+
+static void heap_unlock(void) {
+    heapUnlock();
+}
+
+static int heap_init(void) {
+    if (heapBase == 0) {
+        uint8_t *base = sbrk(0);
+        if (base == (void *)-1)
+            return 0;
+        heapBase = base;
+    }
+    return 1;
+}
+
+static inline int in_heap(const void *p) {
+    return heapBase != 0 && (const uint8_t *)p >= heapBase
+        && (const uint8_t *)p < heapBase + stats.heap_bytes;
+}
+
+static void *heap_grow(uint64_t bytes) {
+    uint8_t *p = sbrk((int64_t)bytes);
+    if (p == (void *)-1)
+        return 0;
+    stats.heap_bytes += bytes;
+    return p;
+}
+
+// Inserta en orden y junta con los vecinos; si queda al final del heap, lo devuelve
+static void large_free_insert(uint8_t *addr, uint64_t size) {
+    free_block_t *pprev = 0, *prev = 0, *cur = largeFree;
+    while (cur && (uint8_t *)cur < addr) {
+        pprev = prev;
+        prev = cur;
+        cur = cur->next;
+    }
+
+    free_block_t *blk = (free_block_t *)addr;
+    free_block_t *before = prev;            // nodo anterior al bloque resultante
+    blk->size = size;
+    blk->next = cur;
+    if (cur && addr + size == (uint8_t *)cur) {
+        blk->size += cur->size;
+        blk->next = cur->next;
+    }
+    if (prev && (uint8_t *)prev + prev->size == addr) {
+        prev->size += blk->size;
+        prev->next = blk->next;
+        blk = prev;
+        before = pprev;
+    } else if (prev) {
+        prev->next = blk;
+    } else {
+        largeFree = blk;
+    }
+
+    // el último bloque libre toca el break: se achica el heap
+    if ((uint8_t *)blk + blk->size == heapBase + stats.heap_bytes
+        && sbrk(-(int64_t)blk->size) != (void *)-1) {
+        stats.heap_bytes -= blk->size;
+        if (before)
+            before->next = 0;
+        else
+            largeFree = 0;
+    }
+}
+
+static void *large_alloc(size_t size) {
+    if (size > MALLOC_MAX)
+        return 0;
+    uint64_t need = align_up(size + sizeof(block_hdr_t), ALIGNMENT);
+    free_block_t *prev = 0, *cur = largeFree;
+    block_hdr_t *hdr = 0;
+
+    while (cur && cur->size < need) {
+        prev = cur;
+        cur = cur->next;
+    }
+    if (cur) {
+        free_block_t *rest = cur->next;
+        if (cur->size - need >= LARGE_MIN_SPLIT) {
+            rest = (free_block_t *)((uint8_t *)cur + need);
+            rest->size = cur->size - need;
+            rest->next = cur->next;
+        } else {
+            need = cur->size;
+        }
+        if (prev) prev->next = rest;
+        else largeFree = rest;
+        hdr = (block_hdr_t *)cur;
+    } else {
+        hdr = heap_grow(need);
+        if (hdr == 0)
+            return 0;
+    }
+    hdr->size = need;
+    hdr->kind = BLOCK_HEAP;
+    return hdr + 1;
+}
+
+// Span nuevo para la clase cls, alineado a SPAN_SIZE; el relleno va a la lista grande
+static int new_span(int cls) {
+    uint8_t *brk = heapBase + stats.heap_bytes;
+    uint64_t pad = align_up((uint64_t)brk, SPAN_SIZE) - (uint64_t)brk;
+    uint8_t *p = heap_grow(pad + SPAN_SIZE);
+    if (p == 0)
+        return 0;
+    if (pad >= sizeof(free_block_t))
+        large_free_insert(p, pad);
+
+    uint8_t *span = p + pad;
+    spanClass[(span - heapBase) / SPAN_SIZE] = cls + 1;
+    spanCursor[cls] = span;
+    spanLimit[cls] = span + SPAN_SIZE;
+    return 1;
+}
+
+static void *small_alloc(int cls) {
+    uint64_t size = (uint64_t)SMALL_MIN << cls;
+    if (spanCursor[cls] + size > spanLimit[cls] && !new_span(cls))
+        return 0;
+    void *obj = spanCursor[cls];
+    spanCursor[cls] += size;
+    return obj;
+}
+
+static void *malloc_locked(size_t size) {
+    if (!heap_init())
+        return 0;
+
+    void *p;
+    if (size <= SMALL_MAX) {
+        int cls = size_class(size);
+        free_obj_t *obj = bins[cls];
+        if (obj) {
+            bins[cls] = obj->next;
+            stats.allocs++;
+            stats.fast_allocs++;
+            return obj;
+        }
+        p = small_alloc(cls);
+    } else if (size + sizeof(block_hdr_t) >= MMAP_MIN && size + sizeof(block_hdr_t) <= USER_MMAP_MAX) {
+        block_hdr_t *hdr = mapPages(size + sizeof(block_hdr_t));
+        if (hdr == 0)
+            return large_alloc(size);
+        hdr->size = size + sizeof(block_hdr_t);
+        hdr->kind = BLOCK_MMAP;
+        stats.mapped_bytes += hdr->size;
+        p = hdr + 1;
+    } else {
+        p = large_alloc(size);
+    }
+    if (p)
+        stats.allocs++;
+    return p;
+}
+
+// Tamaño usable de un bloque; para chicos es el de su clase
+static uint64_t usable_size(void *ptr, int *cls) {
+    *cls = -1;
+    if (in_heap(ptr)) {
+        uint8_t c = spanClass[((uint8_t *)ptr - heapBase) / SPAN_SIZE];
+        if (c != 0) {
+            *cls = c - 1;
+            return (uint64_t)SMALL_MIN << *cls;
+        }
+    }
+    block_hdr_t *hdr = (block_hdr_t *)ptr - 1;
+    return hdr->size - sizeof(block_hdr_t);
+}
+
+void *malloc(size_t size) {
+    if (size == 0)
+        return 0;
+    heap_lock();
+    void *p = malloc_locked(size);
+    heap_unlock();
+    return p;
+}
+
+static void free_locked(void *ptr) {
+    int cls;
+    usable_size(ptr, &cls);
+    stats.frees++;
+    if (cls >= 0) {
+        free_obj_t *obj = ptr;
+        obj->next = bins[cls];
+        bins[cls] = obj;
+        return;
+    }
+
+    block_hdr_t *hdr = (block_hdr_t *)ptr - 1;
+    if (hdr->kind == BLOCK_MMAP) {
+        stats.mapped_bytes -= hdr->size;
+        unmapPages(hdr, hdr->size);
+    } else if (hdr->kind == BLOCK_HEAP) {
+        large_free_insert((uint8_t *)hdr, hdr->size);
+    }
+}
+
+void free(void *ptr) {
+    if (ptr == 0)
+        return;
+    heap_lock();
+    free_locked(ptr);
+    heap_unlock();
+}
+
+void *calloc(size_t count, size_t size) {
+    if (size != 0 && count > MALLOC_MAX / size)
+        return 0;
+    void *p = malloc(count * size);
+    if (p)
+        memset(p, 0, count * size);
+    return p;
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (ptr == 0)
+        return malloc(size);
+    if (size == 0) {
+        free(ptr);
+        return 0;
+    }
+    if (size > MALLOC_MAX)
+        return 0;
+
+    int cls;
+    uint64_t old = usable_size(ptr, &cls);
+    if (size <= old)
+        return ptr;
+
+    uint8_t *q = malloc(size);
+    if (q == 0)
+        return 0;
+    const uint8_t *src = ptr;
+    for (uint64_t i = 0; i < old; i++)
+        q[i] = src[i];
+    free(ptr);
+    return q;
+}
+
+void malloc_get_stats(malloc_stats_t *out) {
+    heap_lock();
+    *out = stats;
+    out->large_free_bytes = 0;
+    for (free_block_t *b = largeFree; b; b = b->next)
+        out->large_free_bytes += b->size;
+    heap_unlock();
+}
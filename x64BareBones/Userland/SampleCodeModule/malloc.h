@@ -0,0 +1,34 @@
+// malloc.h
+#ifndef MALLOC_H
+#define MALLOC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Allocator de userland sobre sbrk/mapPages:
+//  - chicos (<= 1024): clases de potencia de 2 con listas libres propias;
+//    cada clase toma spans de 64 KiB del heap y free reconoce la clase por el span
+//  - de 128 KiB a 2 MiB: bloques de páginas del kernel (mapPages), se devuelven al liberar
+//  - el resto: bloques con encabezado del heap, first fit con coalescencia
+// Las tareas del scheduler comparten el heap bajo un kmutex del kernel
+// (heapLock/heapUnlock): quien lo encuentra tomado duerme y le presta su
+// prioridad al dueño, y una tarea que matan con él tomado termina al soltarlo.
+// No usar desde el cuerpo de un parallelFor (corre en los APs, sin syscalls).
+
+typedef struct {
+    uint64_t heap_bytes;        // tamaño actual del heap (break - base)
+    uint64_t mapped_bytes;      // en bloques de mapPages
+    uint64_t large_free_bytes;  // libres en la lista de bloques grandes
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t fast_allocs;       // servidos directo de la lista de la clase
+} malloc_stats_t;
+
+void *malloc(size_t size);
+void free(void *ptr);
+void *calloc(size_t count, size_t size);
+void *realloc(void *ptr, size_t size);
+
+void malloc_get_stats(malloc_stats_t *stats);
+
+#endif // MALLOC_H
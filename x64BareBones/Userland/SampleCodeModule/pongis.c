@@ -79,7 +79,7 @@ static int ask_players() {
     const char *msg = "Jugadores (1/2): ";
     print(msg);
     char c = 0;
-    while (read(&c, 1) <= 0 || (c != '1' && c != '2')) {}
+    while (read_blocking(&c, 1) <= 0 || (c != '1' && c != '2')) {}
     print("\n");
     return c - '0';
 }
@@ -171,16 +171,20 @@ void pongis_game() {
             while (read(&c, 1) > 0) {
                 //con q o ESC salimos del juego
                 if (c == ESC || c == 'q') running = 0;
-                if (c == 'w') p1.y -= PLAYER_SPEED;
-                if (c == 's') p1.y += PLAYER_SPEED;
-                if (c == 'a') p1.x -= PLAYER_SPEED;
-                if (c == 'd') p1.x += PLAYER_SPEED;
-                if (players == 2) {
-                    if (c == 'i') p2.y -= PLAYER_SPEED;
-                    if (c == 'k') p2.y += PLAYER_SPEED;
-                    if (c == 'j') p2.x -= PLAYER_SPEED;
-                    if (c == 'l') p2.x += PLAYER_SPEED;
-                }
+            }
+            // el movimiento sale del estado de las teclas (una syscall por frame):
+            // mantener apretado mueve de forma continua y los dos jugadores no se pisan
+            uint64_t keys[2];
+            getKeyState(keys);
+            if (isKeyDown(keys, KEY_W)) p1.y -= PLAYER_SPEED;
+            if (isKeyDown(keys, KEY_S)) p1.y += PLAYER_SPEED;
+            if (isKeyDown(keys, KEY_A)) p1.x -= PLAYER_SPEED;
+            if (isKeyDown(keys, KEY_D)) p1.x += PLAYER_SPEED;
+            if (players == 2) {
+                if (isKeyDown(keys, KEY_I) || isKeyDown(keys, KEY_UP))    p2.y -= PLAYER_SPEED;
+                if (isKeyDown(keys, KEY_K) || isKeyDown(keys, KEY_DOWN))  p2.y += PLAYER_SPEED;
+                if (isKeyDown(keys, KEY_J) || isKeyDown(keys, KEY_LEFT))  p2.x -= PLAYER_SPEED;
+                if (isKeyDown(keys, KEY_L) || isKeyDown(keys, KEY_RIGHT)) p2.x += PLAYER_SPEED;
             }
             if (!running) break;
 
@@ -0,0 +1,339 @@
+GLOBAL mem_copy_words
+GLOBAL mem_copy_words_backward
+GLOBAL mem_copy_sse
+GLOBAL mem_fill_words
+GLOBAL mem_fill_sse
+GLOBAL mem_cmp_words
+GLOBAL mem_cmp_sse
+GLOBAL str_len_words
+GLOBAL str_cmp_words
+
+SECTION .text
+
+; ----------------------------------------------------------------------------
+; Loops de la libc de userland (string.c elige cuál usar). Los de 8 bytes
+; alinean el destino con bytes sueltos y terminan con la cola de a byte; los
+; SSE escriben 16 bytes sin alinear, alinean el destino a 16 y dejan la cola
+; (menos de 64 bytes) al loop de 8 bytes.
+; ----------------------------------------------------------------------------
+
+BYTE_ONES  equ 0x0101010101010101
+BYTE_HIGHS equ 0x8080808080808080
+
+; void mem_copy_words(void *dst, const void *src, uint64_t length)
+mem_copy_words:
+.head:
+	test rdi, 7
+	jz .body32
+	test rdx, rdx
+	jz .done
+	mov al, [rsi]
+	mov [rdi], al
+	inc rsi
+	inc rdi
+	dec rdx
+	jmp .head
+.body32:
+	cmp rdx, 32
+	jb .body8
+	mov rax, [rsi]
+	mov rcx, [rsi + 8]
+	mov r8, [rsi + 16]
+	mov r9, [rsi + 24]
+	mov [rdi], rax
+	mov [rdi + 8], rcx
+	mov [rdi + 16], r8
+	mov [rdi + 24], r9
+	add rsi, 32
+	add rdi, 32
+	sub rdx, 32
+	jmp .body32
+.body8:
+	cmp rdx, 8
+	jb .tail
+	mov rax, [rsi]
+	mov [rdi], rax
+	add rsi, 8
+	add rdi, 8
+	sub rdx, 8
+	jmp .body8
+.tail:
+	test rdx, rdx
+	jz .done
+	mov al, [rsi]
+	mov [rdi], al
+	inc rsi
+	inc rdi
+	dec rdx
+	jmp .tail
+.done:
+	ret
+
+; void mem_copy_words_backward(void *dst, const void *src, uint64_t length)
+; desde el final, para memmove con dst > src solapados
+mem_copy_words_backward:
+	add rsi, rdx
+	add rdi, rdx
+.tail:
+	test rdi, 7
+	jz .body8
+	test rdx, rdx
+	jz .done
+	dec rsi
+	dec rdi
+	mov al, [rsi]
+	mov [rdi], al
+	dec rdx
+	jmp .tail
+.body8:
+	cmp rdx, 8
+	jb .head
+	sub rsi, 8
+	sub rdi, 8
+	mov rax, [rsi]
+	mov [rdi], rax
+	sub rdx, 8
+	jmp .body8
+.head:
+	test rdx, rdx
+	jz .done
+	dec rsi
+	dec rdi
+	mov al, [rsi]
+	mov [rdi], al
+	dec rdx
+	jmp .head
+.done:
+	ret
+
+; void mem_copy_sse(void *dst, const void *src, uint64_t length)
+; length >= 16 y sin solapamiento (el primer store pisa hasta 15 bytes que
+; se vuelven a copiar después de alinear)
+mem_copy_sse:
+	movdqu xmm0, [rsi]
+	movdqu [rdi], xmm0
+	mov rcx, rdi
+	neg rcx
+	and rcx, 15
+	add rdi, rcx
+	add rsi, rcx
+	sub rdx, rcx
+.body:
+	cmp rdx, 64
+	jb mem_copy_words
+	movdqu xmm0, [rsi]
+	movdqu xmm1, [rsi + 16]
+	movdqu xmm2, [rsi + 32]
+	movdqu xmm3, [rsi + 48]
+	movdqa [rdi], xmm0
+	movdqa [rdi + 16], xmm1
+	movdqa [rdi + 32], xmm2
+	movdqa [rdi + 48], xmm3
+	add rsi, 64
+	add rdi, 64
+	sub rdx, 64
+	jmp .body
+
+; void mem_fill_words(void *dst, uint64_t pattern, uint64_t length)
+mem_fill_words:
+.head:
+	test rdi, 7
+	jz .body32
+	test rdx, rdx
+	jz .done
+	mov [rdi], sil
+	inc rdi
+	dec rdx
+	jmp .head
+.body32:
+	cmp rdx, 32
+	jb .body8
+	mov [rdi], rsi
+	mov [rdi + 8], rsi
+	mov [rdi + 16], rsi
+	mov [rdi + 24], rsi
+	add rdi, 32
+	sub rdx, 32
+	jmp .body32
+.body8:
+	cmp rdx, 8
+	jb .tail
+	mov [rdi], rsi
+	add rdi, 8
+	sub rdx, 8
+	jmp .body8
+.tail:
+	test rdx, rdx
+	jz .done
+	mov [rdi], sil
+	inc rdi
+	dec rdx
+	jmp .tail
+.done:
+	ret
+
+; void mem_fill_sse(void *dst, uint64_t pattern, uint64_t length) - length >= 16
+mem_fill_sse:
+	movq xmm0, rsi
+	punpcklqdq xmm0, xmm0
+	movdqu [rdi], xmm0
+	mov rcx, rdi
+	neg rcx
+	and rcx, 15
+	add rdi, rcx
+	sub rdx, rcx
+.body:
+	cmp rdx, 64
+	jb mem_fill_words
+	movdqa [rdi], xmm0
+	movdqa [rdi + 16], xmm0
+	movdqa [rdi + 32], xmm0
+	movdqa [rdi + 48], xmm0
+	add rdi, 64
+	sub rdx, 64
+	jmp .body
+
+; int mem_cmp_words(const void *a, const void *b, uint64_t length)
+; en el primer qword distinto, el bit más bajo del xor marca el primer byte
+mem_cmp_words:
+.body8:
+	cmp rdx, 8
+	jb .tail
+	mov rax, [rdi]
+	mov rcx, [rsi]
+	cmp rax, rcx
+	jne .diff8
+	add rdi, 8
+	add rsi, 8
+	sub rdx, 8
+	jmp .body8
+.diff8:
+	xor rax, rcx
+	bsf rax, rax
+	shr rax, 3
+	movzx ecx, byte [rsi + rax]
+	movzx eax, byte [rdi + rax]
+	sub eax, ecx
+	ret
+.tail:
+	xor eax, eax
+	test rdx, rdx
+	jz .done
+	movzx eax, byte [rdi]
+	movzx ecx, byte [rsi]
+	sub eax, ecx
+	jnz .done
+	inc rdi
+	inc rsi
+	dec rdx
+	jmp .tail
+.done:
+	ret
+
+; int mem_cmp_sse(const void *a, const void *b, uint64_t length)
+mem_cmp_sse:
+.body:
+	cmp rdx, 16
+	jb mem_cmp_words
+	movdqu xmm0, [rdi]
+	movdqu xmm1, [rsi]
+	pcmpeqb xmm0, xmm1
+	pmovmskb eax, xmm0
+	cmp eax, 0xFFFF
+	jne .diff
+	add rdi, 16
+	add rsi, 16
+	sub rdx, 16
+	jmp .body
+.diff:
+	not eax
+	bsf eax, eax
+	movzx ecx, byte [rsi + rax]
+	movzx eax, byte [rdi + rax]
+	sub eax, ecx
+	ret
+
+; uint64_t str_len_words(const char *s)
+; lee qwords alineados (nunca cruzan a una página sin mapear) y busca el
+; byte cero con (x - 0x01..01) & ~x & 0x80..80: el bit más bajo es exacto
+str_len_words:
+	mov rax, rdi
+.head:
+	test rax, 7
+	jz .body
+	cmp byte [rax], 0
+	je .done
+	inc rax
+	jmp .head
+.body:
+	mov r8, BYTE_ONES
+	mov r9, BYTE_HIGHS
+.loop:
+	mov rdx, [rax]
+	mov rcx, rdx
+	not rcx
+	sub rdx, r8
+	and rdx, rcx
+	and rdx, r9
+	jnz .found
+	add rax, 8
+	jmp .loop
+.found:
+	bsf rdx, rdx
+	shr rdx, 3
+	add rax, rdx
+.done:
+	sub rax, rdi
+	ret
+
+; int str_cmp_words(const char *a, const char *b)
+; de a qword solo si a y b tienen la misma alineación (así ninguna lectura
+; cruza de página); si no, o al encontrar una diferencia, sigue de a byte
+str_cmp_words:
+	mov rax, rdi
+	xor rax, rsi
+	test rax, 7
+	jnz .bytes
+	mov r8, BYTE_ONES
+	mov r9, BYTE_HIGHS
+.head:
+	test rdi, 7
+	jz .words
+	movzx eax, byte [rdi]
+	movzx ecx, byte [rsi]
+	cmp eax, ecx
+	jne .diff
+	test eax, eax
+	jz .diff
+	inc rdi
+	inc rsi
+	jmp .head
+.words:
+	mov rax, [rdi]
+	cmp rax, [rsi]
+	jne .bytes
+	mov rdx, rax
+	not rdx
+	sub rax, r8
+	and rax, rdx
+	test rax, r9
+	jnz .equal
+	add rdi, 8
+	add rsi, 8
+	jmp .words
+.equal:
+	xor eax, eax
+	ret
+.bytes:
+	movzx eax, byte [rdi]
+	movzx ecx, byte [rsi]
+	cmp eax, ecx
+	jne .diff
+	test eax, eax
+	jz .diff
+	inc rdi
+	inc rsi
+	jmp .bytes
+.diff:
+	sub eax, ecx
+	ret
@@ -0,0 +1,129 @@
+#include <stdint.h>
+#include <stddef.h>
+#include "string.h"
+
+#define BYTE_PATTERN 0x0101010101010101ULL
+
+// Las rutinas vectorizadas arrancan habilitadas; string_set_simd las cambia
+static int simdEnabled = 1;
+
+static const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const char hexDigits[] = "0123456789ABCDEF";
+
+int string_set_simd(int enabled) {
+    int previous = simdEnabled;
+    simdEnabled = enabled;
+    return previous;
+}
+
+void *memcpy(void *destination, const void *source, uint64_t length) {
+    if (length >= STRING_SIMD_MIN_BYTES && simdEnabled)
+        mem_copy_sse(destination, source, length);
+    else
+        mem_copy_words(destination, source, length);
+    return destination;
+}
+
+void *memmove(void *destination, const void *source, uint64_t length) {
+    uint64_t dst = (uint64_t)destination;
+    uint64_t src = (uint64_t)source;
+
+    if (dst == src || length == 0)
+        return destination;
+    if (dst + length <= src || src + length <= dst)
+        return memcpy(destination, source, length);
+
+    // El loop SSE alinea con un store adelantado que pisaría el origen
+    if (dst < src)
+        mem_copy_words(destination, source, length);
+    else
+        mem_copy_words_backward(destination, source, length);
+    return destination;
+}
+
+void *memset(void *destination, int32_t c, uint64_t length) {
+    uint64_t pattern = (uint8_t)c * BYTE_PATTERN;
+
+    if (length >= STRING_SIMD_MIN_BYTES && simdEnabled)
+        mem_fill_sse(destination, pattern, length);
+    else
+        mem_fill_words(destination, pattern, length);
+    return destination;
+}
+
+int memcmp(const void *a, const void *b, uint64_t length) {
+    if (length >= STRING_SIMD_MIN_BYTES && simdEnabled)
+        return mem_cmp_sse(a, b, length);
+    return mem_cmp_words(a, b, length);
+}
+
+uint64_t strlen(const char *s) {
+    return str_len_words(s);
+}
+
+int strcmp(const char *a, const char *b) {
+    return str_cmp_words(a, b);
+}
+
+static int decimal_digits(uint64_t v) {
+    int n = 1;
+    while (v >= 10000) {
+        v /= 10000;
+        n += 4;
+    }
+    if (v >= 10) n++;
+    if (v >= 100) n++;
+    if (v >= 1000) n++;
+    return n;
+}
+
+int uint64_to_str(uint64_t v, char *buf) {
+    int len = decimal_digits(v);
+    char *p = buf + len;
+
+    *p = 0;
+    while (v >= 100) {
+        const char *pair = &digitPairs[(v % 100) * 2];
+        v /= 100;
+        *--p = pair[1];
+        *--p = pair[0];
+    }
+    if (v >= 10) {
+        *--p = digitPairs[v * 2 + 1];
+        *--p = digitPairs[v * 2];
+    } else {
+        *--p = '0' + v;
+    }
+    return len;
+}
+
+int int64_to_str(int64_t v, char *buf) {
+    if (v < 0) {
+        buf[0] = '-';
+        return 1 + uint64_to_str(0 - (uint64_t)v, buf + 1);
+    }
+    return uint64_to_str((uint64_t)v, buf);
+}
+
+int int_to_str(int v, char *buf) {
+    return int64_to_str(v, buf);
+}
+
+int uint64_to_hex(uint64_t v, char *buf, int digits) {
+    int len = 1;
+    while (len < 16 && (v >> (len * 4)) != 0)
+        len++;
+    if (digits > 16) digits = 16;
+    if (len < digits) len = digits;
+
+    buf[len] = 0;
+    for (int i = len - 1; i >= 0; i--) {
+        buf[i] = hexDigits[v & 0xF];
+        v >>= 4;
+    }
+    return len;
+}
@@ -0,0 +1,56 @@
+// string.h
+#ifndef STRING_H
+#define STRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Núcleo de libc de userland. Userland se compila con -O0 y sin SSE, así que
+// los loops están en string.asm: de a 8 bytes (con el destino alineado) y,
+// desde STRING_SIMD_MIN_BYTES, con SSE2. SSE2 es parte de x86-64 y el kernel
+// guarda el estado de forma perezosa (#NM), por eso no se usa en bloques
+// chicos: el primer uso después de un cambio de contexto cuesta un restore.
+// strlen/strcmp leen qwords alineados, que nunca cruzan a una página guarda.
+
+#define STRING_SIMD_MIN_BYTES 256
+
+void *memcpy(void *destination, const void *source, uint64_t length);
+void *memmove(void *destination, const void *source, uint64_t length);
+void *memset(void *destination, int32_t c, uint64_t length);
+int memcmp(const void *a, const void *b, uint64_t length);
+uint64_t strlen(const char *s);
+int strcmp(const char *a, const char *b);
+
+/**
+ * @brief Habilita o deshabilita los loops SSE (para compararlos en bench str)
+ * @return Estado anterior
+ */
+int string_set_simd(int enabled);
+
+/**
+ * @brief Decimal de dos dígitos por división, escrito de atrás hacia adelante
+ * @return Longitud escrita (sin el '\0')
+ */
+int uint64_to_str(uint64_t v, char *buf);
+int int64_to_str(int64_t v, char *buf);
+int int_to_str(int v, char *buf);
+
+/**
+ * @brief Hexadecimal en mayúsculas, sin prefijo
+ * @param digits Ancho mínimo con ceros a la izquierda (0 = sin relleno, máx. 16)
+ * @return Longitud escrita (sin el '\0')
+ */
+int uint64_to_hex(uint64_t v, char *buf, int digits);
+
+// Loops de string.asm
+void mem_copy_words(void *dst, const void *src, uint64_t length);
+void mem_copy_words_backward(void *dst, const void *src, uint64_t length);
+void mem_copy_sse(void *dst, const void *src, uint64_t length);
+void mem_fill_words(void *dst, uint64_t pattern, uint64_t length);
+void mem_fill_sse(void *dst, uint64_t pattern, uint64_t length);
+int mem_cmp_words(const void *a, const void *b, uint64_t length);
+int mem_cmp_sse(const void *a, const void *b, uint64_t length);
+uint64_t str_len_words(const char *s);
+int str_cmp_words(const char *a, const char *b);
+
+#endif // STRING_H
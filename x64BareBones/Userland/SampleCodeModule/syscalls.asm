@@ -15,6 +15,45 @@ global _sys_cycles_to_us
 global _sys_has_tsc
 global _sys_has_invariant_tsc
 global _sys_putChar
+global _sys_writev
+global _sys_read_timeout
+global _sys_kbd_last_tsc
+global _sys_get_key_events
+global _sys_get_key_state
+global _sys_kbd_ring
+global _sys_irq_mode
+global _sys_cpu_info
+global _sys_parallel_for
+global _sys_pool_stats
+global _sys_irq_stats
+global _sys_profile
+global _sys_profile_report
+global _sys_ipi_bench
+global _sys_tsc_sync
+global _sys_mem_info
+global _sys_slab_stats
+global _sys_slab_bench
+global _sys_sbrk
+global _sys_mmap
+global _sys_munmap
+global _sys_paging_info
+global _sys_paging_mode
+global _sys_mem_bench
+global _sys_demand_zero
+global _sys_task_create
+global _sys_task_exit
+global _sys_task_yield
+global _sys_task_sleep
+global _sys_task_kill
+global _sys_task_list
+global _sys_sched_quantum
+global _sys_task_self
+global _sys_task_affinity
+global _sys_sched_cpu_stats
+global _sys_task_realtime
+global _sys_task_frame
+global _sys_heap_lock
+global _sys_heap_unlock
 
 section .text
 
@@ -108,3 +147,237 @@ _sys_putChar:
     mov rax, 16
     int 0x80
     ret
+
+; uint64_t _sys_writev(const iovec_t *iov, int iovcnt)
+_sys_writev:
+    mov rax, 17
+    int 0x80
+    ret
+
+; ssize_t _sys_read_timeout(int fd, char *buf, int count, int64_t timeout_ms)
+_sys_read_timeout:
+    mov rax, 18
+    int 0x80
+    ret
+
+; uint64_t _sys_kbd_last_tsc()
+_sys_kbd_last_tsc:
+    mov rax, 19
+    int 0x80
+    ret
+
+; int _sys_get_key_events(key_event_t *events, int max)
+_sys_get_key_events:
+    mov rax, 20
+    int 0x80
+    ret
+
+; void _sys_get_key_state(uint64_t state[2])
+_sys_get_key_state:
+    mov rax, 21
+    int 0x80
+    ret
+
+; kbd_ring_t * _sys_kbd_ring()
+_sys_kbd_ring:
+    mov rax, 22
+    int 0x80
+    ret
+
+; int _sys_irq_mode(int mode)
+_sys_irq_mode:
+    mov rax, 23
+    int 0x80
+    ret
+
+; int _sys_cpu_info(cpu_info_t *info, int max)
+_sys_cpu_info:
+    mov rax, 24
+    int 0x80
+    ret
+
+; int _sys_parallel_for(uint64_t start, uint64_t end, uint64_t grain, range_fn fn, void *arg)
+_sys_parallel_for:
+    mov rax, 25
+    int 0x80
+    ret
+
+; int _sys_pool_stats(taskpool_stats_t *stats, int max)
+_sys_pool_stats:
+    mov rax, 26
+    int 0x80
+    ret
+
+; int _sys_irq_stats(irq_stat_t *stats, int max)
+_sys_irq_stats:
+    mov rax, 27
+    int 0x80
+    ret
+
+; uint64_t _sys_profile(int enable)
+_sys_profile:
+    mov rax, 28
+    int 0x80
+    ret
+
+; int _sys_profile_report(profile_entry_t *out, int max)
+_sys_profile_report:
+    mov rax, 29
+    int 0x80
+    ret
+
+; int _sys_ipi_bench(ipi_latency_t *out, int max, int iterations)
+_sys_ipi_bench:
+    mov rax, 30
+    int 0x80
+    ret
+
+; int _sys_tsc_sync(tsc_sync_t *out, int max)
+_sys_tsc_sync:
+    mov rax, 31
+    int 0x80
+    ret
+
+; int _sys_mem_info(page_stats_t *stats)
+_sys_mem_info:
+    mov rax, 32
+    int 0x80
+    ret
+
+; int _sys_slab_stats(kmem_stats_t *stats, int max)
+_sys_slab_stats:
+    mov rax, 33
+    int 0x80
+    ret
+
+; int _sys_slab_bench(kmem_bench_t *out, int iterations)
+_sys_slab_bench:
+    mov rax, 34
+    int 0x80
+    ret
+
+; uint64_t _sys_sbrk(int64_t increment)
+_sys_sbrk:
+    mov rax, 35
+    int 0x80
+    ret
+
+; void *_sys_mmap(uint64_t bytes)
+_sys_mmap:
+    mov rax, 36
+    int 0x80
+    ret
+
+; void _sys_munmap(void *addr, uint64_t bytes)
+_sys_munmap:
+    mov rax, 37
+    int 0x80
+    ret
+
+; void _sys_paging_info(paging_info_t *info)
+_sys_paging_info:
+    mov rax, 38
+    int 0x80
+    ret
+
+; int _sys_paging_mode(int mode)
+_sys_paging_mode:
+    mov rax, 39
+    int 0x80
+    ret
+
+; void _sys_mem_bench(mem_bench_t *out, void *buf, uint64_t bytes)
+_sys_mem_bench:
+    mov rax, 40
+    int 0x80
+    ret
+
+; int _sys_demand_zero(void *start, void *end)
+_sys_demand_zero:
+    mov rax, 41
+    int 0x80
+    ret
+
+; int _sys_task_create(task_entry_t entry, uint64_t arg, const char *name)
+_sys_task_create:
+    mov rax, 42
+    int 0x80
+    ret
+
+; void _sys_task_exit(void)
+_sys_task_exit:
+    mov rax, 43
+    int 0x80
+    ret
+
+; void _sys_task_yield(void)
+_sys_task_yield:
+    mov rax, 44
+    int 0x80
+    ret
+
+; void _sys_task_sleep(uint64_t ms)
+_sys_task_sleep:
+    mov rax, 45
+    int 0x80
+    ret
+
+; int _sys_task_kill(int id)
+_sys_task_kill:
+    mov rax, 46
+    int 0x80
+    ret
+
+; int _sys_task_list(task_info_t *out, int max)
+_sys_task_list:
+    mov rax, 47
+    int 0x80
+    ret
+
+; int _sys_sched_quantum(int ticks)
+_sys_sched_quantum:
+    mov rax, 48
+    int 0x80
+    ret
+
+; int _sys_task_self(void)
+_sys_task_self:
+    mov rax, 49
+    int 0x80
+    ret
+
+; int _sys_task_affinity(int id, uint32_t mask)
+_sys_task_affinity:
+    mov rax, 50
+    int 0x80
+    ret
+
+; int _sys_sched_cpu_stats(sched_cpu_stats_t *out, int max)
+_sys_sched_cpu_stats:
+    mov rax, 51
+    int 0x80
+    ret
+
+; int _sys_task_realtime(int id, int prio, uint32_t period_ms)
+_sys_task_realtime:
+    mov rax, 52
+    int 0x80
+    ret
+
+; int _sys_task_frame(int mode)
+_sys_task_frame:
+    mov rax, 53
+    int 0x80
+    ret
+
+; void _sys_heap_lock(void)
+_sys_heap_lock:
+    mov rax, 54
+    int 0x80
+    ret
+
+; void _sys_heap_unlock(void)
+_sys_heap_unlock:
+    mov rax, 55
+    int 0x80
+    ret
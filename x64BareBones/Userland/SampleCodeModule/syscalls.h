@@ -12,10 +12,340 @@ typedef struct {
     uint8_t year;
 } rtc_time_t;
 
+// Segmento (puntero, longitud) para _sys_writev
+typedef struct {
+    const char *base;
+    uint64_t len;
+} iovec_t;
+
+// Evento de teclado make/break con timestamp TSC del IRQ
+typedef struct {
+    uint8_t keycode;
+    uint8_t pressed;     // 1 = make, 0 = break
+    uint16_t reserved;
+    uint32_t reserved2;
+    uint64_t tsc;
+} key_event_t;
+
+// Ring de teclado compartida con el kernel (misma disposición que en el kernel).
+// head/tail son contadores libres: índice = x & (KBD_RING_SIZE - 1)
+#define KBD_RING_SIZE 256
+
+typedef struct {
+    uint32_t tail;                   // lo publica el IRQ de teclado (release)
+    uint32_t pad0[15];
+    uint32_t head;                   // lo avanzan los consumidores (CAS)
+    uint32_t pad1[15];
+    uint64_t overflows;              // veces que la ring se llenó
+    uint64_t dropped;                // teclas descartadas
+    uint64_t pad2[6];
+    char data[KBD_RING_SIZE];
+} kbd_ring_t;
+
+// Una entrada del listado de CPUs (misma disposición que cpu_info_t del kernel)
+typedef struct {
+    uint8_t index;          // 0 = BSP
+    uint8_t apic_id;
+    uint8_t online;
+    uint8_t is_bsp;
+    uint32_t reserved;
+    uint64_t work_done;     // trabajos ejecutados por ese CPU
+} cpu_info_t;
+
+// Cuerpo de un parallel_for: procesa [start, end). Corre también en los APs:
+// no puede hacer syscalls.
+typedef void (*range_fn)(uint64_t start, uint64_t end, void *arg);
+
+// Contadores del pool de tareas de un CPU
+typedef struct {
+    uint64_t executed;
+    uint64_t iterations;
+    uint64_t steals;
+    uint64_t failed_steals;
+} taskpool_stats_t;
+
+// Contadores de un vector de la IDT (misma disposición que en el kernel)
+#define IRQSTAT_BUCKETS 32
+
+typedef struct {
+    uint32_t vector;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t last_tsc;
+    uint64_t total_cycles;
+    uint64_t max_cycles;
+    uint32_t hist[IRQSTAT_BUCKETS];   // bucket k: [2^k, 2^(k+1)) ciclos
+} irq_stat_t;
+
+// Una función del reporte del profiler
+#define PROFILE_NAME_LEN 40
+
+typedef struct {
+    char name[PROFILE_NAME_LEN];
+    uint64_t addr;
+    uint32_t self;      // muestras con RIP dentro de la función
+    uint32_t total;     // muestras con la función en la pila
+} profile_entry_t;
+
+// Latencia de smp_call_function hacia un CPU (en ciclos)
+typedef struct {
+    uint32_t cpu;
+    uint32_t apic_id;
+    uint64_t min_cycles;
+    uint64_t avg_cycles;
+    uint64_t max_cycles;
+} ipi_latency_t;
+
+// Sincronización del TSC de un CPU contra el BSP (misma disposición que en el kernel)
+typedef struct {
+    uint32_t cpu;
+    uint32_t apic_id;
+    int64_t offset;             // ciclos: TSC del CPU - TSC del BSP
+    uint64_t rtt;               // mejor ida y vuelta del ping-pong (cota: +-rtt/2)
+    uint64_t warps_raw;         // lecturas que retrocedieron con rdtsc crudo
+    uint64_t warps_corrected;   // idem con el offset aplicado
+} tsc_sync_t;
+
+// Estado del allocator de páginas físicas (misma disposición que en el kernel)
+#define PAGE_ORDERS      10         // órdenes 0 (4 KiB) a 9 (2 MiB)
+#define PMM_MAX_RESERVED 16
+#define PMM_NAME_LEN     16
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    char name[PMM_NAME_LEN];
+} mem_region_t;
+
+typedef struct {
+    uint64_t usable_bytes;              // RAM que el E820 marca como usable
+    uint64_t total_pages;               // páginas administradas (libres + en uso)
+    uint64_t free_pages;
+    uint64_t reserved_pages;            // usables pero reservadas (kernel, módulos...)
+    uint64_t free_blocks[PAGE_ORDERS];  // bloques libres por orden
+    uint32_t largest_order;             // mayor orden con un bloque libre
+    uint32_t frag_2m_permille;          // páginas libres que no forman un bloque de 2 MiB
+    uint32_t e820_entries;
+    uint32_t reserved_count;
+    mem_region_t reserved[PMM_MAX_RESERVED];
+} page_stats_t;
+
+// Contadores de un caché de objetos del kernel (misma disposición que en el kernel)
+#define KMEM_MAX_CACHES 32
+#define KMEM_NAME_LEN   16
+
+typedef struct {
+    char name[KMEM_NAME_LEN];
+    uint32_t obj_size;
+    uint32_t objs_per_slab;
+    uint32_t slab_order;                // slab = 2^slab_order páginas
+    uint32_t slabs;
+    uint64_t active;                    // objetos entregados y no devueltos
+    uint64_t cached;                    // objetos en magazines
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t magazine_hits;             // alloc/free resueltos sin lock
+} kmem_stats_t;
+
+// Ciclos por par alloc/free
+typedef struct {
+    uint64_t magazine_pair;
+    uint64_t slab_pair;
+    uint64_t batch_pair;
+} kmem_bench_t;
+
+// Mapa de las tablas de páginas (misma disposición que en el kernel)
+#define PAGING_MAX_RUNS     24
+#define PAGING_MAX_LAZY     4
+#define PAGING_LAZY_NAME    16
+#define PAGE_KIND_4K        0
+#define PAGE_KIND_2M        1
+#define PAGE_KIND_1G        2
+#define PAGE_KINDS          3
+
+#define PAGE_CACHE_WB       0
+#define PAGE_CACHE_WC       1
+#define PAGE_CACHE_UC       2
+#define PAGE_CACHE_GUARD    3           // no presente
+
+#define PAGING_MODE_QUERY   -1
+#define PAGING_MODE_DEFAULT 0           // 1 GiB donde se pueda
+#define PAGING_MODE_2M      1           // sin páginas de 1 GiB
+#define PAGING_MODE_4K_HEAP 2           // el heap de userland con páginas de 4 KiB
+
+#define PAGING_FEATURE_1G   0x1
+#define PAGING_FEATURE_PAT  0x2
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint32_t kind;                      // PAGE_KIND_*
+    uint32_t cache;                     // PAGE_CACHE_*
+} page_run_t;
+
+// Región de demanda en cero: se pone en cero cada unidad al tocarla
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint64_t unit;                      // 4 KiB o 2 MiB
+    uint64_t touched;                   // unidades ya puestas en cero
+    uint64_t faults;                    // #PF resueltos en la región
+    char name[PAGING_LAZY_NAME];
+} lazy_region_info_t;
+
+typedef struct {
+    uint32_t features;
+    int32_t mode;
+    uint32_t table_pages;
+    uint32_t tlb_estimated;             // 1 = CPUID no informa la TLB, valores típicos
+    uint64_t pages[PAGE_KINDS];         // entradas hoja por tamaño
+    uint32_t l1_dtlb[PAGE_KINDS];
+    uint32_t l2_tlb[PAGE_KINDS];
+    uint32_t run_count;
+    uint32_t reserved;
+    page_run_t runs[PAGING_MAX_RUNS];
+    uint32_t lazy_count;
+    uint32_t reserved2;
+    lazy_region_info_t lazy[PAGING_MAX_LAZY];
+} paging_info_t;
+
+// Benchmark de memcpy/memset del kernel (misma disposición que en el kernel)
+#define MEM_FEATURE_ERMS  0x1
+#define MEM_FEATURE_FSRM  0x2
+
+#define MEM_IMPL_AUTO     0             // memcpy / memset con su elección
+#define MEM_IMPL_BYTES    1
+#define MEM_IMPL_WORDS    2
+#define MEM_IMPL_REP      3
+#define MEM_IMPL_SIMD     4
+#define MEM_IMPL_NT       5
+#define MEM_IMPLS         6
+#define MEM_BENCH_SIZES   12
+
+typedef struct {
+    uint64_t size;
+    uint64_t reps;
+    uint64_t copy[MEM_IMPLS];           // ciclos de reps copias (0 = no disponible)
+    uint64_t fill[MEM_IMPLS];
+} mem_bench_row_t;
+
+typedef struct {
+    uint32_t features;
+    uint32_t count;
+    uint64_t nt_threshold;              // desde acá memcpy/memset usan stores non-temporal
+    mem_bench_row_t rows[MEM_BENCH_SIZES];
+} mem_bench_t;
+
+// Tareas del scheduler (misma disposición que en el kernel)
+#define SCHED_NAME_LEN 16
+#define SCHED_MAX_TASKS 32
+
+#define TASK_FREE     0
+#define TASK_READY    1
+#define TASK_RUNNING  2
+#define TASK_SLEEPING 3
+#define TASK_BLOCKED  4
+#define TASK_DEAD     5
+
+// Cuerpo de una tarea; al volver, la tarea termina
+typedef void (*task_entry_t)(uint64_t arg);
+
+typedef struct {
+    uint32_t id;
+    uint8_t state;
+    uint8_t cpu;                        // CPU en el que corre o en cuya cola está
+    uint8_t prio;                       // 0 = normal, 1..TASK_RT_PRIO_MAX = tiempo real
+    uint8_t eff_prio;                   // con la que le presta quien espera su mutex
+    uint32_t affinity;                  // bit i = puede correr en el CPU i
+    uint32_t period_ms;                 // cuadro de taskFrame (0 = sin cuadros)
+    uint64_t switches;                  // veces que se le dio el CPU
+    uint64_t preemptions;               // veces que se la sacó sin que cediera
+    uint64_t migrations;                // veces que cambió de CPU
+    uint64_t cycles;                    // tiempo de CPU (TSC)
+    uint64_t frames;                    // cuadros terminados con taskFrame
+    uint64_t missed;                    // de esos, los que pasaron el deadline
+    char name[SCHED_NAME_LEN];
+} task_info_t;
+
+// Uso de cada CPU según el scheduler
+typedef struct {
+    uint32_t cpu;
+    uint32_t current;                   // id de la tarea que corre
+    uint32_t ready;                     // tareas en su cola
+    uint32_t reserved;
+    uint64_t busy_cycles;               // corriendo algo que no es su idle
+    uint64_t idle_cycles;
+    uint64_t switches;
+    uint64_t steals;                    // tareas que trajo de otras colas
+} sched_cpu_stats_t;
+
+// Ventana máxima del heap de userland (sbrk) y mayor bloque de mmap
+#define USER_HEAP_MAX  (64ULL << 20)
+#define USER_MMAP_MAX  (2ULL << 20)
+
 //agrego los numeros para que se cargue en los registros igual que lo recibe syscall dispatcher
 void _sys_write(uint64_t syscall_number, const char *str, int len);
+uint64_t _sys_writev(uint64_t syscall_number, const iovec_t *iov, int iovcnt);
 void _sys_clearScreen(uint64_t syscall_number);
 ssize_t _sys_read(uint64_t syscall_number, int fd, char *buf, int count);
+ssize_t _sys_read_timeout(uint64_t syscall_number, int fd, char *buf, int count, int64_t timeout_ms);
+uint64_t _sys_kbd_last_tsc(uint64_t syscall_number);
+int _sys_get_key_events(uint64_t syscall_number, key_event_t *events, int max);
+void _sys_get_key_state(uint64_t syscall_number, uint64_t *state);
+kbd_ring_t * _sys_kbd_ring(uint64_t syscall_number);
+
+// Interrupt controller
+int _sys_irq_mode(uint64_t syscall_number, int mode);
+
+// SMP
+int _sys_cpu_info(uint64_t syscall_number, cpu_info_t *info, int max);
+int _sys_parallel_for(uint64_t syscall_number, uint64_t start, uint64_t end, uint64_t grain, range_fn fn, void *arg);
+int _sys_pool_stats(uint64_t syscall_number, taskpool_stats_t *stats, int max);
+
+// Interrupt statistics
+int _sys_irq_stats(uint64_t syscall_number, irq_stat_t *stats, int max);
+
+// Profiler
+uint64_t _sys_profile(uint64_t syscall_number, int enable);
+int _sys_profile_report(uint64_t syscall_number, profile_entry_t *out, int max);
+
+// Cross-core calls
+int _sys_ipi_bench(uint64_t syscall_number, ipi_latency_t *out, int max, int iterations);
+
+// TSC sync
+int _sys_tsc_sync(uint64_t syscall_number, tsc_sync_t *out, int max);
+
+// Physical memory
+int _sys_mem_info(uint64_t syscall_number, page_stats_t *stats);
+int _sys_slab_stats(uint64_t syscall_number, kmem_stats_t *stats, int max);
+int _sys_slab_bench(uint64_t syscall_number, kmem_bench_t *out, int iterations);
+
+// User heap
+uint64_t _sys_sbrk(uint64_t syscall_number, int64_t increment);
+void * _sys_mmap(uint64_t syscall_number, uint64_t bytes);
+void _sys_munmap(uint64_t syscall_number, void *addr, uint64_t bytes);
+
+// Paging
+void _sys_paging_info(uint64_t syscall_number, paging_info_t *info);
+int _sys_paging_mode(uint64_t syscall_number, int mode);
+void _sys_mem_bench(uint64_t syscall_number, mem_bench_t *out, void *buf, uint64_t bytes);
+int _sys_demand_zero(uint64_t syscall_number, void *start, void *end);
+
+// Tasks
+int _sys_task_create(uint64_t syscall_number, task_entry_t entry, uint64_t arg, const char *name);
+void _sys_task_exit(uint64_t syscall_number);
+void _sys_task_yield(uint64_t syscall_number);
+void _sys_task_sleep(uint64_t syscall_number, uint64_t ms);
+int _sys_task_kill(uint64_t syscall_number, int id);
+int _sys_task_list(uint64_t syscall_number, task_info_t *out, int max);
+int _sys_sched_quantum(uint64_t syscall_number, int ticks);
+int _sys_task_self(uint64_t syscall_number);
+int _sys_task_affinity(uint64_t syscall_number, int id, uint32_t mask);
+int _sys_sched_cpu_stats(uint64_t syscall_number, sched_cpu_stats_t *out, int max);
+int _sys_task_realtime(uint64_t syscall_number, int id, int prio, uint32_t period_ms);
+int _sys_task_frame(uint64_t syscall_number, int mode);
+void _sys_heap_lock(uint64_t syscall_number);
+void _sys_heap_unlock(uint64_t syscall_number);
 void _sys_sleep(uint64_t syscall_number, uint64_t ticks);
 void _sys_drawRect(uint64_t syscall_number, uint32_t color, uint64_t x, uint64_t y, uint64_t width, uint64_t height);
 uint64_t _sys_get_ticks(uint64_t syscall_number);
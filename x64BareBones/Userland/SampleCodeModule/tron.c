@@ -4,6 +4,7 @@
 #include "shell.h"
 #include "lib.h"
 #include "tron.h"
+#include "malloc.h"
 
 // Syscalls
 #define SYS_WRITE 0
@@ -19,12 +20,11 @@
 #define SCREEN_HEIGHT 768
 
 // Game constants
-#define MAX_GRID_WIDTH 128
-#define MAX_GRID_HEIGHT 96
 #define DEFAULT_CELL_SIZE 8
 #define DEFAULT_SPEED 10
 #define DEFAULT_MAX_SCORE 10
 #define HUD_HEIGHT 30
+#define GAME_RT_PRIO 8          // real-time priority of the game loop
 
 // Colors
 #define COLOR_BLACK 0x000000
@@ -82,14 +82,17 @@ typedef struct {
     int score2;
     int state;
     int fps;               // current FPS
+    int missed;            // frames that overran their deadline (real time)
     uint64_t survival_start;  // Start time for survival timer (in cycles)
     Player p1;
     Player p2;
-    uint8_t grid[MAX_GRID_HEIGHT][MAX_GRID_WIDTH];
+    uint8_t *grid;         // grid_height filas de grid_width celdas (heap)
 } GameState;
 
 static GameState game;
 
+#define CELL(x, y) game.grid[(y) * game.grid_width + (x)]
+
 // Direction vectors
 static const int dx[] = {0, 1, 0, -1};
 static const int dy[] = {-1, 0, 1, 0};
@@ -134,29 +137,29 @@ static void init_grid() {
     // Clear grid
     for (int y = 0; y < game.grid_height; y++) {
         for (int x = 0; x < game.grid_width; x++) {
-            game.grid[y][x] = EMPTY;
+            CELL(x, y) = EMPTY;
         }
     }
     
     // Add border walls for both modes (visible boundaries)
     // Top border
     for (int x = 0; x < game.grid_width; x++) {
-        game.grid[0][x] = WALL;
+        CELL(x, 0) = WALL;
     }
     
     // Bottom border
     for (int x = 0; x < game.grid_width; x++) {
-        game.grid[game.grid_height - 1][x] = WALL;
+        CELL(x, game.grid_height - 1) = WALL;
     }
     
     // Left border
     for (int y = 0; y < game.grid_height; y++) {
-        game.grid[y][0] = WALL;
+        CELL(0, y) = WALL;
     }
     
     // Right border
     for (int y = 0; y < game.grid_height; y++) {
-        game.grid[y][game.grid_width - 1] = WALL;
+        CELL(game.grid_width - 1, y) = WALL;
     }
     
     // Add static obstacles to the map ONLY in solo mode
@@ -170,7 +173,7 @@ static void init_grid() {
         int obs1_h = game.grid_height / 8;
         for (int y = obs1_y; y < obs1_y + obs1_h && y < game.grid_height; y++) {
             for (int x = obs1_x; x < obs1_x + obs1_w && x < game.grid_width; x++) {
-                game.grid[y][x] = WALL;
+                CELL(x, y) = WALL;
             }
         }
         
@@ -181,7 +184,7 @@ static void init_grid() {
         int obs2_h = game.grid_height / 8;
         for (int y = obs2_y; y < obs2_y + obs2_h && y < game.grid_height; y++) {
             for (int x = obs2_x; x < obs2_x + obs2_w && x < game.grid_width; x++) {
-                game.grid[y][x] = WALL;
+                CELL(x, y) = WALL;
             }
         }
         
@@ -192,7 +195,7 @@ static void init_grid() {
         int obs3_h = game.grid_height / 8;
         for (int y = obs3_y; y < obs3_y + obs3_h && y < game.grid_height; y++) {
             for (int x = obs3_x; x < obs3_x + obs3_w && x < game.grid_width; x++) {
-                game.grid[y][x] = WALL;
+                CELL(x, y) = WALL;
             }
         }
         
@@ -203,7 +206,7 @@ static void init_grid() {
         int obs4_h = game.grid_height / 8;
         for (int y = obs4_y; y < obs4_y + obs4_h && y < game.grid_height; y++) {
             for (int x = obs4_x; x < obs4_x + obs4_w && x < game.grid_width; x++) {
-                game.grid[y][x] = WALL;
+                CELL(x, y) = WALL;
             }
         }
     }
@@ -215,12 +218,12 @@ static int check_collision(int x, int y) {
         return 1;
     }
     // Check if cell is occupied
-    return game.grid[y][x] != EMPTY;
+    return CELL(x, y) != EMPTY;
 }
 
 static void place_trail(int x, int y, int player) {
     if (x >= 0 && x < game.grid_width && y >= 0 && y < game.grid_height) {
-        game.grid[y][x] = (player == 1) ? P1_TRAIL : P2_TRAIL;
+        CELL(x, y) = (player == 1) ? P1_TRAIL : P2_TRAIL;
     }
 }
 
@@ -299,6 +302,12 @@ static void draw_hud() {
     buf[5 + len] = '\0';
     draw_text(buf, 360, 5, 0x00FF00);
     
+    // Missed frame deadlines
+    buf[0] = 'M'; buf[1] = 'i'; buf[2] = 's'; buf[3] = 's'; buf[4] = ':'; buf[5] = ' ';
+    len = int_to_str(game.missed, buf + 6);
+    buf[6 + len] = '\0';
+    draw_text(buf, 480, 5, game.missed ? 0xFF0000 : 0x00FF00);
+    
     // Draw turbo bars at FIXED positions
     int bar_width = 100;
     int bar_height = 6;
@@ -346,7 +355,7 @@ static void draw_game() {
     for (int y = 0; y < game.grid_height; y++) {
         for (int x = 0; x < game.grid_width; x++) {
             uint32_t color = COLOR_BLACK;
-            switch (game.grid[y][x]) {
+            switch (CELL(x, y)) {
                 case P1_TRAIL:
                     color = COLOR_PLAYER1;
                     break;
@@ -537,33 +546,48 @@ static void update_players() {
 }
 
 static void handle_input() {
+    // Direcciones y turbo: eventos make en orden, sin depender de la
+    // repeticion automatica, asi las teclas de ambos jugadores no se pisan
+    key_event_t events[16];
+    int n;
+    while ((n = getKeyEvents(events, 16)) > 0) {
+        for (int i = 0; i < n; i++) {
+            if (!events[i].pressed) continue;
+            switch (events[i].keycode) {
+                // Player 1 controls (WASD)
+                case KEY_W: game.p1.next_dir = DIR_UP; break;
+                case KEY_S: game.p1.next_dir = DIR_DOWN; break;
+                case KEY_A: game.p1.next_dir = DIR_LEFT; break;
+                case KEY_D: game.p1.next_dir = DIR_RIGHT; break;
+                
+                // Player 1 turbo (E)
+                case KEY_E:
+                    if (game.p1.turbo_charge > 0 && game.p1.turbo_cooldown == 0) {
+                        game.p1.turbo_active = 1;
+                        _sys_playBeep(SYS_PLAY_BEEP, 1000, 50);  // Turbo sound
+                    }
+                    break;
+                
+                // Player 2 controls (IJKL - same as pongis, o flechas)
+                case KEY_I: case KEY_UP:    game.p2.next_dir = DIR_UP; break;
+                case KEY_K: case KEY_DOWN:  game.p2.next_dir = DIR_DOWN; break;
+                case KEY_J: case KEY_LEFT:  game.p2.next_dir = DIR_LEFT; break;
+                case KEY_L: case KEY_RIGHT: game.p2.next_dir = DIR_RIGHT; break;
+                
+                // Player 2 turbo (O)
+                case KEY_O:
+                    if (game.p2.turbo_charge > 0 && game.p2.turbo_cooldown == 0) {
+                        game.p2.turbo_active = 1;
+                        _sys_playBeep(SYS_PLAY_BEEP, 1200, 50);  // Turbo sound
+                    }
+                    break;
+            }
+        }
+    }
+    
+    // Global controls (por caracteres)
     char c;
     while (read(&c, 1) > 0) {
-        // Player 1 controls (WASD)
-        if (c == 'w' || c == 'W') game.p1.next_dir = DIR_UP;
-        if (c == 's' || c == 'S') game.p1.next_dir = DIR_DOWN;
-        if (c == 'a' || c == 'A') game.p1.next_dir = DIR_LEFT;
-        if (c == 'd' || c == 'D') game.p1.next_dir = DIR_RIGHT;
-        
-        // Player 1 turbo (E)
-        if ((c == 'e' || c == 'E') && game.p1.turbo_charge > 0 && game.p1.turbo_cooldown == 0) {
-            game.p1.turbo_active = 1;
-            _sys_playBeep(SYS_PLAY_BEEP, 1000, 50);  // Turbo sound
-        }
-        
-        // Player 2 controls (IJKL - same as pongis)
-        if (c == 'i' || c == 'I') game.p2.next_dir = DIR_UP;
-        if (c == 'k' || c == 'K') game.p2.next_dir = DIR_DOWN;
-        if (c == 'j' || c == 'J') game.p2.next_dir = DIR_LEFT;
-        if (c == 'l' || c == 'L') game.p2.next_dir = DIR_RIGHT;
-        
-        // Player 2 turbo (O)
-        if ((c == 'o' || c == 'O') && game.p2.turbo_charge > 0 && game.p2.turbo_cooldown == 0) {
-            game.p2.turbo_active = 1;
-            _sys_playBeep(SYS_PLAY_BEEP, 1200, 50);  // Turbo sound
-        }
-        
-        // Global controls
         if (c == 'p' || c == 'P') {
             game.state = (game.state == STATE_PAUSED) ? STATE_PLAYING : STATE_PAUSED;
             if (game.state == STATE_PAUSED) {
@@ -619,7 +643,7 @@ static int ask_players() {
     print("Numero de jugadores (1/2): ");
     char c = 0;
     while (1) {
-        if (read(&c, 1) > 0) {
+        if (read_blocking(&c, 1) > 0) {
             if (c == '1') {
                 print("1\n");
                 return 1;
@@ -650,7 +674,7 @@ static int ask_number(const char *prompt, int default_value) {
     
     while (1) {
         char c = 0;
-        if (read(&c, 1) > 0) {
+        if (read_blocking(&c, 1) > 0) {
             if (c == '\n' || c == '\r' || c == ' ') {
                 // Enter or Space to confirm
                 if (pos > 0) {
@@ -695,6 +719,17 @@ static void game_loop() {
     uint64_t tick_duration_ms = 1000 / game.speed;
     uint64_t last_tick = bench_start();
     
+    // Real time: background tasks (bg mandelbrot, ...) can't delay a frame,
+    // and the kernel wakes us at each frame and counts the late ones.
+    // Falls back to polling the clock if it is not available.
+    int self = taskSelf();
+    int prev_prio = taskRealtime(self, GAME_RT_PRIO, (uint32_t)tick_duration_ms);
+    int paced = prev_prio >= 0;
+    game.missed = 0;
+    if (paced) {
+        taskFrame(FRAME_RESTART);
+    }
+    
     // FPS counter - sliding window of 60 frames
     #define FPS_WINDOW 60
     uint64_t frame_times[FPS_WINDOW];
@@ -711,6 +746,9 @@ static void game_loop() {
         
         if (game.state == STATE_PAUSED) {
             _sys_sleep(SYS_SLEEP, 2);
+            if (paced) {
+                taskFrame(FRAME_RESTART);   // the pause is not a late frame
+            }
             continue;
         }
         
@@ -737,6 +775,9 @@ static void game_loop() {
             draw_game();
             last_tick = bench_start();
             last_frame_time = bench_start();
+            if (paced) {
+                taskFrame(FRAME_RESTART);
+            }
             continue;
         }
         
@@ -745,7 +786,7 @@ static void game_loop() {
         uint64_t elapsed = bench_stop(last_tick);
         uint64_t elapsed_ms = cycles_to_ms(elapsed);
         
-        if (elapsed_ms >= tick_duration_ms) {
+        if (paced || elapsed_ms >= tick_duration_ms) {
             // Update game
             update_players();
             
@@ -770,11 +811,20 @@ static void game_loop() {
             draw_game();
             last_tick = current;
             last_frame_time = bench_start();
+            
+            // Sleep until the next frame; 1 = this one ended past its deadline
+            if (paced && taskFrame(FRAME_WAIT) > 0) {
+                game.missed++;
+            }
         } else {
             // Sleep for a short time
             _sys_sleep(SYS_SLEEP, 1);
         }
     }
+    
+    if (paced) {
+        taskRealtime(self, prev_prio, 0);
+    }
 }
 
 // ============================================================================
@@ -843,14 +893,18 @@ static void parse_args(const char *args) {
     // Calculate grid dimensions
     game.grid_width = SCREEN_WIDTH / game.cell_size;
     game.grid_height = (SCREEN_HEIGHT - HUD_HEIGHT) / game.cell_size;
-    
-    if (game.grid_width > MAX_GRID_WIDTH) game.grid_width = MAX_GRID_WIDTH;
-    if (game.grid_height > MAX_GRID_HEIGHT) game.grid_height = MAX_GRID_HEIGHT;
 }
 
 void tron_game(const char *args) {
     // Parse arguments (may override mode)
     parse_args(args);
+
+    // The arena covers the whole screen for any cell size
+    game.grid = malloc((uint64_t)game.grid_width * game.grid_height);
+    if (game.grid == 0) {
+        print("Not enough memory for the arena\n");
+        return;
+    }
     
     // Clear screen
     clearScreen();
@@ -925,13 +979,15 @@ void tron_game(const char *args) {
     // Wait for SPACE key specifically to avoid arrow key issues
     char c = 0;
     while (1) {
-        if (read(&c, 1) > 0 && c == ' ') {
+        if (read_blocking(&c, 1) > 0 && c == ' ') {
             break;
         }
     }
     
     // Clear any remaining input
     while (read(&c, 1) > 0) {}
+    key_event_t stale[16];
+    while (getKeyEvents(stale, 16) > 0) {}
     
     clearScreen();
     
@@ -941,9 +997,19 @@ void tron_game(const char *args) {
     
     // Start game loop
     game_loop();
+    free(game.grid);
+    game.grid = 0;
     
     // Return to shell
     clearScreen();
+    if (game.missed > 0) {
+        char buf[20];
+        int len = int_to_str(game.missed, buf);
+        buf[len] = '\0';
+        print("Frames fuera de tiempo: ");
+        print(buf);
+        print("\n");
+    }
     print("Gracias por jugar TRON!\n");
 }
 
@@ -14,7 +14,7 @@
  * 
  * Controls:
  *   Player 1: W/A/S/D (up/left/down/right), E (turbo)
- *   Player 2: I/J/K/L (up/left/down/right), O (turbo)
+ *   Player 2: I/J/K/L or arrow keys (up/left/down/right), O (turbo)
  *   P: Pause/Unpause
  *   R: Reset current round
  *   Q: Quit to shell